@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,9 +18,25 @@
 #include "benchmark_mode.h"
 
 #include "platform/platform.h"
+#include "vulkan_sample.h"
 
 namespace plugins
 {
+namespace
+{
+void log_cache_counters(const char *name, const vkb::CacheCounters &counters)
+{
+	LOGI("{} cache: {} hits, {} misses, {} evictions, {:.1f} ms spent creating, p50 < {:.3f} ms, p99 < {:.3f} ms",
+	     name,
+	     counters.hits,
+	     counters.misses,
+	     counters.evictions,
+	     counters.miss_time * 1e-6,
+	     counters.get_miss_time_percentile(50.0f) * 1e-6,
+	     counters.get_miss_time_percentile(99.0f) * 1e-6);
+}
+}        // namespace
+
 BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
                       "Log frame averages after running an app.",
@@ -57,5 +73,28 @@ void BenchmarkMode::on_app_start(const std::string &app_id)
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
 	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+
+	// Report runtime object creation, which causes hitches
+	auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+
+	if (vulkan_app && vulkan_app->has_device())
+	{
+		auto &state = vulkan_app->get_device().get_resource_cache().get_internal_state();
+
+		vkb::CacheCounters descriptor_sets = state.descriptor_sets.get_counters();
+
+		if (vulkan_app->has_render_context())
+		{
+			for (auto &frame : vulkan_app->get_render_context().get_render_frames())
+			{
+				descriptor_sets += frame->get_descriptor_set_counters();
+			}
+		}
+
+		log_cache_counters("Graphics pipeline", state.graphics_pipelines.get_counters());
+		log_cache_counters("Compute pipeline", state.compute_pipelines.get_counters());
+		log_cache_counters("Descriptor set", descriptor_sets);
+		log_cache_counters("Framebuffer", state.framebuffers.get_counters());
+	}
 }
 }        // namespace plugins
\ No newline at end of file
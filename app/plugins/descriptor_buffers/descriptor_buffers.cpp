@@ -0,0 +1,40 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "descriptor_buffers.h"
+
+#include "resource_cache.h"
+
+namespace plugins
+{
+DescriptorBuffers::DescriptorBuffers() :
+    DescriptorBuffersTags("Descriptor buffers",
+                          "Use descriptor buffers instead of descriptor sets in the samples which support it",
+                          {}, {&descriptor_buffers_flag})
+{
+}
+
+bool DescriptorBuffers::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&descriptor_buffers_flag);
+}
+
+void DescriptorBuffers::init(const vkb::CommandParser &parser)
+{
+	vkb::ResourceCache::descriptor_buffers_requested = true;
+}
+}        // namespace plugins
@@ -0,0 +1,51 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class DescriptorBuffers;
+
+// Passive behaviour
+using DescriptorBuffersTags = vkb::PluginBase<DescriptorBuffers, vkb::tags::Passive>;
+
+/**
+ * @brief Descriptor buffers
+ *
+ * Write descriptors to descriptor buffers (VK_EXT_descriptor_buffer) instead of descriptor sets
+ * in the samples which support it, see vkb::ResourceCache::set_descriptor_buffers
+ *
+ * Usage: vulkan_samples sample descriptor_management --descriptor-buffers
+ *
+ */
+class DescriptorBuffers : public DescriptorBuffersTags
+{
+  public:
+	DescriptorBuffers();
+
+	virtual ~DescriptorBuffers() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	vkb::FlagCommand descriptor_buffers_flag = {vkb::FlagType::FlagOnly, "descriptor-buffers", "", "Use descriptor buffers instead of descriptor sets in the samples which support it"};
+};
+}        // namespace plugins
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,8 @@
 
 #include "fps_logger.h"
 
+#include "vulkan_sample.h"
+
 namespace plugins
 {
 FpsLogger::FpsLogger() :
@@ -52,6 +54,23 @@ void FpsLogger::on_update(float delta_time)
 
 		LOGI("FPS: {:.1f}", fps);
 
+		// Pipelines created at runtime are a common cause of hitches
+		auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app());
+
+		if (vulkan_app && vulkan_app->has_device())
+		{
+			auto counters = vulkan_app->get_device().get_resource_cache().get_internal_state().graphics_pipelines.get_counters();
+
+			if (counters.misses > last_pipeline_counters.misses)
+			{
+				LOGI("Created {} graphics pipelines ({:.1f} ms)",
+				     counters.misses - last_pipeline_counters.misses,
+				     (counters.miss_time - last_pipeline_counters.miss_time) * 1e-6);
+			}
+
+			last_pipeline_counters = counters;
+		}
+
 		last_frame_count = frame_count;
 		timer.lap();
 	}
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "common/cache_counters.h"
 #include "platform/plugins/plugin_base.h"
 namespace plugins
 {
@@ -26,6 +27,7 @@ using FpsLoggerTags = vkb::PluginBase<vkb::tags::Passive>;
  * @brief FPS Logger
  * 
  * Control when FPS should be logged. Declutters the log output by removing FPS logs when not enabled
+ * The number of graphics pipelines created since the previous log is also reported, as they cause hitches
  * 
  * Usage: vulkan_sample sample afbc --log-fps
  * 
@@ -51,5 +53,7 @@ class FpsLogger : public FpsLoggerTags
 	size_t frame_count{0};
 
 	size_t last_frame_count{0};
+
+	vkb::CacheCounters last_pipeline_counters;
 };
 }        // namespace plugins
\ No newline at end of file
@@ -0,0 +1,131 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Planes of a view frustum, as (a, b, c, d) such that a * x + b * y + c * z + d >= 0 for the points inside
+ *        The normals (a, b, c) must be normalized, so that distances to the planes can be compared to radii.
+ */
+using FrustumPlanes = std::array<std::array<float, 4>, 6>;
+
+/**
+ * @brief Implementations of the frustum culling functions
+ */
+enum class CullingKernel
+{
+	Scalar,
+	SSE,         // 4 volumes at once
+	AVX2,        // 8 volumes at once, selected at runtime if the CPU supports it
+	NEON         // 4 volumes at once
+};
+
+/**
+ * @brief Bounding spheres stored as a structure of arrays, so that they can be culled in batches
+ */
+struct BoundingSpheres
+{
+	std::vector<float> center_x;
+	std::vector<float> center_y;
+	std::vector<float> center_z;
+	std::vector<float> radius;
+
+	size_t size() const;
+
+	void resize(size_t count);
+
+	void clear();
+
+	void set(size_t index, float x, float y, float z, float r);
+
+	void push_back(float x, float y, float z, float r);
+};
+
+/**
+ * @brief Axis aligned bounding boxes stored as a structure of arrays, so that they can be culled in batches
+ */
+struct BoundingBoxes
+{
+	std::vector<float> center_x;
+	std::vector<float> center_y;
+	std::vector<float> center_z;
+
+	/// Half sizes of the boxes
+	std::vector<float> extent_x;
+	std::vector<float> extent_y;
+	std::vector<float> extent_z;
+
+	size_t size() const;
+
+	void resize(size_t count);
+
+	void clear();
+
+	/**
+	 * @brief Stores a box from its minimum and maximum corners
+	 */
+	void set(size_t index, float min_x, float min_y, float min_z, float max_x, float max_y, float max_z);
+
+	/**
+	 * @brief Appends a box from its minimum and maximum corners
+	 */
+	void push_back(float min_x, float min_y, float min_z, float max_x, float max_y, float max_z);
+};
+
+/**
+ * @brief Returns the fastest culling kernel supported by the compiler and the CPU
+ */
+CullingKernel get_best_culling_kernel();
+
+bool is_culling_kernel_supported(CullingKernel kernel);
+
+const char *to_string(CullingKernel kernel);
+
+/**
+ * @brief Tests a range of bounding spheres against the planes of a frustum
+ *        Spheres intersecting the frustum are visible.
+ * @param planes The planes of the frustum
+ * @param spheres The spheres to test
+ * @param first The index of the first sphere of the range
+ * @param count The number of spheres of the range
+ * @param visibility Receives 1 for the visible spheres and 0 for the others, visibility[i] for the sphere first + i
+ * @param kernel The implementation to use, unsupported ones fall back to the scalar kernel
+ */
+void cull_spheres(const FrustumPlanes &planes, const BoundingSpheres &spheres, size_t first, size_t count, uint8_t *visibility,
+                  CullingKernel kernel = get_best_culling_kernel());
+
+/**
+ * @brief Tests a range of axis aligned bounding boxes against the planes of a frustum
+ *        Boxes intersecting the frustum are visible. Boxes near the corners of the frustum may be
+ *        reported visible even though they are outside, as they are tested against each plane separately.
+ * @param planes The planes of the frustum
+ * @param boxes The boxes to test
+ * @param first The index of the first box of the range
+ * @param count The number of boxes of the range
+ * @param visibility Receives 1 for the visible boxes and 0 for the others, visibility[i] for the box first + i
+ * @param kernel The implementation to use, unsupported ones fall back to the scalar kernel
+ */
+void cull_boxes(const FrustumPlanes &planes, const BoundingBoxes &boxes, size_t first, size_t count, uint8_t *visibility,
+                CullingKernel kernel = get_best_culling_kernel());
+}        // namespace vkb
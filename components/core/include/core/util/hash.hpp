@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, Thomas Atkinson
+/* Copyright (c) 2023-2024, Thomas Atkinson
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,7 +17,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace vkb
 {
@@ -38,4 +42,57 @@ inline void hash_combine(size_t &seed, const T &v)
 
 	hash_combine(seed, hasher(v));
 }
-}        // namespace vkb
\ No newline at end of file
+
+/**
+ * @brief Computes a 64-bit hash of a block of memory, using the XXH64 algorithm.
+ *        Unlike std::hash, the result only depends on the bytes hashed, so it is the same
+ *        across runs, compilers and (little endian) platforms, and can be stored on disk.
+ */
+uint64_t hash64(const void *data, size_t size, uint64_t seed = 0);
+
+/**
+ * @brief Accumulates data into a stable 64-bit hash
+ *        Feeding the same bytes in any number of calls gives the same result as a single call to hash64.
+ *        Structures passed to update() are hashed as raw bytes, so they must not contain padding or pointers.
+ */
+class StableHasher
+{
+  public:
+	explicit StableHasher(uint64_t seed = 0);
+
+	StableHasher &update(const void *data, size_t size);
+
+	template <class T>
+	StableHasher &update(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be hashed as bytes");
+
+		return update(&value, sizeof(T));
+	}
+
+	template <class T>
+	StableHasher &update(const std::vector<T> &values)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be hashed as bytes");
+
+		update(static_cast<uint64_t>(values.size()));
+
+		return update(values.data(), values.size() * sizeof(T));
+	}
+
+	StableHasher &update(const std::string &value);
+
+	uint64_t result() const;
+
+  private:
+	uint64_t seed;
+
+	uint64_t total_size{0};
+
+	uint64_t accumulators[4];
+
+	uint8_t buffer[32];
+
+	size_t buffer_size{0};
+};
+}        // namespace vkb
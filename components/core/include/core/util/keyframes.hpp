@@ -0,0 +1,72 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Finds the pair of keyframes surrounding a time
+ *        The keyframe found for the previous time is checked first along with the next one, which makes
+ *        forward playback amortized O(1). Other times, after a loop or a seek, fall back to a binary search.
+ * @param times The times of the keyframes, in increasing order
+ * @param count The number of keyframes
+ * @param time The time to look for
+ * @param keyframe Keyframe found for the previous time. On success, it is set to the index i such that
+ *        times[i] <= time <= times[i + 1]
+ * @return False if there are less than two keyframes or if the time is outside of them
+ */
+bool find_keyframe(const float *times, size_t count, float time, size_t &keyframe);
+
+/**
+ * @brief Keyframe times of several animation tracks, stored one after the other so that all the tracks
+ *        are searched in one pass over contiguous arrays
+ */
+struct KeyframeTracks
+{
+	/// Times of all the tracks, one track after the other
+	std::vector<float> times;
+
+	/// Track i has the times from offsets[i] to offsets[i + 1]
+	std::vector<size_t> offsets{0};
+
+	/// Keyframe of every track found by the last search, relative to the start of the track
+	std::vector<size_t> keyframes;
+
+	/// Position of the last time between the keyframe of every track and the next one, from 0 to 1,
+	/// or a negative value if the time was outside of the track
+	std::vector<float> factors;
+};
+
+/**
+ * @brief Adds a track to a set of tracks
+ * @param tracks The tracks to add to
+ * @param times The times of the keyframes of the track, in increasing order, which are copied
+ * @param count The number of keyframes
+ * @return The index of the new track
+ */
+size_t add_keyframe_track(KeyframeTracks &tracks, const float *times, size_t count);
+
+/**
+ * @brief Finds the keyframes of every track for the same time, see find_keyframe
+ *        The results are written to tracks.keyframes and tracks.factors.
+ */
+void find_keyframes(KeyframeTracks &tracks, float time);
+}        // namespace vkb
@@ -0,0 +1,87 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Push constant bytes recorded for the next draw call
+ *        The bytes are kept after being pushed, so that only the range which changed since the
+ *        last push has to be pushed again.
+ */
+class PushConstantState
+{
+  public:
+	PushConstantState() = default;
+
+	explicit PushConstantState(uint32_t max_size);
+
+	/**
+	 * @brief Records bytes after the ones recorded since the last draw call
+	 * @return False if the maximum size would be exceeded, in which case nothing is recorded
+	 */
+	bool record(const uint8_t *bytes, size_t count);
+
+	/**
+	 * @brief Forgets which bytes were pushed, so that all the recorded bytes are pushed again
+	 *        This is needed when the pushed values may have been disturbed, e.g. by another pipeline layout.
+	 */
+	void invalidate();
+
+	/**
+	 * @brief Gets the range of the recorded bytes which have to be pushed
+	 * @return False if there is nothing to push
+	 */
+	bool get_dirty_range(uint32_t &offset, uint32_t &range_size) const;
+
+	/**
+	 * @brief Ends the recording for a draw call, the next bytes are recorded from the start again
+	 * @param pushed Whether the dirty range was pushed
+	 */
+	void complete(bool pushed);
+
+	/**
+	 * @brief Throws away the bytes recorded for a draw call which was skipped
+	 */
+	void discard();
+
+	const uint8_t *get_data() const;
+
+	/// Amount of bytes recorded since the last draw call
+	uint32_t get_size() const;
+
+	/// Amount of bytes known to have been pushed, from the start
+	uint32_t get_pushed_size() const;
+
+  private:
+	// Allocated once with the maximum size
+	std::vector<uint8_t> data;
+
+	uint32_t size{0};
+
+	uint32_t pushed_size{0};
+
+	// Range of the recorded bytes which differ from the pushed ones
+	uint32_t dirty_begin{~0u};
+	uint32_t dirty_end{0};
+};
+}        // namespace vkb
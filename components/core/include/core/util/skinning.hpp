@@ -0,0 +1,83 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace vkb
+{
+/**
+ * @brief Matrix of a joint, column-major like glm::mat4
+ */
+using JointMatrix = std::array<float, 16>;
+
+/**
+ * @brief Implementations of the skinning functions
+ */
+enum class SkinningKernel
+{
+	Scalar,
+	SSE,         // Blends the joint matrices column by column
+	NEON         // Blends the joint matrices column by column
+};
+
+/**
+ * @brief Bind pose of skinned vertices, with 4 joint influences per vertex
+ *        The arrays are not owned, and vertex i is stored at positions[3 * i], joints[4 * i] and so on.
+ */
+struct SkinnedVertices
+{
+	/// Positions, 3 floats per vertex
+	const float *positions{nullptr};
+
+	/// Normals, 3 floats per vertex, or nullptr if the vertices have no normal
+	const float *normals{nullptr};
+
+	/// Indices of the joints influencing the vertices, 4 per vertex
+	const uint16_t *joints{nullptr};
+
+	/// Weights of the joints, 4 per vertex, which should add up to 1
+	const float *weights{nullptr};
+};
+
+/**
+ * @brief Returns the fastest skinning kernel supported by the compiler and the CPU
+ */
+SkinningKernel get_best_skinning_kernel();
+
+bool is_skinning_kernel_supported(SkinningKernel kernel);
+
+const char *to_string(SkinningKernel kernel);
+
+/**
+ * @brief Transforms a range of vertices by the weighted sum of the matrices of their joints
+ *        Normals are transformed by the same matrix and are not normalized.
+ * @param joint_matrices The matrices of the joints, indexed by the joints of the vertices
+ * @param joint_count The number of joint matrices, joints past the end are clamped to the last matrix
+ * @param vertices The vertices to skin
+ * @param first The index of the first vertex of the range
+ * @param count The number of vertices of the range
+ * @param out_positions Receives 3 floats per vertex, out_positions[3 * i] for the vertex first + i
+ * @param out_normals Receives 3 floats per vertex like out_positions, ignored if the vertices have no normal
+ * @param kernel The implementation to use, unsupported ones fall back to the scalar kernel
+ */
+void skin_vertices(const JointMatrix *joint_matrices, size_t joint_count, const SkinnedVertices &vertices, size_t first, size_t count,
+                   float *out_positions, float *out_normals, SkinningKernel kernel = get_best_skinning_kernel());
+}        // namespace vkb
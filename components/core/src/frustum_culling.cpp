@@ -0,0 +1,515 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/frustum_culling.hpp>
+
+#include <cmath>
+
+#include "frustum_culling_kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VKB_CULLING_SSE
+#	include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#	define VKB_CULLING_NEON
+#	include <arm_neon.h>
+#endif
+
+#if defined(VKB_CULLING_AVX2) && defined(_MSC_VER)
+#	include <immintrin.h>
+#	include <intrin.h>
+#endif
+
+namespace vkb
+{
+namespace
+{
+bool cpu_supports_avx2()
+{
+#if defined(VKB_CULLING_AVX2) && defined(_MSC_VER)
+	int info[4];
+
+	// The OS must save the AVX registers on context switches
+	__cpuidex(info, 1, 0);
+	bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+
+	__cpuidex(info, 7, 0);
+	return avx && (info[1] & (1 << 5));
+#elif defined(VKB_CULLING_AVX2)
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+void cull_spheres_scalar(const FrustumPlanes &planes, const BoundingSpheres &spheres, size_t first, size_t count, uint8_t *visibility)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t index   = first + i;
+		bool   visible = true;
+
+		for (auto &plane : planes)
+		{
+			// Same order of operations as the vector kernels, so that they all return the same results
+			float distance = (plane[0] * spheres.center_x[index] + plane[1] * spheres.center_y[index]) + (plane[2] * spheres.center_z[index] + plane[3]);
+
+			visible = visible && distance + spheres.radius[index] >= 0.0f;
+		}
+
+		visibility[i] = visible ? 1 : 0;
+	}
+}
+
+void cull_boxes_scalar(const FrustumPlanes &planes, const BoundingBoxes &boxes, size_t first, size_t count, uint8_t *visibility)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t index   = first + i;
+		bool   visible = true;
+
+		for (auto &plane : planes)
+		{
+			float distance = (plane[0] * boxes.center_x[index] + plane[1] * boxes.center_y[index]) + (plane[2] * boxes.center_z[index] + plane[3]);
+			float radius   = std::abs(plane[0]) * boxes.extent_x[index] + std::abs(plane[1]) * boxes.extent_y[index] + std::abs(plane[2]) * boxes.extent_z[index];
+
+			visible = visible && distance + radius >= 0.0f;
+		}
+
+		visibility[i] = visible ? 1 : 0;
+	}
+}
+
+#if defined(VKB_CULLING_AVX2)
+void get_plane_values(const FrustumPlanes &planes, float values[6][4])
+{
+	for (size_t p = 0; p < planes.size(); ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			values[p][c] = planes[p][c];
+		}
+	}
+}
+#endif
+
+#if defined(VKB_CULLING_SSE)
+void cull_spheres_sse(const FrustumPlanes &planes, const BoundingSpheres &spheres, size_t first, size_t count, uint8_t *visibility)
+{
+	__m128 plane_vectors[6][4];
+	for (size_t p = 0; p < planes.size(); ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			plane_vectors[p][c] = _mm_set1_ps(planes[p][c]);
+		}
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		size_t index = first + i;
+
+		__m128 x = _mm_loadu_ps(&spheres.center_x[index]);
+		__m128 y = _mm_loadu_ps(&spheres.center_y[index]);
+		__m128 z = _mm_loadu_ps(&spheres.center_z[index]);
+		__m128 r = _mm_loadu_ps(&spheres.radius[index]);
+
+		__m128 visible = _mm_cmpeq_ps(zero, zero);
+
+		for (auto &plane : plane_vectors)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], x), _mm_mul_ps(plane[1], y)),
+			                             _mm_add_ps(_mm_mul_ps(plane[2], z), plane[3]));
+
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+		}
+
+		int mask = _mm_movemask_ps(visible);
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			visibility[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+
+	cull_spheres_scalar(planes, spheres, first + i, count - i, visibility + i);
+}
+
+void cull_boxes_sse(const FrustumPlanes &planes, const BoundingBoxes &boxes, size_t first, size_t count, uint8_t *visibility)
+{
+	__m128 plane_vectors[6][4];
+	__m128 abs_normals[6][3];
+	for (size_t p = 0; p < planes.size(); ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			plane_vectors[p][c] = _mm_set1_ps(planes[p][c]);
+		}
+		for (size_t c = 0; c < 3; ++c)
+		{
+			abs_normals[p][c] = _mm_set1_ps(std::abs(planes[p][c]));
+		}
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		size_t index = first + i;
+
+		__m128 x  = _mm_loadu_ps(&boxes.center_x[index]);
+		__m128 y  = _mm_loadu_ps(&boxes.center_y[index]);
+		__m128 z  = _mm_loadu_ps(&boxes.center_z[index]);
+		__m128 ex = _mm_loadu_ps(&boxes.extent_x[index]);
+		__m128 ey = _mm_loadu_ps(&boxes.extent_y[index]);
+		__m128 ez = _mm_loadu_ps(&boxes.extent_z[index]);
+
+		__m128 visible = _mm_cmpeq_ps(zero, zero);
+
+		for (size_t p = 0; p < planes.size(); ++p)
+		{
+			auto &plane  = plane_vectors[p];
+			auto &normal = abs_normals[p];
+
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], x), _mm_mul_ps(plane[1], y)),
+			                             _mm_add_ps(_mm_mul_ps(plane[2], z), plane[3]));
+
+			// Projection of the box extent on the plane normal
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normal[0], ex), _mm_mul_ps(normal[1], ey)), _mm_mul_ps(normal[2], ez));
+
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		int mask = _mm_movemask_ps(visible);
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			visibility[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+
+	cull_boxes_scalar(planes, boxes, first + i, count - i, visibility + i);
+}
+#endif
+
+#if defined(VKB_CULLING_NEON)
+void cull_spheres_neon(const FrustumPlanes &planes, const BoundingSpheres &spheres, size_t first, size_t count, uint8_t *visibility)
+{
+	float32x4_t plane_vectors[6][4];
+	for (size_t p = 0; p < planes.size(); ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			plane_vectors[p][c] = vdupq_n_f32(planes[p][c]);
+		}
+	}
+
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		size_t index = first + i;
+
+		float32x4_t x = vld1q_f32(&spheres.center_x[index]);
+		float32x4_t y = vld1q_f32(&spheres.center_y[index]);
+		float32x4_t z = vld1q_f32(&spheres.center_z[index]);
+		float32x4_t r = vld1q_f32(&spheres.radius[index]);
+
+		uint32x4_t visible = vdupq_n_u32(~0u);
+
+		for (auto &plane : plane_vectors)
+		{
+			float32x4_t distance = vaddq_f32(vaddq_f32(vmulq_f32(plane[0], x), vmulq_f32(plane[1], y)),
+			                                 vaddq_f32(vmulq_f32(plane[2], z), plane[3]));
+
+			visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, r), zero));
+		}
+
+		visibility[i + 0] = static_cast<uint8_t>(vgetq_lane_u32(visible, 0) & 1);
+		visibility[i + 1] = static_cast<uint8_t>(vgetq_lane_u32(visible, 1) & 1);
+		visibility[i + 2] = static_cast<uint8_t>(vgetq_lane_u32(visible, 2) & 1);
+		visibility[i + 3] = static_cast<uint8_t>(vgetq_lane_u32(visible, 3) & 1);
+	}
+
+	cull_spheres_scalar(planes, spheres, first + i, count - i, visibility + i);
+}
+
+void cull_boxes_neon(const FrustumPlanes &planes, const BoundingBoxes &boxes, size_t first, size_t count, uint8_t *visibility)
+{
+	float32x4_t plane_vectors[6][4];
+	float32x4_t abs_normals[6][3];
+	for (size_t p = 0; p < planes.size(); ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			plane_vectors[p][c] = vdupq_n_f32(planes[p][c]);
+		}
+		for (size_t c = 0; c < 3; ++c)
+		{
+			abs_normals[p][c] = vdupq_n_f32(std::abs(planes[p][c]));
+		}
+	}
+
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		size_t index = first + i;
+
+		float32x4_t x  = vld1q_f32(&boxes.center_x[index]);
+		float32x4_t y  = vld1q_f32(&boxes.center_y[index]);
+		float32x4_t z  = vld1q_f32(&boxes.center_z[index]);
+		float32x4_t ex = vld1q_f32(&boxes.extent_x[index]);
+		float32x4_t ey = vld1q_f32(&boxes.extent_y[index]);
+		float32x4_t ez = vld1q_f32(&boxes.extent_z[index]);
+
+		uint32x4_t visible = vdupq_n_u32(~0u);
+
+		for (size_t p = 0; p < planes.size(); ++p)
+		{
+			auto &plane  = plane_vectors[p];
+			auto &normal = abs_normals[p];
+
+			float32x4_t distance = vaddq_f32(vaddq_f32(vmulq_f32(plane[0], x), vmulq_f32(plane[1], y)),
+			                                 vaddq_f32(vmulq_f32(plane[2], z), plane[3]));
+
+			// Projection of the box extent on the plane normal
+			float32x4_t radius = vaddq_f32(vaddq_f32(vmulq_f32(normal[0], ex), vmulq_f32(normal[1], ey)), vmulq_f32(normal[2], ez));
+
+			visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, radius), zero));
+		}
+
+		visibility[i + 0] = static_cast<uint8_t>(vgetq_lane_u32(visible, 0) & 1);
+		visibility[i + 1] = static_cast<uint8_t>(vgetq_lane_u32(visible, 1) & 1);
+		visibility[i + 2] = static_cast<uint8_t>(vgetq_lane_u32(visible, 2) & 1);
+		visibility[i + 3] = static_cast<uint8_t>(vgetq_lane_u32(visible, 3) & 1);
+	}
+
+	cull_boxes_scalar(planes, boxes, first + i, count - i, visibility + i);
+}
+#endif
+}        // namespace
+
+size_t BoundingSpheres::size() const
+{
+	return radius.size();
+}
+
+void BoundingSpheres::resize(size_t count)
+{
+	center_x.resize(count);
+	center_y.resize(count);
+	center_z.resize(count);
+	radius.resize(count);
+}
+
+void BoundingSpheres::clear()
+{
+	resize(0);
+}
+
+void BoundingSpheres::set(size_t index, float x, float y, float z, float r)
+{
+	center_x[index] = x;
+	center_y[index] = y;
+	center_z[index] = z;
+	radius[index]   = r;
+}
+
+void BoundingSpheres::push_back(float x, float y, float z, float r)
+{
+	resize(size() + 1);
+	set(size() - 1, x, y, z, r);
+}
+
+size_t BoundingBoxes::size() const
+{
+	return center_x.size();
+}
+
+void BoundingBoxes::resize(size_t count)
+{
+	center_x.resize(count);
+	center_y.resize(count);
+	center_z.resize(count);
+	extent_x.resize(count);
+	extent_y.resize(count);
+	extent_z.resize(count);
+}
+
+void BoundingBoxes::clear()
+{
+	resize(0);
+}
+
+void BoundingBoxes::set(size_t index, float min_x, float min_y, float min_z, float max_x, float max_y, float max_z)
+{
+	center_x[index] = (min_x + max_x) * 0.5f;
+	center_y[index] = (min_y + max_y) * 0.5f;
+	center_z[index] = (min_z + max_z) * 0.5f;
+	extent_x[index] = (max_x - min_x) * 0.5f;
+	extent_y[index] = (max_y - min_y) * 0.5f;
+	extent_z[index] = (max_z - min_z) * 0.5f;
+}
+
+void BoundingBoxes::push_back(float min_x, float min_y, float min_z, float max_x, float max_y, float max_z)
+{
+	resize(size() + 1);
+	set(size() - 1, min_x, min_y, min_z, max_x, max_y, max_z);
+}
+
+CullingKernel get_best_culling_kernel()
+{
+	static const CullingKernel best_kernel = []() {
+		for (auto kernel : {CullingKernel::AVX2, CullingKernel::SSE, CullingKernel::NEON})
+		{
+			if (is_culling_kernel_supported(kernel))
+			{
+				return kernel;
+			}
+		}
+		return CullingKernel::Scalar;
+	}();
+
+	return best_kernel;
+}
+
+bool is_culling_kernel_supported(CullingKernel kernel)
+{
+	switch (kernel)
+	{
+		case CullingKernel::Scalar:
+			return true;
+		case CullingKernel::SSE:
+#if defined(VKB_CULLING_SSE)
+			return true;
+#else
+			return false;
+#endif
+		case CullingKernel::AVX2:
+		{
+			static const bool supported = cpu_supports_avx2();
+			return supported;
+		}
+		case CullingKernel::NEON:
+#if defined(VKB_CULLING_NEON)
+			return true;
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+const char *to_string(CullingKernel kernel)
+{
+	switch (kernel)
+	{
+		case CullingKernel::Scalar:
+			return "Scalar";
+		case CullingKernel::SSE:
+			return "SSE";
+		case CullingKernel::AVX2:
+			return "AVX2";
+		case CullingKernel::NEON:
+			return "NEON";
+		default:
+			return "Unknown";
+	}
+}
+
+void cull_spheres(const FrustumPlanes &planes, const BoundingSpheres &spheres, size_t first, size_t count, uint8_t *visibility, CullingKernel kernel)
+{
+	if (!is_culling_kernel_supported(kernel))
+	{
+		kernel = CullingKernel::Scalar;
+	}
+
+	switch (kernel)
+	{
+#if defined(VKB_CULLING_AVX2)
+		case CullingKernel::AVX2:
+		{
+			float plane_values[6][4];
+			get_plane_values(planes, plane_values);
+
+			size_t culled = detail::cull_spheres_avx2(plane_values, spheres.center_x.data() + first, spheres.center_y.data() + first,
+			                                          spheres.center_z.data() + first, spheres.radius.data() + first, count, visibility);
+
+			cull_spheres_scalar(planes, spheres, first + culled, count - culled, visibility + culled);
+			break;
+		}
+#endif
+#if defined(VKB_CULLING_SSE)
+		case CullingKernel::SSE:
+			cull_spheres_sse(planes, spheres, first, count, visibility);
+			break;
+#endif
+#if defined(VKB_CULLING_NEON)
+		case CullingKernel::NEON:
+			cull_spheres_neon(planes, spheres, first, count, visibility);
+			break;
+#endif
+		default:
+			cull_spheres_scalar(planes, spheres, first, count, visibility);
+			break;
+	}
+}
+
+void cull_boxes(const FrustumPlanes &planes, const BoundingBoxes &boxes, size_t first, size_t count, uint8_t *visibility, CullingKernel kernel)
+{
+	if (!is_culling_kernel_supported(kernel))
+	{
+		kernel = CullingKernel::Scalar;
+	}
+
+	switch (kernel)
+	{
+#if defined(VKB_CULLING_AVX2)
+		case CullingKernel::AVX2:
+		{
+			float plane_values[6][4];
+			get_plane_values(planes, plane_values);
+
+			size_t culled = detail::cull_boxes_avx2(plane_values, boxes.center_x.data() + first, boxes.center_y.data() + first, boxes.center_z.data() + first,
+			                                        boxes.extent_x.data() + first, boxes.extent_y.data() + first, boxes.extent_z.data() + first, count, visibility);
+
+			cull_boxes_scalar(planes, boxes, first + culled, count - culled, visibility + culled);
+			break;
+		}
+#endif
+#if defined(VKB_CULLING_SSE)
+		case CullingKernel::SSE:
+			cull_boxes_sse(planes, boxes, first, count, visibility);
+			break;
+#endif
+#if defined(VKB_CULLING_NEON)
+		case CullingKernel::NEON:
+			cull_boxes_neon(planes, boxes, first, count, visibility);
+			break;
+#endif
+		default:
+			cull_boxes_scalar(planes, boxes, first, count, visibility);
+			break;
+	}
+}
+}        // namespace vkb
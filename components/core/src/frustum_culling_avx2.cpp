@@ -0,0 +1,130 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frustum_culling_kernels.hpp"
+
+#if defined(VKB_CULLING_AVX2)
+
+#	include <immintrin.h>
+
+namespace vkb
+{
+namespace detail
+{
+size_t cull_spheres_avx2(const float planes[6][4], const float *center_x, const float *center_y, const float *center_z, const float *radius,
+                         size_t count, uint8_t *visibility)
+{
+	__m256 plane_vectors[6][4];
+	for (size_t p = 0; p < 6; ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			plane_vectors[p][c] = _mm256_set1_ps(planes[p][c]);
+		}
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(center_x + i);
+		__m256 y = _mm256_loadu_ps(center_y + i);
+		__m256 z = _mm256_loadu_ps(center_z + i);
+		__m256 r = _mm256_loadu_ps(radius + i);
+
+		__m256 visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+
+		for (auto &plane : plane_vectors)
+		{
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane[0], x), _mm256_mul_ps(plane[1], y)),
+			                                _mm256_add_ps(_mm256_mul_ps(plane[2], z), plane[3]));
+
+			visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(visible);
+		for (size_t lane = 0; lane < 8; ++lane)
+		{
+			visibility[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+
+	return i;
+}
+
+size_t cull_boxes_avx2(const float planes[6][4], const float *center_x, const float *center_y, const float *center_z,
+                       const float *extent_x, const float *extent_y, const float *extent_z, size_t count, uint8_t *visibility)
+{
+	// Clearing the sign bit gives the absolute value
+	const __m256 sign_bit = _mm256_set1_ps(-0.0f);
+
+	__m256 plane_vectors[6][4];
+	__m256 abs_normals[6][3];
+	for (size_t p = 0; p < 6; ++p)
+	{
+		for (size_t c = 0; c < 4; ++c)
+		{
+			plane_vectors[p][c] = _mm256_set1_ps(planes[p][c]);
+		}
+		for (size_t c = 0; c < 3; ++c)
+		{
+			abs_normals[p][c] = _mm256_andnot_ps(sign_bit, plane_vectors[p][c]);
+		}
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x  = _mm256_loadu_ps(center_x + i);
+		__m256 y  = _mm256_loadu_ps(center_y + i);
+		__m256 z  = _mm256_loadu_ps(center_z + i);
+		__m256 ex = _mm256_loadu_ps(extent_x + i);
+		__m256 ey = _mm256_loadu_ps(extent_y + i);
+		__m256 ez = _mm256_loadu_ps(extent_z + i);
+
+		__m256 visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+
+		for (size_t p = 0; p < 6; ++p)
+		{
+			auto &plane  = plane_vectors[p];
+			auto &normal = abs_normals[p];
+
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane[0], x), _mm256_mul_ps(plane[1], y)),
+			                                _mm256_add_ps(_mm256_mul_ps(plane[2], z), plane[3]));
+
+			// Projection of the box extent on the plane normal
+			__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normal[0], ex), _mm256_mul_ps(normal[1], ey)), _mm256_mul_ps(normal[2], ez));
+
+			visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(visible);
+		for (size_t lane = 0; lane < 8; ++lane)
+		{
+			visibility[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+
+	return i;
+}
+}        // namespace detail
+}        // namespace vkb
+
+#endif
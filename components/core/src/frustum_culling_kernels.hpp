@@ -0,0 +1,50 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernels compiled in their own translation unit, with the instruction set enabled.
+// Their interface only uses plain arrays: inline functions of other headers, like the accessors of
+// std::vector or std::abs, would be compiled with the instruction set enabled there, and the linker
+// may keep that copy for the callers running on CPUs without it.
+
+namespace vkb
+{
+namespace detail
+{
+#if defined(VKB_CULLING_AVX2)
+/**
+ * @brief Culls spheres 8 at a time
+ * @param planes The planes of the frustum, as (a, b, c, d)
+ * @return The number of spheres culled, a multiple of 8, the remaining ones are left to the caller
+ */
+size_t cull_spheres_avx2(const float planes[6][4], const float *center_x, const float *center_y, const float *center_z, const float *radius,
+                         size_t count, uint8_t *visibility);
+
+/**
+ * @brief Culls boxes 8 at a time
+ * @param planes The planes of the frustum, as (a, b, c, d)
+ * @return The number of boxes culled, a multiple of 8, the remaining ones are left to the caller
+ */
+size_t cull_boxes_avx2(const float planes[6][4], const float *center_x, const float *center_y, const float *center_z,
+                       const float *extent_x, const float *extent_y, const float *extent_z, size_t count, uint8_t *visibility);
+#endif
+}        // namespace detail
+}        // namespace vkb
@@ -0,0 +1,193 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/hash.hpp>
+
+#include <cstring>
+
+namespace vkb
+{
+namespace
+{
+constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t prime_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t *data)
+{
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+inline uint32_t read32(const uint8_t *data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+inline uint64_t round(uint64_t accumulator, uint64_t input)
+{
+	accumulator += input * prime_2;
+	accumulator = rotl(accumulator, 31);
+	return accumulator * prime_1;
+}
+
+inline uint64_t merge_round(uint64_t hash, uint64_t accumulator)
+{
+	hash ^= round(0, accumulator);
+	return hash * prime_1 + prime_4;
+}
+
+// Processes as many 32 byte stripes as possible, returns the number of bytes consumed
+inline size_t process_stripes(uint64_t (&accumulators)[4], const uint8_t *data, size_t size)
+{
+	size_t offset = 0;
+
+	// The four lanes are independent, which lets the compiler vectorize this loop
+	for (; offset + 32 <= size; offset += 32)
+	{
+		accumulators[0] = round(accumulators[0], read64(data + offset));
+		accumulators[1] = round(accumulators[1], read64(data + offset + 8));
+		accumulators[2] = round(accumulators[2], read64(data + offset + 16));
+		accumulators[3] = round(accumulators[3], read64(data + offset + 24));
+	}
+
+	return offset;
+}
+
+inline uint64_t finalize(uint64_t hash, const uint8_t *data, size_t size)
+{
+	size_t offset = 0;
+
+	for (; offset + 8 <= size; offset += 8)
+	{
+		hash ^= round(0, read64(data + offset));
+		hash = rotl(hash, 27) * prime_1 + prime_4;
+	}
+
+	if (offset + 4 <= size)
+	{
+		hash ^= static_cast<uint64_t>(read32(data + offset)) * prime_1;
+		hash = rotl(hash, 23) * prime_2 + prime_3;
+		offset += 4;
+	}
+
+	for (; offset < size; ++offset)
+	{
+		hash ^= data[offset] * prime_5;
+		hash = rotl(hash, 11) * prime_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= prime_2;
+	hash ^= hash >> 29;
+	hash *= prime_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+}        // namespace
+
+uint64_t hash64(const void *data, size_t size, uint64_t seed)
+{
+	return StableHasher{seed}.update(data, size).result();
+}
+
+StableHasher::StableHasher(uint64_t seed) :
+    seed{seed},
+    accumulators{seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1}
+{
+}
+
+StableHasher &StableHasher::update(const void *data, size_t size)
+{
+	auto bytes = static_cast<const uint8_t *>(data);
+
+	total_size += size;
+
+	// Not enough data for a full stripe yet
+	if (buffer_size + size < 32)
+	{
+		if (size > 0)
+		{
+			std::memcpy(buffer + buffer_size, bytes, size);
+		}
+		buffer_size += size;
+		return *this;
+	}
+
+	// Complete the pending stripe first
+	if (buffer_size > 0)
+	{
+		size_t fill = 32 - buffer_size;
+		std::memcpy(buffer + buffer_size, bytes, fill);
+		process_stripes(accumulators, buffer, 32);
+
+		bytes += fill;
+		size -= fill;
+		buffer_size = 0;
+	}
+
+	size_t consumed = process_stripes(accumulators, bytes, size);
+
+	buffer_size = size - consumed;
+	if (buffer_size > 0)
+	{
+		std::memcpy(buffer, bytes + consumed, buffer_size);
+	}
+
+	return *this;
+}
+
+StableHasher &StableHasher::update(const std::string &value)
+{
+	update(static_cast<uint64_t>(value.size()));
+
+	return update(value.data(), value.size());
+}
+
+uint64_t StableHasher::result() const
+{
+	uint64_t hash;
+
+	if (total_size >= 32)
+	{
+		hash = rotl(accumulators[0], 1) + rotl(accumulators[1], 7) + rotl(accumulators[2], 12) + rotl(accumulators[3], 18);
+		hash = merge_round(hash, accumulators[0]);
+		hash = merge_round(hash, accumulators[1]);
+		hash = merge_round(hash, accumulators[2]);
+		hash = merge_round(hash, accumulators[3]);
+	}
+	else
+	{
+		hash = seed + prime_5;
+	}
+
+	hash += total_size;
+
+	return finalize(hash, buffer, buffer_size);
+}
+}        // namespace vkb
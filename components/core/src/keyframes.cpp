@@ -0,0 +1,78 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/keyframes.hpp>
+
+#include <algorithm>
+
+namespace vkb
+{
+bool find_keyframe(const float *times, size_t count, float time, size_t &keyframe)
+{
+	if (count < 2 || time < times[0] || time > times[count - 1])
+	{
+		return false;
+	}
+
+	// During playback, time moves forward by less than a keyframe per update most of the time
+	for (size_t i = keyframe; i < keyframe + 2 && i + 1 < count; ++i)
+	{
+		if (time >= times[i] && time <= times[i + 1])
+		{
+			keyframe = i;
+			return true;
+		}
+	}
+
+	// Otherwise the animation looped or skipped ahead, search all the keyframes
+	auto next = std::upper_bound(times + 1, times + count - 1, time);
+	keyframe  = static_cast<size_t>(next - times) - 1;
+
+	return true;
+}
+
+size_t add_keyframe_track(KeyframeTracks &tracks, const float *times, size_t count)
+{
+	tracks.times.insert(tracks.times.end(), times, times + count);
+	tracks.offsets.push_back(tracks.times.size());
+	tracks.keyframes.push_back(0);
+	tracks.factors.push_back(-1.0f);
+
+	return tracks.keyframes.size() - 1;
+}
+
+void find_keyframes(KeyframeTracks &tracks, float time)
+{
+	const size_t track_count = tracks.keyframes.size();
+
+	for (size_t i = 0; i < track_count; ++i)
+	{
+		const float *times    = tracks.times.data() + tracks.offsets[i];
+		size_t       count    = tracks.offsets[i + 1] - tracks.offsets[i];
+		size_t      &keyframe = tracks.keyframes[i];
+
+		if (!find_keyframe(times, count, time, keyframe))
+		{
+			tracks.factors[i] = -1.0f;
+			continue;
+		}
+
+		float span        = times[keyframe + 1] - times[keyframe];
+		tracks.factors[i] = span > 0.0f ? (time - times[keyframe]) / span : 0.0f;
+	}
+}
+}        // namespace vkb
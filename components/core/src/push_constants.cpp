@@ -0,0 +1,114 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/push_constants.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace vkb
+{
+PushConstantState::PushConstantState(uint32_t max_size) :
+    data(max_size)
+{
+}
+
+bool PushConstantState::record(const uint8_t *bytes, size_t count)
+{
+	size_t end = size + count;
+
+	if (end > data.size())
+	{
+		return false;
+	}
+
+	uint8_t *destination = data.data() + size;
+
+	// Bytes which were not pushed yet, or which changed, have to be pushed
+	if (end > pushed_size || std::memcmp(destination, bytes, count) != 0)
+	{
+		std::memcpy(destination, bytes, count);
+
+		dirty_begin = std::min(dirty_begin, size);
+		dirty_end   = static_cast<uint32_t>(end);
+	}
+
+	size = static_cast<uint32_t>(end);
+
+	return true;
+}
+
+void PushConstantState::invalidate()
+{
+	pushed_size = 0;
+	dirty_begin = 0;
+	dirty_end   = size;
+}
+
+bool PushConstantState::get_dirty_range(uint32_t &offset, uint32_t &range_size) const
+{
+	if (dirty_begin >= dirty_end)
+	{
+		return false;
+	}
+
+	offset     = dirty_begin;
+	range_size = dirty_end - dirty_begin;
+
+	return true;
+}
+
+void PushConstantState::complete(bool pushed)
+{
+	if (dirty_begin < dirty_end)
+	{
+		if (pushed)
+		{
+			pushed_size = std::max(pushed_size, dirty_end);
+		}
+		else
+		{
+			// The stored bytes of the range were overwritten without being pushed
+			pushed_size = std::min(pushed_size, dirty_begin);
+		}
+	}
+
+	size        = 0;
+	dirty_begin = ~0u;
+	dirty_end   = 0;
+}
+
+void PushConstantState::discard()
+{
+	complete(false);
+}
+
+const uint8_t *PushConstantState::get_data() const
+{
+	return data.data();
+}
+
+uint32_t PushConstantState::get_size() const
+{
+	return size;
+}
+
+uint32_t PushConstantState::get_pushed_size() const
+{
+	return pushed_size;
+}
+}        // namespace vkb
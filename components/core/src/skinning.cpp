@@ -0,0 +1,266 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/skinning.hpp>
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VKB_SKINNING_SSE
+#	include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#	define VKB_SKINNING_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace vkb
+{
+namespace
+{
+inline const float *get_joint_matrix(const JointMatrix *joint_matrices, size_t joint_count, uint16_t joint)
+{
+	return joint_matrices[std::min<size_t>(joint, joint_count - 1)].data();
+}
+
+// Used for the vertices left over by the vector kernels
+void skin_vertices_scalar(const JointMatrix *joint_matrices, size_t joint_count, const SkinnedVertices &vertices, size_t first, size_t count,
+                          float *out_positions, float *out_normals)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t index = first + i;
+
+		const uint16_t *joints  = &vertices.joints[4 * index];
+		const float    *weights = &vertices.weights[4 * index];
+
+		float matrix[16]{};
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			const float *joint_matrix = get_joint_matrix(joint_matrices, joint_count, joints[j]);
+
+			for (size_t k = 0; k < 16; ++k)
+			{
+				matrix[k] += weights[j] * joint_matrix[k];
+			}
+		}
+
+		const float *position = &vertices.positions[3 * index];
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			// Same order of operations as the vector kernels
+			out_positions[3 * i + k] = (matrix[k] * position[0] + matrix[4 + k] * position[1]) + (matrix[8 + k] * position[2] + matrix[12 + k]);
+		}
+
+		if (vertices.normals)
+		{
+			const float *normal = &vertices.normals[3 * index];
+
+			for (size_t k = 0; k < 3; ++k)
+			{
+				out_normals[3 * i + k] = (matrix[k] * normal[0] + matrix[4 + k] * normal[1]) + matrix[8 + k] * normal[2];
+			}
+		}
+	}
+}
+
+#if defined(VKB_SKINNING_SSE)
+void skin_vertices_sse(const JointMatrix *joint_matrices, size_t joint_count, const SkinnedVertices &vertices, size_t first, size_t count,
+                       float *out_positions, float *out_normals)
+{
+	// Results are stored 4 floats at a time, and the fourth one is overwritten by the next vertex.
+	// The last vertex is left to the scalar kernel, so that nothing is written past the end of the outputs.
+	size_t vector_count = count > 0 ? count - 1 : 0;
+
+	for (size_t i = 0; i < vector_count; ++i)
+	{
+		size_t index = first + i;
+
+		const uint16_t *joints  = &vertices.joints[4 * index];
+		const float    *weights = &vertices.weights[4 * index];
+
+		__m128 columns[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			const float *joint_matrix = get_joint_matrix(joint_matrices, joint_count, joints[j]);
+
+			__m128 weight = _mm_set1_ps(weights[j]);
+
+			for (size_t c = 0; c < 4; ++c)
+			{
+				columns[c] = _mm_add_ps(columns[c], _mm_mul_ps(weight, _mm_loadu_ps(joint_matrix + 4 * c)));
+			}
+		}
+
+		const float *position = &vertices.positions[3 * index];
+
+		__m128 x = _mm_mul_ps(columns[0], _mm_set1_ps(position[0]));
+		__m128 y = _mm_mul_ps(columns[1], _mm_set1_ps(position[1]));
+		__m128 z = _mm_mul_ps(columns[2], _mm_set1_ps(position[2]));
+
+		_mm_storeu_ps(&out_positions[3 * i], _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, columns[3])));
+
+		if (vertices.normals)
+		{
+			const float *normal = &vertices.normals[3 * index];
+
+			x = _mm_mul_ps(columns[0], _mm_set1_ps(normal[0]));
+			y = _mm_mul_ps(columns[1], _mm_set1_ps(normal[1]));
+			z = _mm_mul_ps(columns[2], _mm_set1_ps(normal[2]));
+
+			_mm_storeu_ps(&out_normals[3 * i], _mm_add_ps(_mm_add_ps(x, y), z));
+		}
+	}
+
+	skin_vertices_scalar(joint_matrices, joint_count, vertices, first + vector_count, count - vector_count,
+	                     out_positions + 3 * vector_count, out_normals ? out_normals + 3 * vector_count : nullptr);
+}
+#endif
+
+#if defined(VKB_SKINNING_NEON)
+void skin_vertices_neon(const JointMatrix *joint_matrices, size_t joint_count, const SkinnedVertices &vertices, size_t first, size_t count,
+                        float *out_positions, float *out_normals)
+{
+	// Results are stored 4 floats at a time, and the fourth one is overwritten by the next vertex.
+	// The last vertex is left to the scalar kernel, so that nothing is written past the end of the outputs.
+	size_t vector_count = count > 0 ? count - 1 : 0;
+
+	for (size_t i = 0; i < vector_count; ++i)
+	{
+		size_t index = first + i;
+
+		const uint16_t *joints  = &vertices.joints[4 * index];
+		const float    *weights = &vertices.weights[4 * index];
+
+		float32x4_t columns[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f)};
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			const float *joint_matrix = get_joint_matrix(joint_matrices, joint_count, joints[j]);
+
+			for (size_t c = 0; c < 4; ++c)
+			{
+				columns[c] = vmlaq_n_f32(columns[c], vld1q_f32(joint_matrix + 4 * c), weights[j]);
+			}
+		}
+
+		const float *position = &vertices.positions[3 * index];
+
+		float32x4_t result = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(columns[3], columns[0], position[0]), columns[1], position[1]), columns[2], position[2]);
+
+		vst1q_f32(&out_positions[3 * i], result);
+
+		if (vertices.normals)
+		{
+			const float *normal = &vertices.normals[3 * index];
+
+			result = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(columns[0], normal[0]), columns[1], normal[1]), columns[2], normal[2]);
+
+			vst1q_f32(&out_normals[3 * i], result);
+		}
+	}
+
+	skin_vertices_scalar(joint_matrices, joint_count, vertices, first + vector_count, count - vector_count,
+	                     out_positions + 3 * vector_count, out_normals ? out_normals + 3 * vector_count : nullptr);
+}
+#endif
+}        // namespace
+
+SkinningKernel get_best_skinning_kernel()
+{
+	for (auto kernel : {SkinningKernel::SSE, SkinningKernel::NEON})
+	{
+		if (is_skinning_kernel_supported(kernel))
+		{
+			return kernel;
+		}
+	}
+
+	return SkinningKernel::Scalar;
+}
+
+bool is_skinning_kernel_supported(SkinningKernel kernel)
+{
+	switch (kernel)
+	{
+		case SkinningKernel::Scalar:
+			return true;
+		case SkinningKernel::SSE:
+#if defined(VKB_SKINNING_SSE)
+			return true;
+#else
+			return false;
+#endif
+		case SkinningKernel::NEON:
+#if defined(VKB_SKINNING_NEON)
+			return true;
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+const char *to_string(SkinningKernel kernel)
+{
+	switch (kernel)
+	{
+		case SkinningKernel::Scalar:
+			return "Scalar";
+		case SkinningKernel::SSE:
+			return "SSE";
+		case SkinningKernel::NEON:
+			return "NEON";
+		default:
+			return "Unknown";
+	}
+}
+
+void skin_vertices(const JointMatrix *joint_matrices, size_t joint_count, const SkinnedVertices &vertices, size_t first, size_t count,
+                   float *out_positions, float *out_normals, SkinningKernel kernel)
+{
+	if (joint_count == 0 || count == 0)
+	{
+		return;
+	}
+
+	if (!is_skinning_kernel_supported(kernel))
+	{
+		kernel = SkinningKernel::Scalar;
+	}
+
+	switch (kernel)
+	{
+#if defined(VKB_SKINNING_SSE)
+		case SkinningKernel::SSE:
+			skin_vertices_sse(joint_matrices, joint_count, vertices, first, count, out_positions, out_normals);
+			break;
+#endif
+#if defined(VKB_SKINNING_NEON)
+		case SkinningKernel::NEON:
+			skin_vertices_neon(joint_matrices, joint_count, vertices, first, count, out_positions, out_normals);
+			break;
+#endif
+		default:
+			skin_vertices_scalar(joint_matrices, joint_count, vertices, first, count, out_positions, out_normals);
+			break;
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,276 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <core/util/frustum_culling.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace vkb;
+
+namespace
+{
+// Box of half size 10 around the origin
+FrustumPlanes get_box_planes()
+{
+	return {{{1, 0, 0, 10},
+	         {-1, 0, 0, 10},
+	         {0, 1, 0, 10},
+	         {0, -1, 0, 10},
+	         {0, 0, 1, 10},
+	         {0, 0, -1, 10}}};
+}
+
+// Symmetric perspective frustum looking down -z, with a 90 degree field of view
+FrustumPlanes get_perspective_planes()
+{
+	const float s = std::sqrt(0.5f);
+
+	return {{{s, 0, -s, 0},
+	         {-s, 0, -s, 0},
+	         {0, s, -s, 0},
+	         {0, -s, -s, 0},
+	         {0, 0, -1, -0.1f},
+	         {0, 0, 1, 1000}}};
+}
+
+std::vector<CullingKernel> get_supported_kernels()
+{
+	std::vector<CullingKernel> kernels;
+
+	for (auto kernel : {CullingKernel::Scalar, CullingKernel::SSE, CullingKernel::AVX2, CullingKernel::NEON})
+	{
+		if (is_culling_kernel_supported(kernel))
+		{
+			kernels.push_back(kernel);
+		}
+	}
+
+	return kernels;
+}
+
+BoundingSpheres get_random_spheres(size_t count)
+{
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> position{-200.0f, 200.0f};
+	std::uniform_real_distribution<float> radius{0.1f, 20.0f};
+
+	BoundingSpheres spheres;
+	spheres.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		spheres.set(i, position(generator), position(generator), position(generator), radius(generator));
+	}
+
+	return spheres;
+}
+
+BoundingBoxes get_random_boxes(size_t count)
+{
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> position{-200.0f, 200.0f};
+	std::uniform_real_distribution<float> size{0.1f, 20.0f};
+
+	BoundingBoxes boxes;
+	boxes.resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float x = position(generator);
+		float y = position(generator);
+		float z = position(generator);
+
+		boxes.set(i, x, y, z, x + size(generator), y + size(generator), z + size(generator));
+	}
+
+	return boxes;
+}
+
+// Volumes this close to a plane may be classified differently by kernels which round differently
+bool is_near_plane(const FrustumPlanes &planes, const BoundingSpheres &spheres, size_t index)
+{
+	for (auto &plane : planes)
+	{
+		float distance = plane[0] * spheres.center_x[index] + plane[1] * spheres.center_y[index] + plane[2] * spheres.center_z[index] + plane[3];
+
+		if (std::abs(distance + spheres.radius[index]) < 1e-3f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool is_near_plane(const FrustumPlanes &planes, const BoundingBoxes &boxes, size_t index)
+{
+	for (auto &plane : planes)
+	{
+		float distance = plane[0] * boxes.center_x[index] + plane[1] * boxes.center_y[index] + plane[2] * boxes.center_z[index] + plane[3];
+		float radius   = std::abs(plane[0]) * boxes.extent_x[index] + std::abs(plane[1]) * boxes.extent_y[index] + std::abs(plane[2]) * boxes.extent_z[index];
+
+		if (std::abs(distance + radius) < 1e-3f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+}        // namespace
+
+TEST_CASE("Spheres are culled against the frustum planes", "[culling]")
+{
+	auto planes = get_box_planes();
+
+	BoundingSpheres spheres;
+	spheres.resize(11);
+	spheres.set(0, 0, 0, 0, 1);             // Inside
+	spheres.set(1, 15, 0, 0, 1);            // Outside
+	spheres.set(2, 10.5f, 0, 0, 1);         // Intersecting
+	spheres.set(3, 0, -15, 0, 1);           // Outside
+	spheres.set(4, 0, 0, 11, 1);            // Touching
+	spheres.set(5, 0, 0, -50, 100);         // Containing the frustum
+	spheres.set(6, 0, 0, 12, 1);            // Outside
+	spheres.set(7, 5, 5, 5, 1);             // Inside
+	spheres.set(8, -20, 0, 0, 5);           // Outside
+	spheres.set(9, 9, 9, 9, 0);             // Inside
+	spheres.set(10, 0, 0, -10.5f, 1);        // Intersecting
+
+	const std::vector<uint8_t> expected{1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 1};
+
+	for (auto kernel : get_supported_kernels())
+	{
+		std::vector<uint8_t> visibility(spheres.size(), 2);
+
+		cull_spheres(planes, spheres, 0, spheres.size(), visibility.data(), kernel);
+
+		INFO("Kernel " << to_string(kernel));
+		REQUIRE(visibility == expected);
+
+		// A range writes the visibility of its first volume first
+		std::vector<uint8_t> range_visibility(5, 2);
+
+		cull_spheres(planes, spheres, 3, 5, range_visibility.data(), kernel);
+
+		REQUIRE(range_visibility == std::vector<uint8_t>(expected.begin() + 3, expected.begin() + 8));
+	}
+}
+
+TEST_CASE("Boxes are culled against the frustum planes", "[culling]")
+{
+	auto planes = get_box_planes();
+
+	BoundingBoxes boxes;
+	boxes.resize(9);
+	boxes.set(0, -1, -1, -1, 1, 1, 1);                  // Inside
+	boxes.set(1, 11, 0, 0, 12, 1, 1);                   // Outside
+	boxes.set(2, 9, 9, 9, 11, 11, 11);                  // Intersecting a corner
+	boxes.set(3, -100, -100, -100, 100, 100, 100);      // Containing the frustum
+	boxes.set(4, 0, -12, 0, 1, -11, 1);                 // Outside
+	boxes.set(5, 0, 0, 10, 1, 1, 11);                   // Touching
+	boxes.set(6, -20, -20, -20, -15, -15, -15);         // Outside
+	boxes.set(7, 2, 2, 2, 3, 3, 3);                     // Inside
+	boxes.set(8, 0, 0, -30, 1, 1, -10.5f);              // Outside
+
+	const std::vector<uint8_t> expected{1, 0, 1, 1, 0, 1, 0, 1, 0};
+
+	for (auto kernel : get_supported_kernels())
+	{
+		std::vector<uint8_t> visibility(boxes.size(), 2);
+
+		cull_boxes(planes, boxes, 0, boxes.size(), visibility.data(), kernel);
+
+		INFO("Kernel " << to_string(kernel));
+		REQUIRE(visibility == expected);
+	}
+}
+
+TEST_CASE("Culling kernels agree with the scalar kernel", "[culling]")
+{
+	auto planes  = get_perspective_planes();
+	auto spheres = get_random_spheres(1003);
+	auto boxes   = get_random_boxes(1003);
+
+	std::vector<uint8_t> expected_spheres(spheres.size());
+	std::vector<uint8_t> expected_boxes(boxes.size());
+
+	cull_spheres(planes, spheres, 0, spheres.size(), expected_spheres.data(), CullingKernel::Scalar);
+	cull_boxes(planes, boxes, 0, boxes.size(), expected_boxes.data(), CullingKernel::Scalar);
+
+	for (auto kernel : get_supported_kernels())
+	{
+		INFO("Kernel " << to_string(kernel));
+
+		std::vector<uint8_t> visibility(spheres.size());
+
+		// Odd ranges exercise the remainders of the vector kernels
+		cull_spheres(planes, spheres, 1, spheres.size() - 1, visibility.data() + 1, kernel);
+		cull_spheres(planes, spheres, 0, 1, visibility.data(), kernel);
+
+		for (size_t i = 0; i < spheres.size(); ++i)
+		{
+			if (!is_near_plane(planes, spheres, i))
+			{
+				REQUIRE(visibility[i] == expected_spheres[i]);
+			}
+		}
+
+		cull_boxes(planes, boxes, 0, boxes.size(), visibility.data(), kernel);
+
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			if (!is_near_plane(planes, boxes, i))
+			{
+				REQUIRE(visibility[i] == expected_boxes[i]);
+			}
+		}
+	}
+}
+
+TEST_CASE("Frustum culling kernels", "[culling][!benchmark]")
+{
+	auto planes  = get_perspective_planes();
+	auto spheres = get_random_spheres(100000);
+	auto boxes   = get_random_boxes(100000);
+
+	std::vector<uint8_t> visibility(spheres.size());
+
+	for (auto kernel : get_supported_kernels())
+	{
+		BENCHMARK(std::string{"100000 spheres, "} + to_string(kernel))
+		{
+			cull_spheres(planes, spheres, 0, spheres.size(), visibility.data(), kernel);
+			return visibility[0];
+		};
+
+		BENCHMARK(std::string{"100000 boxes, "} + to_string(kernel))
+		{
+			cull_boxes(planes, boxes, 0, boxes.size(), visibility.data(), kernel);
+			return visibility[0];
+		};
+	}
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2024, Thomas Atkinson
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <core/util/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+using namespace vkb;
+
+namespace
+{
+// Same layout as a block of pipeline state: only 32-bit members, no padding
+struct StateBlock
+{
+	uint32_t values[24];
+};
+}        // namespace
+
+TEST_CASE("vkb::hash64", "[common]")
+{
+	// Reference values of the XXH64 algorithm
+	REQUIRE(hash64("", 0) == 0xEF46DB3751D8E999ULL);
+	REQUIRE(hash64("a", 1) == 0xD24EC4F1A98C6E5BULL);
+	REQUIRE(hash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+	const char *text = "Nobody inspects the spammish repetition";
+	REQUIRE(hash64(text, std::strlen(text)) == 0xFBCEA83C8A378BF1ULL);
+
+	REQUIRE(hash64("abc", 3, 1) != hash64("abc", 3, 0));
+}
+
+TEST_CASE("vkb::StableHasher", "[common]")
+{
+	std::array<uint8_t, 1000> data;
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 31);
+	}
+
+	uint64_t expected = hash64(data.data(), data.size(), 7);
+
+	// Splitting the data in chunks must not change the result
+	for (size_t chunk_size : {1, 3, 31, 32, 33, 100})
+	{
+		StableHasher hasher{7};
+
+		for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+		{
+			hasher.update(data.data() + offset, std::min(chunk_size, data.size() - offset));
+		}
+
+		REQUIRE(hasher.result() == expected);
+	}
+
+	// Sizes are hashed with vectors and strings, so moving bytes between them changes the result
+	REQUIRE(StableHasher{}.update(std::string{"ab"}).update(std::string{"c"}).result() !=
+	        StableHasher{}.update(std::string{"a"}).update(std::string{"bc"}).result());
+}
+
+TEST_CASE("vkb::hash64 against vkb::hash_combine", "[common][!benchmark]")
+{
+	StateBlock block{};
+	for (uint32_t i = 0; i < 24; ++i)
+	{
+		block.values[i] = i * 0x01000193u;
+	}
+
+	BENCHMARK("hash_combine per member")
+	{
+		size_t result = 0;
+		for (uint32_t value : block.values)
+		{
+			hash_combine(result, value);
+		}
+		return result;
+	};
+
+	BENCHMARK("hash64 over the block")
+	{
+		return hash64(&block, sizeof(block));
+	};
+
+	BENCHMARK("StableHasher per member")
+	{
+		StableHasher hasher;
+		for (uint32_t value : block.values)
+		{
+			hasher.update(value);
+		}
+		return hasher.result();
+	};
+}
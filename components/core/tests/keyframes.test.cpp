@@ -0,0 +1,192 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <core/util/keyframes.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace vkb;
+
+namespace
+{
+std::vector<float> get_times(size_t count, float step)
+{
+	std::vector<float> times(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		times[i] = static_cast<float>(i) * step;
+	}
+	return times;
+}
+
+// What the animations used to do, scan the keyframes from the start
+bool find_keyframe_linear(const float *times, size_t count, float time, size_t &keyframe)
+{
+	for (size_t i = 0; i + 1 < count; ++i)
+	{
+		if (time >= times[i] && time <= times[i + 1])
+		{
+			keyframe = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+KeyframeTracks get_tracks(size_t track_count, size_t keyframe_count)
+{
+	KeyframeTracks tracks;
+	for (size_t i = 0; i < track_count; ++i)
+	{
+		// Tracks with different rates, so that they do not all change keyframe at the same time
+		auto times = get_times(keyframe_count, 0.01f * static_cast<float>(1 + i % 4));
+		add_keyframe_track(tracks, times.data(), times.size());
+	}
+	return tracks;
+}
+}        // namespace
+
+TEST_CASE("Keyframes outside of the track are not found", "[keyframes]")
+{
+	auto   times    = get_times(4, 1.0f);
+	size_t keyframe = 0;
+
+	REQUIRE_FALSE(find_keyframe(times.data(), times.size(), -0.5f, keyframe));
+	REQUIRE_FALSE(find_keyframe(times.data(), times.size(), 3.5f, keyframe));
+	REQUIRE_FALSE(find_keyframe(times.data(), 1, 0.0f, keyframe));
+}
+
+TEST_CASE("Keyframes are found from the cursor and after seeking", "[keyframes]")
+{
+	auto   times    = get_times(100, 0.5f);
+	size_t keyframe = 0;
+
+	// Forward playback
+	for (float time = 0.0f; time < 49.5f; time += 0.1f)
+	{
+		REQUIRE(find_keyframe(times.data(), times.size(), time, keyframe));
+		REQUIRE(times[keyframe] <= time);
+		REQUIRE(time <= times[keyframe + 1]);
+	}
+
+	// Looping back to the start and seeking in both directions
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> random_time{0.0f, 49.5f};
+
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		float time = random_time(generator);
+
+		REQUIRE(find_keyframe(times.data(), times.size(), time, keyframe));
+		REQUIRE(times[keyframe] <= time);
+		REQUIRE(time <= times[keyframe + 1]);
+	}
+
+	// The last keyframe is the end of the last interval
+	REQUIRE(find_keyframe(times.data(), times.size(), times.back(), keyframe));
+	REQUIRE(keyframe == times.size() - 2);
+}
+
+TEST_CASE("Keyframes of all the tracks are found together", "[keyframes]")
+{
+	KeyframeTracks tracks;
+
+	auto short_times = get_times(3, 1.0f);
+	auto long_times  = get_times(10, 1.0f);
+	auto single_time = get_times(1, 1.0f);
+
+	REQUIRE(add_keyframe_track(tracks, short_times.data(), short_times.size()) == 0);
+	REQUIRE(add_keyframe_track(tracks, long_times.data(), long_times.size()) == 1);
+	REQUIRE(add_keyframe_track(tracks, single_time.data(), single_time.size()) == 2);
+
+	find_keyframes(tracks, 1.25f);
+
+	REQUIRE(tracks.keyframes[0] == 1);
+	REQUIRE(tracks.factors[0] == 0.25f);
+	REQUIRE(tracks.keyframes[1] == 1);
+	REQUIRE(tracks.factors[1] == 0.25f);
+	REQUIRE(tracks.factors[2] < 0.0f);
+
+	find_keyframes(tracks, 5.5f);
+
+	REQUIRE(tracks.factors[0] < 0.0f);
+	REQUIRE(tracks.keyframes[1] == 5);
+	REQUIRE(tracks.factors[1] == 0.5f);
+}
+
+TEST_CASE("Keyframe search", "[keyframes][!benchmark]")
+{
+	const size_t track_count    = 300;
+	const size_t keyframe_count = 2000;
+
+	auto tracks = get_tracks(track_count, keyframe_count);
+
+	// 10 seconds of playback at 60 frames per second, which covers most keyframes of the shortest tracks
+	const size_t frame_count = 600;
+	const float  frame_time  = 1.0f / 60.0f;
+
+	BENCHMARK("300 tracks of 2000 keyframes, 600 frames, linear scan")
+	{
+		size_t total = 0;
+		for (size_t frame = 0; frame < frame_count; ++frame)
+		{
+			float time = static_cast<float>(frame) * frame_time;
+			for (size_t i = 0; i < track_count; ++i)
+			{
+				size_t keyframe = 0;
+				find_keyframe_linear(tracks.times.data() + tracks.offsets[i], tracks.offsets[i + 1] - tracks.offsets[i], time, keyframe);
+				total += keyframe;
+			}
+		}
+		return total;
+	};
+
+	BENCHMARK("300 tracks of 2000 keyframes, 600 frames, cursors")
+	{
+		for (size_t frame = 0; frame < frame_count; ++frame)
+		{
+			find_keyframes(tracks, static_cast<float>(frame) * frame_time);
+		}
+		return tracks.keyframes[0];
+	};
+
+	std::mt19937                          generator{42};
+	std::uniform_real_distribution<float> random_time{0.0f, 19.99f};
+
+	std::vector<float> seek_times(frame_count);
+	for (auto &time : seek_times)
+	{
+		time = random_time(generator);
+	}
+
+	BENCHMARK("300 tracks of 2000 keyframes, 600 seeks, binary search")
+	{
+		for (float time : seek_times)
+		{
+			find_keyframes(tracks, time);
+		}
+		return tracks.keyframes[0];
+	};
+}
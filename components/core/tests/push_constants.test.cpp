@@ -0,0 +1,121 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <core/util/push_constants.hpp>
+
+#include <cstring>
+
+using namespace vkb;
+
+namespace
+{
+template <typename T>
+bool record(PushConstantState &state, const T &value)
+{
+	return state.record(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
+}
+}        // namespace
+
+TEST_CASE("Only the push constants which changed are pushed again", "[push_constants]")
+{
+	PushConstantState state{128};
+
+	uint32_t offset = 0;
+	uint32_t size   = 0;
+
+	REQUIRE(record(state, 1.0f));
+	REQUIRE(record(state, 2.0f));
+	REQUIRE(state.get_dirty_range(offset, size));
+	REQUIRE(offset == 0);
+	REQUIRE(size == 8);
+	state.complete(true);
+
+	// Same values, nothing to push
+	REQUIRE(record(state, 1.0f));
+	REQUIRE(record(state, 2.0f));
+	REQUIRE_FALSE(state.get_dirty_range(offset, size));
+	state.complete(true);
+
+	// Only the second value changed
+	REQUIRE(record(state, 1.0f));
+	REQUIRE(record(state, 3.0f));
+	REQUIRE(state.get_dirty_range(offset, size));
+	REQUIRE(offset == 4);
+	REQUIRE(size == 4);
+	state.complete(true);
+
+	// Another pipeline layout, everything is pushed again
+	REQUIRE(record(state, 1.0f));
+	REQUIRE(record(state, 3.0f));
+	state.invalidate();
+	REQUIRE(state.get_dirty_range(offset, size));
+	REQUIRE(offset == 0);
+	REQUIRE(size == 8);
+
+	float values[2] = {};
+	std::memcpy(values, state.get_data(), sizeof(values));
+	REQUIRE(values[0] == 1.0f);
+	REQUIRE(values[1] == 3.0f);
+	state.complete(true);
+}
+
+TEST_CASE("Push constants of skipped draw calls are discarded", "[push_constants]")
+{
+	PushConstantState state{16};
+
+	uint32_t offset = 0;
+	uint32_t size   = 0;
+
+	REQUIRE(record(state, 1.0f));
+	state.complete(true);
+	REQUIRE(state.get_pushed_size() == 4);
+
+	// Several draw calls in a row are skipped while their pipeline is compiled, each recording
+	// as many bytes as the limit allows
+	for (int i = 0; i < 10; ++i)
+	{
+		float values[4] = {2.0f, 3.0f, 4.0f, static_cast<float>(i)};
+		REQUIRE(record(state, values));
+		REQUIRE(state.get_size() == 16);
+		state.discard();
+		REQUIRE(state.get_size() == 0);
+	}
+
+	// The discarded values overwrote the pushed one, so it has to be pushed again even if it is the same
+	REQUIRE(state.get_pushed_size() == 0);
+	REQUIRE(record(state, 1.0f));
+	REQUIRE(state.get_dirty_range(offset, size));
+	REQUIRE(offset == 0);
+	REQUIRE(size == 4);
+	state.complete(true);
+	REQUIRE(state.get_pushed_size() == 4);
+}
+
+TEST_CASE("Push constants over the limit are not recorded", "[push_constants]")
+{
+	PushConstantState state{8};
+
+	REQUIRE(record(state, 1.0));
+	REQUIRE_FALSE(record(state, 1.0f));
+	REQUIRE(state.get_size() == 8);
+}
@@ -0,0 +1,245 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <core/util/skinning.hpp>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vkb;
+
+namespace
+{
+JointMatrix get_translation(float x, float y, float z)
+{
+	return {1, 0, 0, 0,
+	        0, 1, 0, 0,
+	        0, 0, 1, 0,
+	        x, y, z, 1};
+}
+
+// Rotation of 90 degrees around the z axis
+JointMatrix get_rotation_z()
+{
+	return {0, 1, 0, 0,
+	        -1, 0, 0, 0,
+	        0, 0, 1, 0,
+	        0, 0, 0, 1};
+}
+
+std::vector<SkinningKernel> get_supported_kernels()
+{
+	std::vector<SkinningKernel> kernels;
+
+	for (auto kernel : {SkinningKernel::Scalar, SkinningKernel::SSE, SkinningKernel::NEON})
+	{
+		if (is_skinning_kernel_supported(kernel))
+		{
+			kernels.push_back(kernel);
+		}
+	}
+
+	return kernels;
+}
+
+struct RandomVertices
+{
+	std::vector<float>    positions;
+	std::vector<float>    normals;
+	std::vector<uint16_t> joints;
+	std::vector<float>    weights;
+
+	SkinnedVertices get() const
+	{
+		SkinnedVertices vertices;
+		vertices.positions = positions.data();
+		vertices.normals   = normals.data();
+		vertices.joints    = joints.data();
+		vertices.weights   = weights.data();
+		return vertices;
+	}
+};
+
+RandomVertices get_random_vertices(size_t count, uint16_t joint_count)
+{
+	std::mt19937                            generator{42};
+	std::uniform_real_distribution<float>   position{-2.0f, 2.0f};
+	std::uniform_real_distribution<float>   weight{0.0f, 1.0f};
+	std::uniform_int_distribution<uint16_t> joint{0, static_cast<uint16_t>(joint_count - 1)};
+
+	RandomVertices vertices;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float vertex_weights[4];
+		float total = 0.0f;
+
+		for (auto &vertex_weight : vertex_weights)
+		{
+			vertex_weight = weight(generator);
+			total += vertex_weight;
+		}
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			vertices.joints.push_back(joint(generator));
+			vertices.weights.push_back(vertex_weights[j] / total);
+		}
+
+		for (size_t k = 0; k < 3; ++k)
+		{
+			vertices.positions.push_back(position(generator));
+			vertices.normals.push_back(position(generator));
+		}
+	}
+
+	return vertices;
+}
+
+std::vector<JointMatrix> get_random_joint_matrices(size_t count)
+{
+	std::mt19937                          generator{7};
+	std::uniform_real_distribution<float> value{-1.0f, 1.0f};
+
+	std::vector<JointMatrix> matrices(count);
+
+	for (auto &matrix : matrices)
+	{
+		for (auto &element : matrix)
+		{
+			element = value(generator);
+		}
+
+		matrix[3]  = 0.0f;
+		matrix[7]  = 0.0f;
+		matrix[11] = 0.0f;
+		matrix[15] = 1.0f;
+	}
+
+	return matrices;
+}
+
+bool is_close(const std::vector<float> &a, const std::vector<float> &b)
+{
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (std::abs(a[i] - b[i]) > 1e-4f)
+		{
+			return false;
+		}
+	}
+
+	return a.size() == b.size();
+}
+}        // namespace
+
+TEST_CASE("Vertices are transformed by the blend of their joint matrices", "[skinning]")
+{
+	const std::vector<JointMatrix> joint_matrices{get_translation(1, 2, 3), get_rotation_z(), get_translation(-4, 0, 0)};
+
+	const std::vector<float>    positions{1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 0};
+	const std::vector<float>    normals{0, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1};
+	const std::vector<uint16_t> joints{0, 0, 0, 0, 1, 0, 0, 0, 0, 2, 1, 1, 7, 0, 0, 0};
+	const std::vector<float>    weights{1, 0, 0, 0, 1, 0, 0, 0, 0.5f, 0.5f, 0, 0, 1, 0, 0, 0};
+
+	// The last vertex refers to a joint past the end, which is clamped to the last joint
+	const std::vector<float> expected_positions{2, 2, 3, 0, 1, 0, -0.5f, 1, 1.5f, -4, 1, 0};
+	const std::vector<float> expected_normals{0, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 1};
+
+	SkinnedVertices vertices;
+	vertices.positions = positions.data();
+	vertices.normals   = normals.data();
+	vertices.joints    = joints.data();
+	vertices.weights   = weights.data();
+
+	for (auto kernel : get_supported_kernels())
+	{
+		INFO("Kernel " << to_string(kernel));
+
+		std::vector<float> out_positions(positions.size(), 100.0f);
+		std::vector<float> out_normals(normals.size(), 100.0f);
+
+		skin_vertices(joint_matrices.data(), joint_matrices.size(), vertices, 0, 4, out_positions.data(), out_normals.data(), kernel);
+
+		REQUIRE(is_close(out_positions, expected_positions));
+		REQUIRE(is_close(out_normals, expected_normals));
+
+		// A range writes the first vertex of the range first, and nothing past its end
+		std::vector<float> range_positions(9, 100.0f);
+
+		vertices.normals = nullptr;
+		skin_vertices(joint_matrices.data(), joint_matrices.size(), vertices, 1, 2, range_positions.data(), nullptr, kernel);
+		vertices.normals = normals.data();
+
+		REQUIRE(is_close(range_positions, {0, 1, 0, -0.5f, 1, 1.5f, 100, 100, 100}));
+	}
+}
+
+TEST_CASE("Skinning kernels agree with the scalar kernel", "[skinning]")
+{
+	auto joint_matrices = get_random_joint_matrices(64);
+	auto random         = get_random_vertices(1003, 64);
+	auto vertices       = random.get();
+
+	std::vector<float> expected_positions(random.positions.size());
+	std::vector<float> expected_normals(random.normals.size());
+
+	skin_vertices(joint_matrices.data(), joint_matrices.size(), vertices, 0, 1003, expected_positions.data(), expected_normals.data(), SkinningKernel::Scalar);
+
+	for (auto kernel : get_supported_kernels())
+	{
+		INFO("Kernel " << to_string(kernel));
+
+		std::vector<float> out_positions(random.positions.size());
+		std::vector<float> out_normals(random.normals.size());
+
+		// Odd ranges exercise the remainders of the vector kernels
+		skin_vertices(joint_matrices.data(), joint_matrices.size(), vertices, 1, 1002, out_positions.data() + 3, out_normals.data() + 3, kernel);
+		skin_vertices(joint_matrices.data(), joint_matrices.size(), vertices, 0, 1, out_positions.data(), out_normals.data(), kernel);
+
+		REQUIRE(is_close(out_positions, expected_positions));
+		REQUIRE(is_close(out_normals, expected_normals));
+	}
+}
+
+TEST_CASE("Skinning kernels", "[skinning][!benchmark]")
+{
+	auto joint_matrices = get_random_joint_matrices(64);
+	auto random         = get_random_vertices(100000, 64);
+	auto vertices       = random.get();
+
+	std::vector<float> out_positions(random.positions.size());
+	std::vector<float> out_normals(random.normals.size());
+
+	for (auto kernel : get_supported_kernels())
+	{
+		BENCHMARK(std::string{"100000 vertices, "} + to_string(kernel))
+		{
+			skin_vertices(joint_matrices.data(), joint_matrices.size(), vertices, 0, 100000, out_positions.data(), out_normals.data(), kernel);
+			return out_positions[0];
+		};
+	}
+}
@@ -24,31 +24,49 @@
 
 namespace vkb
 {
-BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
-    buffer{device, size, usage, memory_usage}
+namespace
+{
+/**
+ * @brief Returns the alignment of the allocations made from a buffer, according to its usage
+ */
+VkDeviceSize get_allocation_alignment(Device &device, VkBufferUsageFlags usage)
 {
+	// Device addresses do not change the alignment of the allocations
+	usage &= ~VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
 	if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
+	}
+	else if (usage & (VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT))
+	{
+		return device.get_resource_cache().get_descriptor_buffer_properties().descriptorBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_INDEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_VERTEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
 	{
 		// Used to calculate the offset, required when allocating memory (its value should be power of 2)
-		alignment = 16;
+		return 16;
 	}
 	else
 	{
 		throw std::runtime_error("Usage not recognised");
 	}
 }
+}        // namespace
+
+BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    buffer{device, size, usage, memory_usage},
+    alignment{get_allocation_alignment(device, usage)}
+{
+}
 
 VkDeviceSize BufferBlock::aligned_offset() const
 {
@@ -131,13 +149,13 @@ BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDe
 {
 }
 
-void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+void BufferAllocation::update(const uint8_t *data, size_t data_size, uint32_t offset)
 {
 	assert(buffer && "Invalid buffer pointer");
 
-	if (offset + data.size() <= size)
+	if (offset + data_size <= size)
 	{
-		buffer->update(data, to_u32(base_offset) + offset);
+		buffer->update(data, data_size, to_u32(base_offset) + offset);
 	}
 	else
 	{
@@ -145,6 +163,33 @@ void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
 	}
 }
 
+void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+{
+	update(data.data(), data.size(), offset);
+}
+
+uint8_t *BufferAllocation::map(size_t data_size, uint32_t offset)
+{
+	if (empty())
+	{
+		throw std::runtime_error("Cannot map an empty buffer allocation");
+	}
+
+	if (offset + data_size > size)
+	{
+		throw std::runtime_error(fmt::format("Cannot map {} bytes at offset {} of a buffer allocation of {} bytes", data_size, offset, size));
+	}
+
+	return buffer->map() + base_offset + offset;
+}
+
+void BufferAllocation::flush()
+{
+	assert(buffer && "Invalid buffer pointer");
+
+	buffer->flush(base_offset, size);
+}
+
 bool BufferAllocation::empty() const
 {
 	return size == 0 || buffer == nullptr;
@@ -166,4 +211,112 @@ core::Buffer &BufferAllocation::get_buffer()
 	return *buffer;
 }
 
+BufferRing::BufferRing(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    device{device},
+    usage{usage},
+    memory_usage{memory_usage},
+    buffer{std::make_unique<core::Buffer>(device, size, usage, memory_usage)},
+    alignment{get_allocation_alignment(device, usage)}
+{
+}
+
+void BufferRing::begin_frame(uint64_t frame)
+{
+	assert(frame > current_frame && "Frame indices must increase");
+
+	current_frame = frame;
+	frame_starts.emplace_back(frame, head);
+}
+
+void BufferRing::release_frame(uint64_t frame)
+{
+	while (!frame_starts.empty() && frame_starts.front().first <= frame)
+	{
+		frame_starts.pop_front();
+	}
+
+	while (!retired_buffers.empty() && retired_buffers.front().first <= frame)
+	{
+		retired_buffers.pop_front();
+	}
+}
+
+bool BufferRing::find_offset(VkDeviceSize size, VkDeviceSize &offset) const
+{
+	// Start of the oldest allocation still in use, if there is none the whole ring is free
+	VkDeviceSize tail    = frame_starts.empty() ? head : frame_starts.front().second;
+	VkDeviceSize aligned = (head + alignment - 1) & ~(alignment - 1);
+
+	// The head never catches up with the tail, so that they are only equal when the ring is empty
+	if (head >= tail)
+	{
+		// Free space is at the end of the buffer, then before the tail once wrapped
+		if (aligned + size <= buffer->get_size())
+		{
+			offset = aligned;
+			return true;
+		}
+
+		if (size < tail)
+		{
+			offset = 0;
+			return true;
+		}
+
+		return false;
+	}
+
+	// Free space is between the head and the tail
+	if (aligned + size < tail)
+	{
+		offset = aligned;
+		return true;
+	}
+
+	return false;
+}
+
+void BufferRing::grow(VkDeviceSize size)
+{
+	VkDeviceSize new_size = buffer->get_size() * 2;
+
+	while (new_size < size)
+	{
+		new_size *= 2;
+	}
+
+	LOGD("Growing buffer ring ({}) to {} bytes", usage, new_size);
+
+	// Allocations of the frames in flight still point to the previous buffer
+	retired_buffers.emplace_back(current_frame, std::move(buffer));
+
+	buffer = std::make_unique<core::Buffer>(device, new_size, usage, memory_usage);
+	head   = 0;
+
+	frame_starts.clear();
+	frame_starts.emplace_back(current_frame, head);
+}
+
+BufferAllocation BufferRing::allocate(VkDeviceSize size)
+{
+	assert(size > 0 && "Allocation size must be greater than zero");
+
+	VkDeviceSize offset = 0;
+
+	if (!find_offset(size, offset))
+	{
+		grow(size);
+		offset = 0;
+	}
+
+	head = offset + size;
+
+	return BufferAllocation{*buffer, size, offset};
+}
+
+VkDeviceSize BufferRing::get_size() const
+{
+	return buffer->get_size();
+}
+
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "common/helpers.h"
 #include "core/buffer.h"
 
@@ -43,14 +46,52 @@ class BufferAllocation
 
 	BufferAllocation &operator=(BufferAllocation &&) = default;
 
+	/**
+	 * @brief Copies bytes into the allocation
+	 * @param data The data to copy from
+	 * @param data_size The amount of bytes to copy
+	 * @param offset The offset in the allocation to start the copying at
+	 */
+	void update(const uint8_t *data, size_t data_size, uint32_t offset = 0);
+
 	void update(const std::vector<uint8_t> &data, uint32_t offset = 0);
 
 	template <class T>
 	void update(const T &value, uint32_t offset = 0)
 	{
-		update(to_bytes(value), offset);
+		update(reinterpret_cast<const uint8_t *>(&value), sizeof(T), offset);
+	}
+
+	/**
+	 * @brief Maps a range of the allocation, so that it can be written in place without an intermediate copy
+	 *        Once written, the allocation must be made visible to the device with flush().
+	 *        The buffer stays mapped, as the buffers of the frames are persistently mapped.
+	 * @param data_size The amount of bytes to map
+	 * @param offset The offset of the range in the allocation
+	 * @return Pointer to the mapped range
+	 * @throws std::runtime_error if the allocation is empty, or the range does not fit in it
+	 */
+	uint8_t *map(size_t data_size, uint32_t offset = 0);
+
+	/**
+	 * @brief Maps an object of the allocation, so that its members can be written in place
+	 *        Once written, the allocation must be made visible to the device with flush().
+	 *        Mapped memory may be uncached, the object should only be written to.
+	 * @param offset The offset of the object in the allocation
+	 * @return Pointer to the object in mapped memory
+	 * @throws std::runtime_error if the allocation is empty, or the object does not fit in it
+	 */
+	template <class T>
+	T *emplace(uint32_t offset = 0)
+	{
+		return reinterpret_cast<T *>(map(sizeof(T), offset));
 	}
 
+	/**
+	 * @brief Makes the writes to the mapped allocation visible to the device, if its memory is not host coherent
+	 */
+	void flush();
+
 	bool empty() const;
 
 	VkDeviceSize get_size() const;
@@ -146,4 +187,83 @@ class BufferPool
 
 	VmaMemoryUsage memory_usage{};
 };
+
+/**
+ * @brief A persistently mapped buffer sub-allocated as a ring, shared by all the frames in flight.
+ *
+ * Allocations of a frame are released once the frame is retired, i.e. once its fence has been waited on,
+ * so in steady state the ring wraps around without creating any buffer, whatever the allocation sizes.
+ * When the free space can't fit an allocation, the ring grows to a new buffer at least twice as large,
+ * and keeps the previous one alive until the frames which allocated from it are retired.
+ *
+ * A ring must only be used by one thread at a time.
+ */
+class BufferRing
+{
+  public:
+	BufferRing(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+	BufferRing(const BufferRing &) = delete;
+
+	BufferRing(BufferRing &&) = delete;
+
+	BufferRing &operator=(const BufferRing &) = delete;
+
+	BufferRing &operator=(BufferRing &&) = delete;
+
+	/**
+	 * @brief Starts a frame, the following allocations belong to it
+	 * @param frame Index of the frame, greater than the ones of the previous frames
+	 */
+	void begin_frame(uint64_t frame);
+
+	/**
+	 * @brief Releases the allocations of a frame and of all the frames before it
+	 *        Must only be called once the GPU is done with the frame.
+	 * @param frame Index of the frame
+	 */
+	void release_frame(uint64_t frame);
+
+	/**
+	 * @param size Amount of memory required
+	 * @return An usable view on a portion of the ring buffer
+	 */
+	BufferAllocation allocate(VkDeviceSize size);
+
+	VkDeviceSize get_size() const;
+
+  private:
+	/**
+	 * @brief Finds room for an allocation in the free space of the ring
+	 * @return \c true if \a size bytes fit at the returned \a offset, otherwise \c false.
+	 */
+	bool find_offset(VkDeviceSize size, VkDeviceSize &offset) const;
+
+	/**
+	 * @brief Replaces the ring buffer with an empty one, which can fit at least \a size bytes
+	 */
+	void grow(VkDeviceSize size);
+
+	Device &device;
+
+	VkBufferUsageFlags usage{};
+
+	VmaMemoryUsage memory_usage{};
+
+	std::unique_ptr<core::Buffer> buffer;
+
+	// Memory alignment, it may change according to the usage
+	VkDeviceSize alignment{0};
+
+	// End of the last allocation
+	VkDeviceSize head{0};
+
+	/// Index and start offset of the frames which have not been released yet, oldest first
+	std::deque<std::pair<uint64_t, VkDeviceSize>> frame_starts;
+
+	/// Previous ring buffers, with the index of the last frame which allocated from them
+	std::deque<std::pair<uint64_t, std::unique_ptr<core::Buffer>>> retired_buffers;
+
+	uint64_t current_frame{0};
+};
 }        // namespace vkb
@@ -0,0 +1,136 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace vkb
+{
+/**
+ * @brief Usage counters of a cache
+ */
+struct CacheCounters
+{
+	/// Number of buckets of the miss time histogram
+	static constexpr size_t miss_time_bucket_count = 20;
+
+	/// Requests which found the object in the cache
+	uint64_t hits{0};
+
+	/// Requests which had to build the object
+	uint64_t misses{0};
+
+	/// Objects destroyed to keep the cache within its budget
+	uint64_t evictions{0};
+
+	/// Total time spent building objects on misses, in nanoseconds
+	uint64_t miss_time{0};
+
+	/// Number of misses per build time. Bucket i counts the misses which took less than 2^i microseconds
+	/// (and more than the previous bucket), the last bucket counts all the longer ones.
+	std::array<uint64_t, miss_time_bucket_count> miss_time_histogram{};
+
+	/**
+	 * @brief Returns the bucket of the miss time histogram a build time falls in
+	 * @param time The build time in nanoseconds
+	 */
+	static size_t get_miss_time_bucket(uint64_t time)
+	{
+		size_t bucket = 0;
+
+		for (uint64_t microseconds = time / 1000; microseconds > 0 && bucket < miss_time_bucket_count - 1; microseconds >>= 1)
+		{
+			++bucket;
+		}
+
+		return bucket;
+	}
+
+	/**
+	 * @brief Returns the upper bound of a bucket of the miss time histogram, in nanoseconds
+	 */
+	static uint64_t get_miss_time_bucket_limit(size_t bucket)
+	{
+		return (uint64_t{1} << bucket) * 1000;
+	}
+
+	/**
+	 * @brief Counts a miss
+	 * @param time The time it took to build the object, in nanoseconds
+	 */
+	void add_miss(uint64_t time)
+	{
+		++misses;
+		miss_time += time;
+		++miss_time_histogram[get_miss_time_bucket(time)];
+	}
+
+	/**
+	 * @brief Returns an upper bound of a percentile of the miss times, from the histogram
+	 * @param percentile The percentile, between 0 and 100
+	 * @return The limit of the bucket the percentile falls in, in nanoseconds, or 0 if there was no miss
+	 */
+	uint64_t get_miss_time_percentile(float percentile) const
+	{
+		uint64_t total = 0;
+
+		for (auto count : miss_time_histogram)
+		{
+			total += count;
+		}
+
+		if (total == 0)
+		{
+			return 0;
+		}
+
+		auto     threshold = static_cast<uint64_t>(std::ceil(static_cast<double>(total) * percentile / 100.0));
+		uint64_t count     = 0;
+
+		for (size_t bucket = 0; bucket < miss_time_bucket_count; ++bucket)
+		{
+			count += miss_time_histogram[bucket];
+
+			if (count >= threshold && count > 0)
+			{
+				return get_miss_time_bucket_limit(bucket);
+			}
+		}
+
+		return get_miss_time_bucket_limit(miss_time_bucket_count - 1);
+	}
+
+	CacheCounters &operator+=(const CacheCounters &other)
+	{
+		hits += other.hits;
+		misses += other.misses;
+		evictions += other.evictions;
+		miss_time += other.miss_time;
+
+		for (size_t bucket = 0; bucket < miss_time_bucket_count; ++bucket)
+		{
+			miss_time_histogram[bucket] += other.miss_time_histogram[bucket];
+		}
+
+		return *this;
+	}
+};
+}        // namespace vkb
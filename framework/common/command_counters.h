@@ -0,0 +1,59 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace vkb
+{
+/**
+ * @brief Counters of the commands recorded in command buffers
+ */
+struct CommandCounters
+{
+	/// Draw commands, direct or indirect
+	uint64_t draws{0};
+
+	/// Dispatch commands, direct or indirect
+	uint64_t dispatches{0};
+
+	/// Pipeline, vertex buffer, index buffer, descriptor set and dynamic state commands recorded
+	uint64_t binds{0};
+
+	/// Bind and dynamic state commands skipped because they would not have changed the bound state
+	uint64_t elided_binds{0};
+
+	/// Descriptor sets requested from the render frame, or written to a descriptor buffer
+	uint64_t descriptor_sets{0};
+
+	/// Draws skipped by visibility culling before being recorded
+	uint64_t culled_draws{0};
+
+	CommandCounters &operator+=(const CommandCounters &other)
+	{
+		draws += other.draws;
+		dispatches += other.dispatches;
+		binds += other.binds;
+		elided_binds += other.elided_binds;
+		descriptor_sets += other.descriptor_sets;
+		culled_draws += other.culled_draws;
+
+		return *this;
+	}
+};
+}        // namespace vkb
@@ -0,0 +1,398 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/cache_counters.h"
+
+namespace vkb
+{
+/**
+ * @brief Hash-indexed map of cached objects which can be accessed from multiple threads.
+ *        The map is split in shards, each protected by a reader/writer lock.
+ *        Lookups of existing objects only take a shared lock on a single shard, so they never wait on each other.
+ *        Building a missing object is done without holding any lock. Concurrent requests for the same
+ *        missing object wait until the first one is built, while requests for other objects go through.
+ *        References to stored objects stay valid until they are erased or the map is cleared.
+ *        Every object remembers the last frame it was requested in, so the least recently used ones can be evicted.
+ */
+template <class T>
+class ConcurrentResourceMap
+{
+  public:
+	static constexpr size_t shard_count = 64;
+
+	ConcurrentResourceMap() = default;
+
+	ConcurrentResourceMap(const ConcurrentResourceMap &) = delete;
+
+	ConcurrentResourceMap(ConcurrentResourceMap &&) = delete;
+
+	ConcurrentResourceMap &operator=(const ConcurrentResourceMap &) = delete;
+
+	ConcurrentResourceMap &operator=(ConcurrentResourceMap &&) = delete;
+
+	/**
+	 * @brief Finds an object
+	 * @param hash The hash of the object
+	 * @return The object, or nullptr if it is not in the map
+	 */
+	T *find(size_t hash)
+	{
+		auto &shard = get_shard(hash);
+
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+		auto it = shard.resources.find(hash);
+
+		return it != shard.resources.end() ? &it->second.resource : nullptr;
+	}
+
+	/**
+	 * @brief Finds an object and records its use, counting a cache hit
+	 * @param hash The hash of the object
+	 * @return The object, or nullptr if it is not in the map
+	 */
+	T *touch(size_t hash)
+	{
+		auto &shard = get_shard(hash);
+
+		std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+		auto it = shard.resources.find(hash);
+
+		if (it == shard.resources.end())
+		{
+			return nullptr;
+		}
+
+		it->second.last_used.store(current_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		shard.hits.fetch_add(1, std::memory_order_relaxed);
+
+		return &it->second.resource;
+	}
+
+	/**
+	 * @brief Finds an object, or builds and inserts it if it is not in the map
+	 * @param hash The hash of the object
+	 * @param create Function returning the new object, called without holding any lock
+	 * @param on_insert Function called with the new object once inserted, before any other thread can access it
+	 * @return The object stored for the given hash
+	 */
+	template <class CreateFunc, class InsertFunc>
+	T &find_or_create(size_t hash, CreateFunc &&create, InsertFunc &&on_insert)
+	{
+		if (auto resource = touch(hash))
+		{
+			return *resource;
+		}
+
+		auto &shard = get_shard(hash);
+
+		uint64_t frame = current_frame.load(std::memory_order_relaxed);
+
+		std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+		// Wait for another thread which may be building the same object
+		shard.building_done.wait(lock, [&shard, hash]() { return shard.building.find(hash) == shard.building.end(); });
+
+		auto it = shard.resources.find(hash);
+
+		if (it != shard.resources.end())
+		{
+			it->second.last_used.store(frame, std::memory_order_relaxed);
+			shard.hits.fetch_add(1, std::memory_order_relaxed);
+
+			return it->second.resource;
+		}
+
+		shard.building.insert(hash);
+
+		lock.unlock();
+
+		uint64_t miss_time = 0;
+
+		try
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			T resource = create();
+
+			miss_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+			lock.lock();
+
+			it = shard.resources.emplace(std::piecewise_construct,
+			                             std::forward_as_tuple(hash),
+			                             std::forward_as_tuple(std::move(resource), frame))
+			         .first;
+
+			on_insert(it->second.resource);
+		}
+		catch (...)
+		{
+			if (!lock.owns_lock())
+			{
+				lock.lock();
+			}
+
+			shard.building.erase(hash);
+			lock.unlock();
+			shard.building_done.notify_all();
+
+			throw;
+		}
+
+		shard.misses.fetch_add(1, std::memory_order_relaxed);
+		shard.miss_time.fetch_add(miss_time, std::memory_order_relaxed);
+		shard.miss_time_histogram[CacheCounters::get_miss_time_bucket(miss_time)].fetch_add(1, std::memory_order_relaxed);
+
+		shard.building.erase(hash);
+		lock.unlock();
+		shard.building_done.notify_all();
+
+		return it->second.resource;
+	}
+
+	/**
+	 * @brief Moves an object to a new hash, without moving the object itself
+	 * @param old_hash The current hash of the object
+	 * @param new_hash The new hash of the object
+	 * @return False if there was no object for the old hash, or there is already one for the new hash
+	 */
+	bool rehash(size_t old_hash, size_t new_hash)
+	{
+		auto &old_shard = get_shard(old_hash);
+		auto &new_shard = get_shard(new_hash);
+
+		// Lock both shards in a consistent order
+		std::unique_lock<std::shared_mutex> first_lock(&old_shard < &new_shard ? old_shard.mutex : new_shard.mutex);
+		std::unique_lock<std::shared_mutex> second_lock;
+
+		if (&old_shard != &new_shard)
+		{
+			second_lock = std::unique_lock<std::shared_mutex>(&old_shard < &new_shard ? new_shard.mutex : old_shard.mutex);
+		}
+
+		auto it = old_shard.resources.find(old_hash);
+
+		if (it == old_shard.resources.end() || new_shard.resources.find(new_hash) != new_shard.resources.end())
+		{
+			return false;
+		}
+
+		auto node  = old_shard.resources.extract(it);
+		node.key() = new_hash;
+		new_shard.resources.insert(std::move(node));
+
+		return true;
+	}
+
+	/**
+	 * @brief Calls a function with the hash and object of every element of the map
+	 *        Must not be called while other threads are inserting objects.
+	 */
+	template <class Func>
+	void for_each(Func &&func)
+	{
+		for (auto &shard : shards)
+		{
+			for (auto &it : shard.resources)
+			{
+				func(it.first, it.second.resource);
+			}
+		}
+	}
+
+	size_t size() const
+	{
+		size_t result = 0;
+
+		for (auto &shard : shards)
+		{
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			result += shard.resources.size();
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief Sets the frame recorded as last use of the objects found or created from now on
+	 */
+	void set_frame(uint64_t frame)
+	{
+		current_frame.store(frame, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Destroys the least recently used objects until the map holds at most a given number of objects
+	 *        Objects used after the last retired frame are kept, even if the map stays above its capacity.
+	 *        Must not be called while other threads are accessing the map.
+	 * @param capacity The maximum number of objects to keep
+	 * @param last_retired_frame The most recent frame whose objects are no longer in use
+	 * @param on_evict Function called with every object before it is destroyed
+	 * @return The number of destroyed objects
+	 */
+	template <class EvictFunc>
+	size_t evict(size_t capacity, uint64_t last_retired_frame, EvictFunc &&on_evict)
+	{
+		size_t count = size();
+
+		if (count <= capacity)
+		{
+			return 0;
+		}
+
+		// Pairs of last use and hash
+		std::vector<std::pair<uint64_t, size_t>> candidates;
+
+		for (auto &shard : shards)
+		{
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			for (auto &it : shard.resources)
+			{
+				uint64_t last_used = it.second.last_used.load(std::memory_order_relaxed);
+
+				if (last_used <= last_retired_frame)
+				{
+					candidates.emplace_back(last_used, it.first);
+				}
+			}
+		}
+
+		size_t evict_count = std::min(count - capacity, candidates.size());
+
+		std::nth_element(candidates.begin(), candidates.begin() + evict_count, candidates.end());
+
+		for (size_t i = 0; i < evict_count; ++i)
+		{
+			auto &shard = get_shard(candidates[i].second);
+
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			auto it = shard.resources.find(candidates[i].second);
+
+			on_evict(it->second.resource);
+
+			shard.resources.erase(it);
+			shard.evictions.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		return evict_count;
+	}
+
+	/**
+	 * @brief Returns the usage counters accumulated since the map was created
+	 */
+	CacheCounters get_counters() const
+	{
+		CacheCounters counters;
+
+		for (auto &shard : shards)
+		{
+			counters.hits += shard.hits.load(std::memory_order_relaxed);
+			counters.misses += shard.misses.load(std::memory_order_relaxed);
+			counters.evictions += shard.evictions.load(std::memory_order_relaxed);
+			counters.miss_time += shard.miss_time.load(std::memory_order_relaxed);
+
+			for (size_t bucket = 0; bucket < CacheCounters::miss_time_bucket_count; ++bucket)
+			{
+				counters.miss_time_histogram[bucket] += shard.miss_time_histogram[bucket].load(std::memory_order_relaxed);
+			}
+		}
+
+		return counters;
+	}
+
+	/**
+	 * @brief Destroys all the objects of the map
+	 *        Must not be called while other threads are accessing the map.
+	 */
+	void clear()
+	{
+		for (auto &shard : shards)
+		{
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			shard.resources.clear();
+		}
+	}
+
+  private:
+	struct Entry
+	{
+		Entry(T &&resource, uint64_t last_used) :
+		    resource{std::move(resource)},
+		    last_used{last_used}
+		{}
+
+		T resource;
+
+		/// Frame in which the object was last requested
+		std::atomic<uint64_t> last_used;
+	};
+
+	struct Shard
+	{
+		mutable std::shared_mutex mutex;
+
+		std::condition_variable_any building_done;
+
+		std::unordered_map<size_t, Entry> resources;
+
+		/// Hashes of the objects currently being built
+		std::unordered_set<size_t> building;
+
+		// Counters are kept per shard, so that cache hits on different shards do not contend
+		std::atomic<uint64_t> hits{0};
+
+		std::atomic<uint64_t> misses{0};
+
+		std::atomic<uint64_t> evictions{0};
+
+		/// Time spent building objects, in nanoseconds
+		std::atomic<uint64_t> miss_time{0};
+
+		std::array<std::atomic<uint64_t>, CacheCounters::miss_time_bucket_count> miss_time_histogram{};
+	};
+
+	Shard &get_shard(size_t hash)
+	{
+		// The low bits of combined hashes are not well distributed
+		return shards[(hash ^ (hash >> 17) ^ (hash >> 31)) % shard_count];
+	}
+
+	std::array<Shard, shard_count> shards;
+
+	std::atomic<uint64_t> current_frame{0};
+};
+}        // namespace vkb
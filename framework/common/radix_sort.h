@@ -0,0 +1,96 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Sorts elements by an unsigned 64-bit key, in ascending order
+ *        Least significant digit radix sort, one byte per pass. Passes in which all the keys share
+ *        the same byte are skipped. The sort is stable, so elements with equal keys keep their order.
+ * @param elements The elements to sort
+ * @param scratch Storage for the intermediate passes, which can be reused between calls to avoid allocations
+ * @param get_key Function returning the uint64_t key of an element
+ */
+template <class T, class KeyFunc>
+void radix_sort(std::vector<T> &elements, std::vector<T> &scratch, KeyFunc &&get_key)
+{
+	constexpr size_t pass_count = sizeof(uint64_t);
+
+	if (elements.size() < 2)
+	{
+		return;
+	}
+
+	// Count the occurrences of every byte value for all the passes at once
+	std::array<std::array<size_t, 256>, pass_count> histograms{};
+
+	for (auto &element : elements)
+	{
+		uint64_t key = get_key(element);
+
+		for (size_t pass = 0; pass < pass_count; ++pass)
+		{
+			++histograms[pass][(key >> (pass * 8)) & 0xFF];
+		}
+	}
+
+	scratch.resize(elements.size());
+
+	std::vector<T> *source      = &elements;
+	std::vector<T> *destination = &scratch;
+
+	for (size_t pass = 0; pass < pass_count; ++pass)
+	{
+		auto &histogram = histograms[pass];
+
+		// All the keys share this byte
+		if (histogram[(get_key(source->front()) >> (pass * 8)) & 0xFF] == elements.size())
+		{
+			continue;
+		}
+
+		std::array<size_t, 256> offsets;
+
+		size_t offset = 0;
+
+		for (size_t digit = 0; digit < 256; ++digit)
+		{
+			offsets[digit] = offset;
+			offset += histogram[digit];
+		}
+
+		for (auto &element : *source)
+		{
+			(*destination)[offsets[(get_key(element) >> (pass * 8)) & 0xFF]++] = std::move(element);
+		}
+
+		std::swap(source, destination);
+	}
+
+	if (source != &elements)
+	{
+		elements.swap(scratch);
+	}
+}
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2021, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -457,85 +457,125 @@ struct hash<vkb::PipelineState>
 {
 	std::size_t operator()(const vkb::PipelineState &pipeline_state) const
 	{
-		std::size_t result = 0;
+		// The key only depends on the contents of the state, not on handles, so it is stable across runs.
+		// State structures only contain 32-bit members, so they are hashed as raw bytes.
+		vkb::StableHasher hasher;
 
-		vkb::hash_combine(result, pipeline_state.get_pipeline_layout().get_handle());
+		// The pipeline layout is fully determined by its shader modules
+		for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+		{
+			hasher.update(static_cast<uint64_t>(shader_module->get_id()));
+		}
 
 		// For graphics only
 		if (auto render_pass = pipeline_state.get_render_pass())
 		{
-			vkb::hash_combine(result, render_pass->get_handle());
+			hasher.update(render_pass->get_id());
 		}
 
-		vkb::hash_combine(result, pipeline_state.get_specialization_constant_state());
-
-		vkb::hash_combine(result, pipeline_state.get_subpass_index());
-
-		for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+		for (auto &constant : pipeline_state.get_specialization_constant_state().get_specialization_constant_state())
 		{
-			vkb::hash_combine(result, shader_module->get_id());
+			hasher.update(constant.first);
+			hasher.update(constant.second);
 		}
 
-		// VkPipelineVertexInputStateCreateInfo
-		for (auto &attribute : pipeline_state.get_vertex_input_state().attributes)
-		{
-			vkb::hash_combine(result, attribute);
-		}
+		hasher.update(pipeline_state.get_subpass_index());
 
-		for (auto &binding : pipeline_state.get_vertex_input_state().bindings)
-		{
-			vkb::hash_combine(result, binding);
-		}
+		// VkPipelineVertexInputStateCreateInfo
+		hasher.update(pipeline_state.get_vertex_input_state().attributes);
+		hasher.update(pipeline_state.get_vertex_input_state().bindings);
 
 		// VkPipelineInputAssemblyStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_input_assembly_state().primitive_restart_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkPrimitiveTopology>::type>(pipeline_state.get_input_assembly_state().topology));
+		hasher.update(pipeline_state.get_input_assembly_state());
 
-		//VkPipelineViewportStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_viewport_state().viewport_count);
-		vkb::hash_combine(result, pipeline_state.get_viewport_state().scissor_count);
+		// VkPipelineViewportStateCreateInfo
+		hasher.update(pipeline_state.get_viewport_state());
 
 		// VkPipelineRasterizationStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().cull_mode);
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().depth_bias_enable);
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().depth_clamp_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkFrontFace>::type>(pipeline_state.get_rasterization_state().front_face));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkPolygonMode>::type>(pipeline_state.get_rasterization_state().polygon_mode));
-		vkb::hash_combine(result, pipeline_state.get_rasterization_state().rasterizer_discard_enable);
+		hasher.update(pipeline_state.get_rasterization_state());
 
 		// VkPipelineMultisampleStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().alpha_to_coverage_enable);
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().alpha_to_one_enable);
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().min_sample_shading);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkSampleCountFlagBits>::type>(pipeline_state.get_multisample_state().rasterization_samples));
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().sample_shading_enable);
-		vkb::hash_combine(result, pipeline_state.get_multisample_state().sample_mask);
+		hasher.update(pipeline_state.get_multisample_state());
 
 		// VkPipelineDepthStencilStateCreateInfo
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().back);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().depth_bounds_test_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(pipeline_state.get_depth_stencil_state().depth_compare_op));
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().depth_test_enable);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().depth_write_enable);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().front);
-		vkb::hash_combine(result, pipeline_state.get_depth_stencil_state().stencil_test_enable);
+		hasher.update(pipeline_state.get_depth_stencil_state());
 
 		// VkPipelineColorBlendStateCreateInfo
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkLogicOp>::type>(pipeline_state.get_color_blend_state().logic_op));
-		vkb::hash_combine(result, pipeline_state.get_color_blend_state().logic_op_enable);
+		hasher.update(pipeline_state.get_color_blend_state().logic_op_enable);
+		hasher.update(pipeline_state.get_color_blend_state().logic_op);
+		hasher.update(pipeline_state.get_color_blend_state().attachments);
 
-		for (auto &attachment : pipeline_state.get_color_blend_state().attachments)
-		{
-			vkb::hash_combine(result, attachment);
-		}
-
-		return result;
+		return static_cast<std::size_t>(hasher.result());
 	}
 };
 }        // namespace std
 
 namespace vkb
 {
+/**
+ * @brief Hashes the part of a pipeline state compiled into graphics pipeline libraries
+ *        States which only differ in the state of the other parts give the same hash.
+ * @param pipeline_state The state of the pipeline
+ * @param parts The parts of the pipeline the library contains
+ */
+inline size_t hash_graphics_pipeline_library(const PipelineState &pipeline_state, VkGraphicsPipelineLibraryFlagsEXT parts)
+{
+	StableHasher hasher;
+
+	hasher.update(parts);
+
+	// Every part is created against the render pass and subpass
+	hasher.update(pipeline_state.get_render_pass()->get_id());
+	hasher.update(pipeline_state.get_subpass_index());
+
+	if (parts & (VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT))
+	{
+		// Shader parts use the pipeline layout, which is fully determined by all the shader modules
+		for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+		{
+			hasher.update(static_cast<uint64_t>(shader_module->get_id()));
+		}
+
+		for (auto &constant : pipeline_state.get_specialization_constant_state().get_specialization_constant_state())
+		{
+			hasher.update(constant.first);
+			hasher.update(constant.second);
+		}
+	}
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT)
+	{
+		hasher.update(pipeline_state.get_vertex_input_state().attributes);
+		hasher.update(pipeline_state.get_vertex_input_state().bindings);
+		hasher.update(pipeline_state.get_input_assembly_state());
+	}
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT)
+	{
+		hasher.update(pipeline_state.get_viewport_state());
+		hasher.update(pipeline_state.get_rasterization_state());
+	}
+
+	if (parts & (VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT))
+	{
+		hasher.update(pipeline_state.get_multisample_state());
+	}
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)
+	{
+		hasher.update(pipeline_state.get_depth_stencil_state());
+	}
+
+	if (parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT)
+	{
+		hasher.update(pipeline_state.get_color_blend_state().logic_op_enable);
+		hasher.update(pipeline_state.get_color_blend_state().logic_op);
+		hasher.update(pipeline_state.get_color_blend_state().attachments);
+	}
+
+	return static_cast<size_t>(hasher.result());
+}
+
 namespace
 {
 template <typename T>
@@ -557,39 +597,6 @@ inline void hash_param<std::vector<uint8_t>>(
 	hash_combine(seed, std::string{value.begin(), value.end()});
 }
 
-template <>
-inline void hash_param<std::vector<Attachment>>(
-    size_t &                       seed,
-    const std::vector<Attachment> &value)
-{
-	for (auto &attachment : value)
-	{
-		hash_combine(seed, attachment);
-	}
-}
-
-template <>
-inline void hash_param<std::vector<LoadStoreInfo>>(
-    size_t &                          seed,
-    const std::vector<LoadStoreInfo> &value)
-{
-	for (auto &load_store_info : value)
-	{
-		hash_combine(seed, load_store_info);
-	}
-}
-
-template <>
-inline void hash_param<std::vector<SubpassInfo>>(
-    size_t &                        seed,
-    const std::vector<SubpassInfo> &value)
-{
-	for (auto &subpass_info : value)
-	{
-		hash_combine(seed, subpass_info);
-	}
-}
-
 template <>
 inline void hash_param<std::vector<ShaderModule *>>(
     size_t &                           seed,
@@ -617,16 +624,20 @@ inline void hash_param<std::map<uint32_t, std::map<uint32_t, VkDescriptorBufferI
     size_t &                                                              seed,
     const std::map<uint32_t, std::map<uint32_t, VkDescriptorBufferInfo>> &value)
 {
+	StableHasher hasher;
+
 	for (auto &binding_set : value)
 	{
-		hash_combine(seed, binding_set.first);
+		hasher.update(binding_set.first);
 
 		for (auto &binding_element : binding_set.second)
 		{
-			hash_combine(seed, binding_element.first);
-			hash_combine(seed, binding_element.second);
+			hasher.update(binding_element.first);
+			hasher.update(binding_element.second);
 		}
 	}
+
+	hash_combine(seed, static_cast<size_t>(hasher.result()));
 }
 
 template <>
@@ -634,16 +645,32 @@ inline void hash_param<std::map<uint32_t, std::map<uint32_t, VkDescriptorImageIn
     size_t &                                                             seed,
     const std::map<uint32_t, std::map<uint32_t, VkDescriptorImageInfo>> &value)
 {
+	StableHasher hasher;
+
 	for (auto &binding_set : value)
 	{
-		hash_combine(seed, binding_set.first);
+		hasher.update(binding_set.first);
 
 		for (auto &binding_element : binding_set.second)
 		{
-			hash_combine(seed, binding_element.first);
-			hash_combine(seed, binding_element.second);
+			// VkDescriptorImageInfo has trailing padding on 64-bit platforms
+			hasher.update(binding_element.first);
+			hasher.update(binding_element.second.sampler);
+			hasher.update(binding_element.second.imageView);
+			hasher.update(binding_element.second.imageLayout);
 		}
 	}
+
+	hash_combine(seed, static_cast<size_t>(hasher.result()));
+}
+
+inline void hash_param(
+    size_t &                          seed,
+    const std::vector<Attachment> &   attachments,
+    const std::vector<LoadStoreInfo> &load_store_infos,
+    const std::vector<SubpassInfo> &  subpasses)
+{
+	hash_combine(seed, static_cast<size_t>(hash_render_pass(attachments, load_store_infos, subpasses)));
 }
 
 template <typename T, typename... Args>
@@ -58,9 +58,19 @@ Buffer::Buffer(Device const &device, VkDeviceSize size, VkBufferUsageFlags buffe
 {}
 
 Buffer::Buffer(Device const &device, const BufferBuilder &builder) :
-    Allocated{builder.alloc_create_info, VK_NULL_HANDLE, &device}, size(builder.create_info.size)
+    Allocated{builder.alloc_create_info, VK_NULL_HANDLE, &device}, size(builder.create_info.size), usage(builder.create_info.usage)
 {
-	handle = create_buffer(builder.create_info);
+	VkBufferCreateInfo create_info = builder.create_info;
+
+	// Descriptor buffers reference the buffers bound to descriptors by device address
+	if ((usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) && device.get_resource_cache().uses_descriptor_buffers())
+	{
+		usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+	}
+
+	create_info.usage = usage;
+
+	handle = create_buffer(create_info);
 	if (!builder.debug_name.empty())
 	{
 		set_debug_name(builder.debug_name);
@@ -69,7 +79,8 @@ Buffer::Buffer(Device const &device, const BufferBuilder &builder) :
 
 Buffer::Buffer(Buffer &&other) noexcept :
     Allocated{std::move(other)},
-    size{std::exchange(other.size, {})}
+    size{std::exchange(other.size, {})},
+    usage{std::exchange(other.usage, {})}
 {
 }
 
@@ -83,6 +94,11 @@ VkDeviceSize Buffer::get_size() const
 	return size;
 }
 
+VkBufferUsageFlags Buffer::get_usage() const
+{
+	return usage;
+}
+
 uint64_t Buffer::get_device_address()
 {
 	VkBufferDeviceAddressInfoKHR buffer_device_address_info{};
@@ -150,6 +150,11 @@ class Buffer : public allocated::Allocated<VkBuffer>
 	 */
 	VkDeviceSize get_size() const;
 
+	/**
+	 * @return The usage flags the buffer was created with
+	 */
+	VkBufferUsageFlags get_usage() const;
+
 	/**
 	 * @return Return the buffer's device address (note: requires that the buffer has been created with the VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT usage fla)
 	 */
@@ -157,6 +162,8 @@ class Buffer : public allocated::Allocated<VkBuffer>
 
   private:
 	VkDeviceSize size{0};
+
+	VkBufferUsageFlags usage{0};
 };
 }        // namespace core
 }        // namespace vkb
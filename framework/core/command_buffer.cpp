@@ -17,6 +17,8 @@
 
 #include "command_buffer.h"
 
+#include <cstring>
+
 #include "command_pool.h"
 #include "common/error.h"
 #include "device.h"
@@ -29,10 +31,89 @@ VKBP_ENABLE_WARNINGS()
 
 namespace vkb
 {
+namespace
+{
+size_t get_descriptor_size(VkDescriptorType descriptor_type, const VkPhysicalDeviceDescriptorBufferPropertiesEXT &properties)
+{
+	switch (descriptor_type)
+	{
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			return properties.samplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			return properties.combinedImageSamplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			return properties.sampledImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			return properties.storageImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+			return properties.inputAttachmentDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			return properties.uniformBufferDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			return properties.storageBufferDescriptorSize;
+		default:
+			throw std::runtime_error("Descriptor type " + std::to_string(descriptor_type) + " is not supported in descriptor buffers");
+	}
+}
+
+VkDeviceSize align_descriptor_buffer_offset(VkDeviceSize offset, const VkPhysicalDeviceDescriptorBufferPropertiesEXT &properties)
+{
+	VkDeviceSize alignment = properties.descriptorBufferOffsetAlignment;
+
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+VkDeviceAddress get_buffer_address(VkDevice device, VkBuffer buffer)
+{
+	VkBufferDeviceAddressInfoKHR address_info{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR};
+	address_info.buffer = buffer;
+
+	return vkGetBufferDeviceAddressKHR(device, &address_info);
+}
+
+/**
+ * @brief Records consecutive values of an indexed bound state
+ * @return False if all the values were already bound, so the command binding them can be skipped
+ */
+template <class T, size_t N>
+bool set_bound_values(std::array<T, N> &bound_values, uint32_t &bound_mask, uint32_t first, const T *values, size_t count)
+{
+	bool changed = false;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t index = first + i;
+
+		// Values out of the tracked range are always bound
+		if (index >= N)
+		{
+			changed = true;
+		}
+		else if (!(bound_mask & (1u << index)) || std::memcmp(&bound_values[index], &values[i], sizeof(T)) != 0)
+		{
+			bound_values[index] = values[i];
+			bound_mask |= 1u << index;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+enum DynamicStateBit : uint32_t
+{
+	LineWidthBit      = 1 << 0,
+	DepthBiasBit      = 1 << 1,
+	BlendConstantsBit = 1 << 2,
+	DepthBoundsBit    = 1 << 3
+};
+}        // namespace
+
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     VulkanResource{VK_NULL_HANDLE, &command_pool.get_device()},
     command_pool{command_pool},
     max_push_constants_size{get_device().get_gpu().get_properties().limits.maxPushConstantsSize},
+    push_constant_state{max_push_constants_size},
     level{level}
 {
 	VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
@@ -65,12 +146,19 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     current_render_pass(std::exchange(other.current_render_pass, {})),
     pipeline_state(std::exchange(other.pipeline_state, {})),
     resource_binding_state(std::exchange(other.resource_binding_state, {})),
-    stored_push_constants(std::exchange(other.stored_push_constants, {})),
     max_push_constants_size(std::exchange(other.max_push_constants_size, {})),
+    push_constant_state(std::exchange(other.push_constant_state, {})),
+    push_constants_layout(std::exchange(other.push_constants_layout, {})),
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    external_descriptor_sets(std::exchange(other.external_descriptor_sets, {})),
+    dirty_external_descriptor_sets(std::exchange(other.dirty_external_descriptor_sets, {})),
+    external_descriptor_sets_layout(std::exchange(other.external_descriptor_sets_layout, {})),
+    bound_descriptor_buffer(std::exchange(other.bound_descriptor_buffer, {})),
+    bound_state(std::exchange(other.bound_state, {})),
+    counters(std::exchange(other.counters, {}))
 {}
 
 void CommandBuffer::clear(VkClearAttachment attachment, VkClearRect rect)
@@ -97,7 +185,14 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	pipeline_state.reset();
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
-	stored_push_constants.clear();
+	external_descriptor_sets        = {};
+	dirty_external_descriptor_sets  = 0;
+	external_descriptor_sets_layout = nullptr;
+	bound_descriptor_buffer         = nullptr;
+	push_constants_layout           = nullptr;
+	bound_state                     = {};
+	counters                        = {};
+	push_constant_state.discard();
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -124,16 +219,28 @@ VkResult CommandBuffer::end()
 {
 	vkEndCommandBuffer(get_handle());
 
+	if (auto render_frame = command_pool.get_render_frame())
+	{
+		render_frame->add_command_counters(counters, command_pool.get_thread_index());
+	}
+
 	return VK_SUCCESS;
 }
 
-void CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
+bool CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
 {
-	flush_pipeline_state(pipeline_bind_point);
+	if (!flush_pipeline_state(pipeline_bind_point))
+	{
+		// The draw is skipped, so are its push constants
+		push_constant_state.discard();
+		return false;
+	}
 
 	flush_push_constants();
 
 	flush_descriptor_state(pipeline_bind_point);
+
+	return true;
 }
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses, VkSubpassContents contents)
@@ -142,6 +249,13 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const s
 	pipeline_state.reset();
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
+	external_descriptor_sets        = {};
+	dirty_external_descriptor_sets  = 0;
+	external_descriptor_sets_layout = nullptr;
+
+	// Push constants are pushed again with the first pipeline layout of the render pass
+	push_constant_state.invalidate();
+	push_constants_layout = nullptr;
 
 	auto &render_pass = get_render_pass(render_target, load_store_infos, subpasses);
 	auto &framebuffer = get_device().get_resource_cache().request_framebuffer(render_target, render_pass);
@@ -199,9 +313,13 @@ void CommandBuffer::next_subpass()
 	// Reset descriptor sets
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
+	external_descriptor_sets        = {};
+	dirty_external_descriptor_sets  = 0;
+	external_descriptor_sets_layout = nullptr;
 
 	// Clear stored push constants
-	stored_push_constants.clear();
+	push_constant_state.discard();
+	push_constants_layout = nullptr;
 
 	vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
 }
@@ -209,6 +327,11 @@ void CommandBuffer::next_subpass()
 void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
 {
 	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
+
+	// The bound state and the push constants are undefined after executing secondary command buffers
+	bound_state = {};
+	push_constant_state.invalidate();
+	push_constants_layout = nullptr;
 }
 
 void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
@@ -217,6 +340,11 @@ void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_com
 	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
 	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
+
+	// The bound state and the push constants are undefined after executing secondary command buffers
+	bound_state = {};
+	push_constant_state.invalidate();
+	push_constants_layout = nullptr;
 }
 
 void CommandBuffer::end_render_pass()
@@ -234,23 +362,29 @@ void CommandBuffer::set_specialization_constant(uint32_t constant_id, const std:
 	pipeline_state.set_specialization_constant(constant_id, data);
 }
 
-void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
+void CommandBuffer::push_constants(const uint8_t *data, size_t size)
 {
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
-
-	if (push_constant_size > max_push_constants_size)
+	if (!push_constant_state.record(data, size))
 	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
+		size_t push_constant_size = push_constant_state.get_size() + size;
+		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, size, push_constant_size);
 		throw std::runtime_error("Push constant limit exceeded.");
 	}
-	else
-	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
-	}
+}
+
+void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
+{
+	push_constants(values.data(), values.size());
 }
 
 void CommandBuffer::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
+	// Descriptors written to descriptor buffers reference the buffer by its device address
+	if (!(buffer.get_usage() & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) && get_device().get_resource_cache().uses_descriptor_buffers())
+	{
+		throw std::runtime_error("Buffers bound with descriptor buffers must be created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT");
+	}
+
 	resource_binding_state.bind_buffer(buffer, offset, range, set, binding, array_element);
 }
 
@@ -271,15 +405,44 @@ void CommandBuffer::bind_input(const core::ImageView &image_view, uint32_t set,
 
 void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets)
 {
+	bool changed = false;
+
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		VertexBufferBinding binding{buffers[i].get().get_handle(), offsets[i]};
+
+		changed |= set_bound_values(bound_state.vertex_buffers, bound_state.vertex_buffer_mask, to_u32(first_binding + i), &binding, 1);
+	}
+
+	if (!changed)
+	{
+		++counters.elided_binds;
+		return;
+	}
+
 	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
 	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(),
 	               [](const core::Buffer &buffer) { return buffer.get_handle(); });
 	vkCmdBindVertexBuffers(get_handle(), first_binding, to_u32(buffer_handles.size()), buffer_handles.data(), offsets.data());
+
+	++counters.binds;
 }
 
 void CommandBuffer::bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type)
 {
+	if (bound_state.index_buffer == buffer.get_handle() && bound_state.index_buffer_offset == offset && bound_state.index_type == index_type)
+	{
+		++counters.elided_binds;
+		return;
+	}
+
+	bound_state.index_buffer        = buffer.get_handle();
+	bound_state.index_buffer_offset = offset;
+	bound_state.index_type          = index_type;
+
 	vkCmdBindIndexBuffer(get_handle(), buffer.get_handle(), offset, index_type);
+
+	++counters.binds;
 }
 
 void CommandBuffer::bind_lighting(LightingState &lighting_state, uint32_t set, uint32_t binding)
@@ -291,6 +454,25 @@ void CommandBuffer::bind_lighting(LightingState &lighting_state, uint32_t set, u
 	set_specialization_constant(2, to_u32(lighting_state.spot_lights.size()));
 }
 
+void CommandBuffer::bind_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set)
+{
+	if (set >= external_descriptor_sets.size())
+	{
+		throw std::runtime_error("Descriptor set index " + std::to_string(set) + " is out of range");
+	}
+
+	if (get_device().get_resource_cache().uses_descriptor_buffers())
+	{
+		throw std::runtime_error("Descriptor sets can't be bound when the resource cache uses descriptor buffers");
+	}
+
+	if (external_descriptor_sets[set] != descriptor_set)
+	{
+		external_descriptor_sets[set] = descriptor_set;
+		dirty_external_descriptor_sets |= 1u << set;
+	}
+}
+
 void CommandBuffer::set_viewport_state(const ViewportState &state_info)
 {
 	pipeline_state.set_viewport_state(state_info);
@@ -326,55 +508,117 @@ void CommandBuffer::set_color_blend_state(const ColorBlendState &state_info)
 	pipeline_state.set_color_blend_state(state_info);
 }
 
+template <class T>
+bool CommandBuffer::set_dynamic_state(T &bound_value, const T &value, uint32_t state_bit)
+{
+	if ((bound_state.dynamic_state_mask & state_bit) && bound_value == value)
+	{
+		++counters.elided_binds;
+		return false;
+	}
+
+	bound_value = value;
+	bound_state.dynamic_state_mask |= state_bit;
+
+	++counters.binds;
+	return true;
+}
+
 void CommandBuffer::set_viewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports)
 {
+	if (!set_bound_values(bound_state.viewports, bound_state.viewport_mask, first_viewport, viewports.data(), viewports.size()))
+	{
+		++counters.elided_binds;
+		return;
+	}
+
 	vkCmdSetViewport(get_handle(), first_viewport, to_u32(viewports.size()), viewports.data());
+
+	++counters.binds;
 }
 
 void CommandBuffer::set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors)
 {
+	if (!set_bound_values(bound_state.scissors, bound_state.scissor_mask, first_scissor, scissors.data(), scissors.size()))
+	{
+		++counters.elided_binds;
+		return;
+	}
+
 	vkCmdSetScissor(get_handle(), first_scissor, to_u32(scissors.size()), scissors.data());
+
+	++counters.binds;
 }
 
 void CommandBuffer::set_line_width(float line_width)
 {
-	vkCmdSetLineWidth(get_handle(), line_width);
+	if (set_dynamic_state(bound_state.line_width, line_width, LineWidthBit))
+	{
+		vkCmdSetLineWidth(get_handle(), line_width);
+	}
 }
 
 void CommandBuffer::set_depth_bias(float depth_bias_constant_factor, float depth_bias_clamp, float depth_bias_slope_factor)
 {
-	vkCmdSetDepthBias(get_handle(), depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+	if (set_dynamic_state(bound_state.depth_bias, {depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor}, DepthBiasBit))
+	{
+		vkCmdSetDepthBias(get_handle(), depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+	}
 }
 
 void CommandBuffer::set_blend_constants(const std::array<float, 4> &blend_constants)
 {
-	vkCmdSetBlendConstants(get_handle(), blend_constants.data());
+	if (set_dynamic_state(bound_state.blend_constants, blend_constants, BlendConstantsBit))
+	{
+		vkCmdSetBlendConstants(get_handle(), blend_constants.data());
+	}
 }
 
 void CommandBuffer::set_depth_bounds(float min_depth_bounds, float max_depth_bounds)
 {
-	vkCmdSetDepthBounds(get_handle(), min_depth_bounds, max_depth_bounds);
+	if (set_dynamic_state(bound_state.depth_bounds, {min_depth_bounds, max_depth_bounds}, DepthBoundsBit))
+	{
+		vkCmdSetDepthBounds(get_handle(), min_depth_bounds, max_depth_bounds);
+	}
 }
 
 void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		// The pipeline is still being compiled, and there is no fallback for it
+		return;
+	}
 
 	vkCmdDraw(get_handle(), vertex_count, instance_count, first_vertex, first_instance);
+
+	++counters.draws;
 }
 
 void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		// The pipeline is still being compiled, and there is no fallback for it
+		return;
+	}
 
 	vkCmdDrawIndexed(get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
+
+	++counters.draws;
 }
 
 void CommandBuffer::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		// The pipeline is still being compiled, and there is no fallback for it
+		return;
+	}
 
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
+
+	++counters.draws;
 }
 
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
@@ -382,6 +626,8 @@ void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uin
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatch(get_handle(), group_count_x, group_count_y, group_count_z);
+
+	++counters.dispatches;
 }
 
 void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset)
@@ -389,6 +635,8 @@ void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize o
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatchIndirect(get_handle(), buffer.get_handle(), offset);
+
+	++counters.dispatches;
 }
 
 void CommandBuffer::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data)
@@ -484,38 +732,74 @@ void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSi
 	    0, nullptr);
 }
 
-void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
+bool CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
 {
 	// Create a new pipeline only if the graphics state changed
 	if (!pipeline_state.is_dirty())
 	{
-		return;
+		return true;
 	}
 
-	pipeline_state.clear_dirty();
-
 	// Create and bind pipeline
 	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
 	{
 		pipeline_state.set_render_pass(*current_render_pass.render_pass);
-		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
+
+		bool ready    = true;
+		auto pipeline = get_device().get_resource_cache().request_graphics_pipeline_async(pipeline_state, ready);
+
+		// Keep the state dirty until the requested pipeline is ready, so that it replaces its fallback
+		if (ready)
+		{
+			pipeline_state.clear_dirty();
+		}
+
+		if (!pipeline)
+		{
+			return false;
+		}
+
+		// A state change may lead to the pipeline which is already bound
+		if (bound_state.graphics_pipeline == pipeline->get_handle())
+		{
+			++counters.elided_binds;
+			return true;
+		}
+
+		bound_state.graphics_pipeline = pipeline->get_handle();
 
 		vkCmdBindPipeline(get_handle(),
 		                  pipeline_bind_point,
-		                  pipeline.get_handle());
+		                  pipeline->get_handle());
+
+		++counters.binds;
 	}
 	else if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
 	{
+		pipeline_state.clear_dirty();
+
 		auto &pipeline = get_device().get_resource_cache().request_compute_pipeline(pipeline_state);
 
+		if (bound_state.compute_pipeline == pipeline.get_handle())
+		{
+			++counters.elided_binds;
+			return true;
+		}
+
+		bound_state.compute_pipeline = pipeline.get_handle();
+
 		vkCmdBindPipeline(get_handle(),
 		                  pipeline_bind_point,
 		                  pipeline.get_handle());
+
+		++counters.binds;
 	}
 	else
 	{
 		throw "Only graphics and compute pipeline bind points are supported now";
 	}
+
+	return true;
 }
 
 void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point)
@@ -561,11 +845,22 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 	{
 		resource_binding_state.clear_dirty();
 
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+
+		// With descriptor buffers, the sets to update are all written to the same allocation
+		bool                  descriptor_buffers = pipeline_layout.uses_descriptor_buffers();
+		std::vector<uint32_t> descriptor_buffer_sets;
+
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < to_u32(resource_sets.size()); ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			// Sets bound with bind_descriptor_set replace the bound resources
+			if (resource_set.empty() || external_descriptor_sets[descriptor_set_id] != VK_NULL_HANDLE)
+			{
+				continue;
+			}
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
 			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
@@ -587,135 +882,445 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			// Make descriptor set layout bound for current set
 			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
 
+			if (descriptor_buffers)
+			{
+				descriptor_buffer_sets.push_back(descriptor_set_id);
+				continue;
+			}
+
 			BindingMap<VkDescriptorBufferInfo> buffer_infos;
 			BindingMap<VkDescriptorImageInfo>  image_infos;
 
 			std::vector<uint32_t> dynamic_offsets;
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			collect_descriptor_infos(resource_set, descriptor_set_layout, buffer_infos, image_infos, dynamic_offsets);
+
+			VkDescriptorSet descriptor_set_handle =
+			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
+			                                                            buffer_infos,
+			                                                            image_infos,
+			                                                            update_after_bind,
+			                                                            command_pool.get_thread_index());
+
+			++counters.descriptor_sets;
+
+			// Bind descriptor set
+			bind_descriptor_set_handle(pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_id, descriptor_set_handle, dynamic_offsets);
+		}
+
+		if (!descriptor_buffer_sets.empty())
+		{
+			write_descriptor_buffer(pipeline_bind_point, descriptor_buffer_sets);
+		}
+	}
+
+	// Sets bound with another pipeline layout may have been disturbed, so bind the external sets again
+	if (external_descriptor_sets_layout != &pipeline_layout)
+	{
+		external_descriptor_sets_layout = &pipeline_layout;
+		dirty_external_descriptor_sets  = ~0u;
+	}
+
+	for (uint32_t descriptor_set_id = 0; dirty_external_descriptor_sets != 0 && descriptor_set_id < to_u32(external_descriptor_sets.size()); ++descriptor_set_id)
+	{
+		auto descriptor_set_handle = external_descriptor_sets[descriptor_set_id];
+
+		if (descriptor_set_handle == VK_NULL_HANDLE || !(dirty_external_descriptor_sets & (1u << descriptor_set_id)) ||
+		    !pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			continue;
+		}
+
+		bind_descriptor_set_handle(pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_id, descriptor_set_handle, {});
+	}
+
+	dirty_external_descriptor_sets = 0;
+}
+
+void CommandBuffer::collect_descriptor_infos(const ResourceSet &                 resource_set,
+                                             const DescriptorSetLayout &         descriptor_set_layout,
+                                             BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                             BindingMap<VkDescriptorImageInfo> & image_infos,
+                                             std::vector<uint32_t> &             dynamic_offsets)
+{
+	// Layout binding of the current binding, looked up once for all its array elements
+	std::unique_ptr<VkDescriptorSetLayoutBinding> binding_info;
+
+	auto check_bindings_to_update = [&]() {
+		assert((!update_after_bind || !binding_info ||
+		        (buffer_infos.count(binding_info->binding) > 0 || (image_infos.count(binding_info->binding) > 0))) &&
+		       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+	};
+
+	// Iterate over all resources, which are sorted by binding and array element
+	for (auto &resource_info : resource_set)
+	{
+		auto binding_index = resource_info.binding;
+		auto array_element = resource_info.array_element;
+
+		if (&resource_info == resource_set.begin() || binding_index != (&resource_info - 1)->binding)
+		{
+			check_bindings_to_update();
+
+			binding_info = descriptor_set_layout.get_layout_binding(binding_index);
+		}
+
+		// Check if binding exists in the pipeline layout
+		if (!binding_info)
+		{
+			continue;
+		}
+
+		// Pointer references
+		auto &buffer     = resource_info.buffer;
+		auto &sampler    = resource_info.sampler;
+		auto &image_view = resource_info.image_view;
+
+		// Get buffer info
+		if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+		{
+			VkDescriptorBufferInfo buffer_info{};
+
+			buffer_info.buffer = resource_info.buffer->get_handle();
+			buffer_info.offset = resource_info.offset;
+			buffer_info.range  = resource_info.range;
+
+			if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				dynamic_offsets.push_back(to_u32(buffer_info.offset));
+
+				buffer_info.offset = 0;
+			}
+
+			buffer_infos[binding_index][array_element] = buffer_info;
+		}
+
+		// Get image info
+		else if (image_view != nullptr || sampler != nullptr)
+		{
+			// Can be null for input attachments
+			VkDescriptorImageInfo image_info{};
+			image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+			image_info.imageView = image_view->get_handle();
 
-				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+			if (image_view != nullptr)
+			{
+				// Add image layout info based on descriptor type
+				switch (binding_info->descriptorType)
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
-					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
-
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
-
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+					case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+						image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+						break;
+					case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+						if (is_depth_format(image_view->get_format()))
+						{
+							image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+						}
+						else
 						{
-							VkDescriptorBufferInfo buffer_info{};
+							image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+						}
+						break;
+					case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+						image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+						break;
+
+					default:
+						continue;
+				}
+			}
 
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
+			image_infos[binding_index][array_element] = image_info;
+		}
+	}
 
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
+	check_bindings_to_update();
+}
 
-								buffer_info.offset = 0;
-							}
+void CommandBuffer::write_descriptor_buffer(VkPipelineBindPoint pipeline_bind_point, std::vector<uint32_t> descriptor_set_ids)
+{
+	auto &resource_cache = get_device().get_resource_cache();
+	auto &properties     = resource_cache.get_descriptor_buffer_properties();
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+	const PipelineLayout &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
-						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
-								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
-								}
-							}
-
-							image_infos[binding_index][array_element] = image_info;
-						}
-					}
+	auto &resource_sets = resource_binding_state.get_resource_sets();
+
+	std::vector<VkDeviceSize> set_offsets;
+	BufferAllocation          allocation;
+
+	while (true)
+	{
+		// Sets are packed in the allocation, each one starting at an aligned offset
+		VkDeviceSize size = 0;
+		set_offsets.clear();
+
+		for (auto descriptor_set_id : descriptor_set_ids)
+		{
+			set_offsets.push_back(size);
+			size += align_descriptor_buffer_offset(pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_descriptor_buffer_size(), properties);
+		}
+
+		allocation = command_pool.get_render_frame()->allocate_buffer(RenderFrame::DESCRIPTOR_BUFFER_USAGE, size, command_pool.get_thread_index());
+
+		if (allocation.empty())
+		{
+			throw std::runtime_error("Failed to allocate " + std::to_string(size) + " bytes of descriptor buffer");
+		}
+
+		if (&allocation.get_buffer() == bound_descriptor_buffer)
+		{
+			break;
+		}
+
+		// Binding another descriptor buffer invalidates the offsets of all the sets
+		VkDescriptorBufferBindingInfoEXT binding_info{VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT};
+		binding_info.address = allocation.get_buffer().get_device_address();
+		binding_info.usage   = RenderFrame::DESCRIPTOR_BUFFER_USAGE;
+
+		vkCmdBindDescriptorBuffersEXT(get_handle(), 1, &binding_info);
+
+		++counters.binds;
+
+		bound_descriptor_buffer = &allocation.get_buffer();
+
+		std::vector<uint32_t> all_set_ids;
+
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < to_u32(resource_sets.size()); ++descriptor_set_id)
+		{
+			if (!resource_sets[descriptor_set_id].empty() && pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+			{
+				all_set_ids.push_back(descriptor_set_id);
+			}
+		}
+
+		if (all_set_ids == descriptor_set_ids)
+		{
+			break;
+		}
+
+		descriptor_set_ids = std::move(all_set_ids);
+	}
+
+	// Descriptors are written in place, the allocation being persistently mapped
+	uint8_t *data = allocation.map(static_cast<size_t>(allocation.get_size()));
+
+	for (size_t i = 0; i < descriptor_set_ids.size(); ++i)
+	{
+		auto  descriptor_set_id     = descriptor_set_ids[i];
+		auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+
+		descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+		// Layout binding of the current binding, looked up once for all its array elements
+		std::unique_ptr<VkDescriptorSetLayoutBinding> binding_info;
+		size_t                                        size{0};
+		uint8_t                                      *binding_data{nullptr};
 
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+		// Resources are sorted by binding and array element
+		auto &resource_set = resource_sets[descriptor_set_id];
+
+		for (auto &resource_info : resource_set)
+		{
+			if (&resource_info == resource_set.begin() || resource_info.binding != (&resource_info - 1)->binding)
+			{
+				binding_info = descriptor_set_layout.get_layout_binding(resource_info.binding);
+
+				if (binding_info)
+				{
+					size         = get_descriptor_size(binding_info->descriptorType, properties);
+					binding_data = data + set_offsets[i] + descriptor_set_layout.get_descriptor_buffer_offset(resource_info.binding);
 				}
 			}
 
-			VkDescriptorSet descriptor_set_handle =
-			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
-			                                                            update_after_bind,
-			                                                            command_pool.get_thread_index());
+			// Check if binding exists in the pipeline layout
+			if (!binding_info)
+			{
+				continue;
+			}
 
-			// Bind descriptor set
-			vkCmdBindDescriptorSets(get_handle(),
-			                        pipeline_bind_point,
-			                        pipeline_layout.get_handle(),
-			                        descriptor_set_id,
-			                        1, &descriptor_set_handle,
-			                        to_u32(dynamic_offsets.size()),
-			                        dynamic_offsets.data());
+			VkDescriptorGetInfoEXT get_info{VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT};
+			get_info.type = binding_info->descriptorType;
+
+			VkDescriptorAddressInfoEXT address_info{VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT};
+			VkDescriptorImageInfo      image_info{};
+
+			if (resource_info.buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+			{
+				// Descriptor buffer layouts have no dynamic descriptors, offsets are written in the descriptors
+				address_info.address = get_buffer_address(get_device().get_handle(), resource_info.buffer->get_handle()) + resource_info.offset;
+				address_info.range   = resource_info.range;
+				address_info.format  = VK_FORMAT_UNDEFINED;
+
+				if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+				{
+					get_info.data.pUniformBuffer = &address_info;
+				}
+				else
+				{
+					get_info.data.pStorageBuffer = &address_info;
+				}
+			}
+			else if (resource_info.image_view != nullptr)
+			{
+				image_info.sampler   = resource_info.sampler ? resource_info.sampler->get_handle() : VK_NULL_HANDLE;
+				image_info.imageView = resource_info.image_view->get_handle();
+
+				switch (binding_info->descriptorType)
+				{
+					case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+						image_info.imageLayout              = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+						get_info.data.pCombinedImageSampler = &image_info;
+						break;
+					case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+						image_info.imageLayout              = is_depth_format(resource_info.image_view->get_format()) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+						get_info.data.pInputAttachmentImage = &image_info;
+						break;
+					case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+						image_info.imageLayout      = VK_IMAGE_LAYOUT_GENERAL;
+						get_info.data.pStorageImage = &image_info;
+						break;
+
+					default:
+						continue;
+				}
+			}
+			else
+			{
+				continue;
+			}
+
+			vkGetDescriptorEXT(get_device().get_handle(), &get_info, size, binding_data + resource_info.array_element * size);
+		}
+	}
+
+	allocation.flush();
+
+	for (size_t i = 0; i < descriptor_set_ids.size(); ++i)
+	{
+		uint32_t     buffer_index = 0;
+		VkDeviceSize offset       = allocation.get_offset() + set_offsets[i];
+
+		vkCmdSetDescriptorBufferOffsetsEXT(get_handle(),
+		                                   pipeline_bind_point,
+		                                   pipeline_layout.get_handle(),
+		                                   descriptor_set_ids[i],
+		                                   1, &buffer_index,
+		                                   &offset);
+
+		disturb_descriptor_sets(pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_ids[i]);
+
+		// The set is now read from the descriptor buffer, so binding the same descriptor set again must not be skipped
+		bound_state.descriptor_sets[descriptor_set_ids[i]].descriptor_set = VK_NULL_HANDLE;
+	}
+
+	counters.binds += descriptor_set_ids.size();
+	counters.descriptor_sets += descriptor_set_ids.size();
+}
+
+void CommandBuffer::bind_descriptor_set_handle(VkPipelineBindPoint          pipeline_bind_point,
+                                               VkPipelineLayout             pipeline_layout,
+                                               uint32_t                     set,
+                                               VkDescriptorSet              descriptor_set,
+                                               const std::vector<uint32_t> &dynamic_offsets)
+{
+	auto &binding = bound_state.descriptor_sets[set];
+
+	if (binding.bind_point == pipeline_bind_point && binding.pipeline_layout == pipeline_layout &&
+	    binding.descriptor_set == descriptor_set && binding.dynamic_offsets == dynamic_offsets)
+	{
+		++counters.elided_binds;
+		return;
+	}
+
+	vkCmdBindDescriptorSets(get_handle(),
+	                        pipeline_bind_point,
+	                        pipeline_layout,
+	                        set,
+	                        1, &descriptor_set,
+	                        to_u32(dynamic_offsets.size()),
+	                        dynamic_offsets.data());
+
+	++counters.binds;
+
+	disturb_descriptor_sets(pipeline_bind_point, pipeline_layout, set);
+
+	binding.descriptor_set  = descriptor_set;
+	binding.dynamic_offsets = dynamic_offsets;
+}
+
+void CommandBuffer::disturb_descriptor_sets(VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout pipeline_layout, uint32_t set)
+{
+	auto &binding = bound_state.descriptor_sets[set];
+
+	// The sets above the bound one are only kept if it is bound with the layout it was bound with before
+	bool layout_changed = binding.bind_point != pipeline_bind_point || binding.pipeline_layout != pipeline_layout;
+
+	for (uint32_t other_set = 0; other_set < to_u32(bound_state.descriptor_sets.size()); ++other_set)
+	{
+		auto &other_binding = bound_state.descriptor_sets[other_set];
+
+		if (other_set == set || other_binding.bind_point != pipeline_bind_point)
+		{
+			continue;
+		}
+
+		if (other_binding.pipeline_layout != pipeline_layout || (layout_changed && other_set > set))
+		{
+			other_binding.descriptor_set = VK_NULL_HANDLE;
 		}
 	}
+
+	binding.bind_point      = pipeline_bind_point;
+	binding.pipeline_layout = pipeline_layout;
 }
 
 void CommandBuffer::flush_push_constants()
 {
-	if (stored_push_constants.empty())
+	if (push_constant_state.get_size() == 0)
 	{
 		return;
 	}
 
 	const PipelineLayout &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	VkShaderStageFlags shader_stage = pipeline_layout.get_push_constant_range_stage(to_u32(stored_push_constants.size()));
-
-	if (shader_stage)
+	// Push constants pushed with another pipeline layout may have been disturbed, so push all of them again
+	if (push_constants_layout != &pipeline_layout)
 	{
-		vkCmdPushConstants(get_handle(), pipeline_layout.get_handle(), shader_stage, 0, to_u32(stored_push_constants.size()), stored_push_constants.data());
+		push_constants_layout = &pipeline_layout;
+		push_constant_state.invalidate();
 	}
-	else
+
+	uint32_t offset = 0;
+	uint32_t size   = 0;
+	bool     pushed = false;
+
+	if (push_constant_state.get_dirty_range(offset, size))
 	{
-		LOGW("Push constant range [{}, {}] not found", 0, stored_push_constants.size());
+		VkShaderStageFlags shader_stage = pipeline_layout.get_push_constant_range_stage(size, offset);
+
+		if (shader_stage)
+		{
+			vkCmdPushConstants(get_handle(), pipeline_layout.get_handle(), shader_stage, offset, size, push_constant_state.get_data() + offset);
+			pushed = true;
+		}
+		else
+		{
+			LOGW("Push constant range [{}, {}] not found", offset, offset + size);
+		}
 	}
 
-	stored_push_constants.clear();
+	push_constant_state.complete(pushed);
+}
+
+const CommandCounters &CommandBuffer::get_counters() const
+{
+	return counters;
+}
+
+void CommandBuffer::add_culled_draws(uint32_t count)
+{
+	counters.culled_draws += count;
 }
 
 void CommandBuffer::set_update_after_bind(bool update_after_bind_)
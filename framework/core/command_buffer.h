@@ -19,6 +19,7 @@
 
 #include <list>
 
+#include "common/command_counters.h"
 #include "common/helpers.h"
 #include "common/vk_common.h"
 #include "core/buffer.h"
@@ -26,6 +27,7 @@
 #include "core/image_view.h"
 #include "core/query_pool.h"
 #include "core/sampler.h"
+#include "core/util/push_constants.hpp"
 #include "core/vulkan_resource.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_target.h"
@@ -82,8 +84,9 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 	/**
 	 * @brief Flushes the command buffer, pushing the new changes
 	 * @param pipeline_bind_point The type of pipeline we want to flush
+	 * @return False if no pipeline could be bound, because the pipeline is being compiled asynchronously without a fallback
 	 */
-	void flush(VkPipelineBindPoint pipeline_bind_point);
+	bool flush(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Sets the command buffer so that it is ready for recording
@@ -131,7 +134,16 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 	void set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data);
 
 	/**
-	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
+	 * @brief Records byte data into the command buffer to be pushed as push constants to the next draw call
+	 *        Data is appended to the push constants recorded since the last draw call.
+	 *        Only the bytes which changed since they were last pushed are given to vkCmdPushConstants.
+	 * @param data The byte data to store
+	 * @param size The amount of bytes to store
+	 */
+	void push_constants(const uint8_t *data, size_t size);
+
+	/**
+	 * @brief Records byte data into the command buffer to be pushed as push constants to the next draw call
 	 * @param values The byte data to store
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
@@ -139,17 +151,7 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
 	}
 
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -166,6 +168,15 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 
 	void bind_lighting(LightingState &lighting_state, uint32_t set, uint32_t binding);
 
+	/**
+	 * @brief Binds a descriptor set managed by the caller, such as a bindless array, at a set index
+	 *        The set stays bound for the draws and dispatches which follow, and is bound again whenever the
+	 *        pipeline layout changes. Resources bound to the same set index with bind_buffer or bind_image are ignored.
+	 * @param set The index of the set in the pipeline layout
+	 * @param descriptor_set The descriptor set handle, or VK_NULL_HANDLE to go back to the bound resources
+	 */
+	void bind_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set);
+
 	void set_viewport_state(const ViewportState &state_info);
 
 	void set_vertex_input_state(const VertexInputState &state_info);
@@ -238,6 +249,18 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 
 	RenderPass &get_render_pass(const vkb::RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<std::unique_ptr<Subpass>> &subpasses);
 
+	/**
+	 * @brief Returns the counters of the commands recorded since the command buffer began
+	 *        They are added to the counters of the render frame when the command buffer ends.
+	 */
+	const CommandCounters &get_counters() const;
+
+	/**
+	 * @brief Counts draws which were culled instead of being recorded in the command buffer
+	 * @param count The number of culled draws
+	 */
+	void add_culled_draws(uint32_t count);
+
 	const VkCommandBufferLevel level;
 
   private:
@@ -249,10 +272,13 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 
 	ResourceBindingState resource_binding_state;
 
-	std::vector<uint8_t> stored_push_constants;
-
 	uint32_t max_push_constants_size;
 
+	PushConstantState push_constant_state;
+
+	// Pipeline layout the push constants were last pushed with
+	const PipelineLayout *push_constants_layout{nullptr};
+
 	VkExtent2D last_framebuffer_extent{};
 
 	VkExtent2D last_render_area_extent{};
@@ -263,6 +289,106 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 
 	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
 
+	// Descriptor sets bound with bind_descriptor_set, indexed by set
+	std::array<VkDescriptorSet, ResourceBindingState::max_resource_sets> external_descriptor_sets{};
+
+	// Bitmask of the external descriptor sets which need to be bound on the next flush
+	uint32_t dirty_external_descriptor_sets{0};
+
+	// Pipeline layout the external descriptor sets were last bound with
+	const PipelineLayout *external_descriptor_sets_layout{nullptr};
+
+	// Descriptor buffer bound by the command buffer, when the resource cache uses descriptor buffers
+	const core::Buffer *bound_descriptor_buffer{nullptr};
+
+	/**
+	 * @brief A vertex buffer bound at a binding
+	 */
+	struct VertexBufferBinding
+	{
+		VkBuffer buffer;
+
+		VkDeviceSize offset;
+	};
+
+	/**
+	 * @brief A descriptor set bound at a set index
+	 */
+	struct DescriptorSetBinding
+	{
+		VkPipelineBindPoint bind_point;
+
+		VkPipelineLayout pipeline_layout;
+
+		VkDescriptorSet descriptor_set;
+
+		std::vector<uint32_t> dynamic_offsets;
+	};
+
+	/**
+	 * @brief State last recorded in the command buffer, so that the commands which would not change it are skipped
+	 *        Indexed values are only known if their bit is set in the corresponding mask.
+	 *        The whole state is forgotten on begin() and after executing secondary command buffers. Descriptor sets are
+	 *        also forgotten when they are disturbed by another pipeline layout, see disturb_descriptor_sets, or replaced
+	 *        by descriptor buffer offsets.
+	 */
+	struct BoundState
+	{
+		static constexpr uint32_t max_indexed_values = 16;
+
+		VkPipeline graphics_pipeline{VK_NULL_HANDLE};
+
+		VkPipeline compute_pipeline{VK_NULL_HANDLE};
+
+		std::array<VertexBufferBinding, max_indexed_values> vertex_buffers{};
+		uint32_t                                            vertex_buffer_mask{0};
+
+		VkBuffer     index_buffer{VK_NULL_HANDLE};
+		VkDeviceSize index_buffer_offset{0};
+		VkIndexType  index_type{VK_INDEX_TYPE_MAX_ENUM};
+
+		std::array<DescriptorSetBinding, ResourceBindingState::max_resource_sets> descriptor_sets{};
+
+		std::array<VkViewport, max_indexed_values> viewports{};
+		uint32_t                                   viewport_mask{0};
+
+		std::array<VkRect2D, max_indexed_values> scissors{};
+		uint32_t                                 scissor_mask{0};
+
+		// Dynamic state values, only known if their bit is set in dynamic_state_mask
+		float                line_width{0.0f};
+		std::array<float, 3> depth_bias{};
+		std::array<float, 4> blend_constants{};
+		std::array<float, 2> depth_bounds{};
+		uint32_t             dynamic_state_mask{0};
+	};
+
+	BoundState bound_state;
+
+	CommandCounters counters;
+
+	/**
+	 * @brief Binds a descriptor set, unless it is already bound with the same pipeline layout and dynamic offsets
+	 */
+	void bind_descriptor_set_handle(VkPipelineBindPoint          pipeline_bind_point,
+	                                VkPipelineLayout             pipeline_layout,
+	                                uint32_t                     set,
+	                                VkDescriptorSet              descriptor_set,
+	                                const std::vector<uint32_t> &dynamic_offsets);
+
+	/**
+	 * @brief Forgets the descriptor sets disturbed by binding a set with a pipeline layout, so that binding them again is not skipped
+	 *        These are the sets bound with other pipeline layouts, and the sets above the bound one if its pipeline layout changed.
+	 */
+	void disturb_descriptor_sets(VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout pipeline_layout, uint32_t set);
+
+	/**
+	 * @brief Records a dynamic state value, and counts the command setting it
+	 * @return False if the value was already set, so the command can be skipped
+	 */
+	template <class T>
+	bool set_dynamic_state(T &bound_value, const T &value, uint32_t state_bit);
+
 	const RenderPassBinding &get_current_render_pass() const;
 
 	const uint32_t get_current_subpass_index() const;
@@ -275,13 +401,28 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer>
 	/**
 	 * @brief Flush the pipeline state
 	 */
-	void flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
+	bool flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Flush the descriptor set state
 	 */
 	void flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Converts the resources bound to a set into the descriptor infos of the bindings of its layout
+	 */
+	void collect_descriptor_infos(const ResourceSet &                 resource_set,
+	                              const DescriptorSetLayout &         descriptor_set_layout,
+	                              BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                              BindingMap<VkDescriptorImageInfo> & image_infos,
+	                              std::vector<uint32_t> &             dynamic_offsets);
+
+	/**
+	 * @brief Writes the descriptors of sets to a descriptor buffer allocated from the render frame, and binds them by offset
+	 *        If the allocation comes from a new buffer, the buffer is bound and all the sets are written again.
+	 */
+	void write_descriptor_buffer(VkPipelineBindPoint pipeline_bind_point, std::vector<uint32_t> descriptor_set_ids);
+
 	/**
 	 * @brief Flush the push constant state
 	 */
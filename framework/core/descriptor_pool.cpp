@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -24,9 +24,11 @@ namespace vkb
 {
 DescriptorPool::DescriptorPool(Device &                   device,
                                const DescriptorSetLayout &descriptor_set_layout,
-                               uint32_t                   pool_size) :
+                               uint32_t                   pool_size,
+                               bool                       free_descriptor_sets) :
     device{device},
-    descriptor_set_layout{&descriptor_set_layout}
+    descriptor_set_layout{&descriptor_set_layout},
+    free_descriptor_sets{free_descriptor_sets}
 {
 	const auto &bindings = descriptor_set_layout.get_bindings();
 
@@ -130,7 +132,7 @@ VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 	// Get the pool index of the descriptor set
 	auto it = set_pool_mapping.find(descriptor_set);
 
-	if (it == set_pool_mapping.end())
+	if (!free_descriptor_sets || it == set_pool_mapping.end())
 	{
 		return VK_INCOMPLETE;
 	}
@@ -163,8 +165,11 @@ std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 		create_info.pPoolSizes    = pool_sizes.data();
 		create_info.maxSets       = pool_max_sets;
 
-		// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
-		create_info.flags = 0;
+		// Individual descriptor sets are freed when they are evicted from a cache with a budget
+		if (free_descriptor_sets)
+		{
+			create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+		}
 
 		// Check descriptor set layout and enable the required flags
 		auto &binding_flags = descriptor_set_layout->get_binding_flags();
@@ -35,9 +35,13 @@ class DescriptorPool
   public:
 	static const uint32_t MAX_SETS_PER_POOL = 16;
 
+	/**
+	 * @param free_descriptor_sets Whether sets can be given back with free(), which may make allocations slower on some drivers
+	 */
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
-	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
+	               uint32_t                   pool_size            = MAX_SETS_PER_POOL,
+	               bool                       free_descriptor_sets = false);
 
 	DescriptorPool(const DescriptorPool &) = delete;
 
@@ -57,6 +61,10 @@ class DescriptorPool
 
 	VkDescriptorSet allocate();
 
+	/**
+	 * @brief Gives a descriptor set back to the pool
+	 * @return VK_INCOMPLETE if the set was not allocated from this pool, or the pool was not created to free descriptor sets
+	 */
 	VkResult free(VkDescriptorSet descriptor_set);
 
   private:
@@ -70,6 +78,9 @@ class DescriptorPool
 	// Number of sets to allocate for each pool
 	uint32_t pool_max_sets{0};
 
+	// Whether pools are created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+	bool free_descriptor_sets{false};
+
 	// Total descriptor pools created
 	std::vector<VkDescriptorPool> pools;
 
@@ -54,6 +54,8 @@ void DescriptorSet::reset(const BindingMap<VkDescriptorBufferInfo> &new_buffer_i
 
 	this->write_descriptor_sets.clear();
 	this->updated_bindings.clear();
+	this->update_template_data.clear();
+	this->update_template_written = false;
 
 	prepare();
 }
@@ -61,12 +63,17 @@ void DescriptorSet::reset(const BindingMap<VkDescriptorBufferInfo> &new_buffer_i
 void DescriptorSet::prepare()
 {
 	// We don't want to prepare twice during the life cycle of a Descriptor Set
-	if (!write_descriptor_sets.empty())
+	if (!write_descriptor_sets.empty() || !update_template_data.empty())
 	{
 		LOGW("Trying to prepare a descriptor set that has already been prepared, skipping.");
 		return;
 	}
 
+	if (prepare_update_template())
+	{
+		return;
+	}
+
 	// Iterate over all buffer bindings
 	for (auto &binding_it : buffer_infos)
 	{
@@ -80,24 +87,7 @@ void DescriptorSet::prepare()
 			{
 				auto &buffer_info = element_it.second;
 
-				size_t uniform_buffer_range_limit = device.get_gpu().get_properties().limits.maxUniformBufferRange;
-				size_t storage_buffer_range_limit = device.get_gpu().get_properties().limits.maxStorageBufferRange;
-
-				size_t buffer_range_limit = static_cast<size_t>(buffer_info.range);
-
-				if ((binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) && buffer_range_limit > uniform_buffer_range_limit)
-				{
-					LOGE("Set {} binding {} cannot be updated: buffer size {} exceeds the uniform buffer range limit {}", descriptor_set_layout.get_index(), binding_index, buffer_info.range, uniform_buffer_range_limit);
-					buffer_range_limit = uniform_buffer_range_limit;
-				}
-				else if ((binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) && buffer_range_limit > storage_buffer_range_limit)
-				{
-					LOGE("Set {} binding {} cannot be updated: buffer size {} exceeds the storage buffer range limit {}", descriptor_set_layout.get_index(), binding_index, buffer_info.range, storage_buffer_range_limit);
-					buffer_range_limit = storage_buffer_range_limit;
-				}
-
-				// Clip the buffers range to the limit if one exists as otherwise we will receive a Vulkan validation error
-				buffer_info.range = buffer_range_limit;
+				clamp_buffer_range(binding_index, binding_info->descriptorType, buffer_info);
 
 				VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
 
@@ -149,8 +139,123 @@ void DescriptorSet::prepare()
 	}
 }
 
+bool DescriptorSet::prepare_update_template()
+{
+	if (descriptor_set_layout.get_update_template() == VK_NULL_HANDLE)
+	{
+		return false;
+	}
+
+	// The template writes every descriptor of the layout, so all of them must be provided
+	size_t descriptor_count = 0;
+
+	for (auto &binding_it : buffer_infos)
+	{
+		descriptor_count += binding_it.second.size();
+	}
+
+	for (auto &binding_it : image_infos)
+	{
+		descriptor_count += binding_it.second.size();
+	}
+
+	if (descriptor_count != descriptor_set_layout.get_update_template_element_count())
+	{
+		return false;
+	}
+
+	update_template_data.resize(descriptor_count);
+
+	// Every descriptor has a single place in the data, so the data is complete if all of them are in range
+	for (auto &binding_it : buffer_infos)
+	{
+		auto entry = descriptor_set_layout.get_update_template_entry(binding_it.first);
+
+		if (!entry || !is_buffer_descriptor_type(entry->descriptorType))
+		{
+			update_template_data.clear();
+			return false;
+		}
+
+		for (auto &element_it : binding_it.second)
+		{
+			if (element_it.first >= entry->descriptorCount)
+			{
+				update_template_data.clear();
+				return false;
+			}
+
+			auto &buffer_info = element_it.second;
+
+			clamp_buffer_range(binding_it.first, entry->descriptorType, buffer_info);
+
+			update_template_data[entry->offset / entry->stride + element_it.first].buffer_info = buffer_info;
+		}
+	}
+
+	for (auto &binding_it : image_infos)
+	{
+		auto entry = descriptor_set_layout.get_update_template_entry(binding_it.first);
+
+		if (!entry || is_buffer_descriptor_type(entry->descriptorType))
+		{
+			update_template_data.clear();
+			return false;
+		}
+
+		for (auto &element_it : binding_it.second)
+		{
+			if (element_it.first >= entry->descriptorCount)
+			{
+				update_template_data.clear();
+				return false;
+			}
+
+			update_template_data[entry->offset / entry->stride + element_it.first].image_info = element_it.second;
+		}
+	}
+
+	return true;
+}
+
+void DescriptorSet::clamp_buffer_range(uint32_t binding_index, VkDescriptorType descriptor_type, VkDescriptorBufferInfo &buffer_info) const
+{
+	size_t uniform_buffer_range_limit = device.get_gpu().get_properties().limits.maxUniformBufferRange;
+	size_t storage_buffer_range_limit = device.get_gpu().get_properties().limits.maxStorageBufferRange;
+
+	size_t buffer_range_limit = static_cast<size_t>(buffer_info.range);
+
+	if ((descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) && buffer_range_limit > uniform_buffer_range_limit)
+	{
+		LOGE("Set {} binding {} cannot be updated: buffer size {} exceeds the uniform buffer range limit {}", descriptor_set_layout.get_index(), binding_index, buffer_info.range, uniform_buffer_range_limit);
+		buffer_range_limit = uniform_buffer_range_limit;
+	}
+	else if ((descriptor_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || descriptor_type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) && buffer_range_limit > storage_buffer_range_limit)
+	{
+		LOGE("Set {} binding {} cannot be updated: buffer size {} exceeds the storage buffer range limit {}", descriptor_set_layout.get_index(), binding_index, buffer_info.range, storage_buffer_range_limit);
+		buffer_range_limit = storage_buffer_range_limit;
+	}
+
+	// Clip the buffers range to the limit if one exists as otherwise we will receive a Vulkan validation error
+	buffer_info.range = buffer_range_limit;
+}
+
 void DescriptorSet::update(const std::vector<uint32_t> &bindings_to_update)
 {
+	// The contents of the set only change on reset(), so the template is applied once.
+	// All the bindings are written at once, including update-after-bind ones which do not have to be written yet.
+	if (!update_template_data.empty())
+	{
+		if (!update_template_written)
+		{
+			descriptor_set_layout.update_with_template(handle, update_template_data.data());
+
+			update_template_written = true;
+		}
+
+		return;
+	}
+
 	std::vector<VkWriteDescriptorSet> write_operations;
 	std::vector<size_t>               write_operation_hashes;
 
@@ -216,6 +321,12 @@ void DescriptorSet::update(const std::vector<uint32_t> &bindings_to_update)
 
 void DescriptorSet::apply_writes() const
 {
+	if (!update_template_data.empty())
+	{
+		descriptor_set_layout.update_with_template(handle, update_template_data.data());
+		return;
+	}
+
 	vkUpdateDescriptorSets(device.get_handle(),
 	                       to_u32(write_descriptor_sets.size()),
 	                       write_descriptor_sets.data(),
@@ -231,11 +342,18 @@ DescriptorSet::DescriptorSet(DescriptorSet &&other) :
     image_infos{std::move(other.image_infos)},
     handle{other.handle},
     write_descriptor_sets{std::move(other.write_descriptor_sets)},
-    updated_bindings{std::move(other.updated_bindings)}
+    updated_bindings{std::move(other.updated_bindings)},
+    update_template_data{std::move(other.update_template_data)},
+    update_template_written{other.update_template_written}
 {
 	other.handle = VK_NULL_HANDLE;
 }
 
+DescriptorPool &DescriptorSet::get_descriptor_pool()
+{
+	return descriptor_pool;
+}
+
 VkDescriptorSet DescriptorSet::get_handle() const
 {
 	return handle;
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -19,11 +19,11 @@
 
 #include "common/helpers.h"
 #include "common/vk_common.h"
+#include "core/descriptor_set_layout.h"
 
 namespace vkb
 {
 class Device;
-class DescriptorSetLayout;
 class DescriptorPool;
 
 /**
@@ -31,6 +31,8 @@ class DescriptorPool;
  *        Destroying the handle has no effect, as the pool manages the lifecycle of its descriptor sets.
  *
  *        Keeps track of what bindings were written to prevent a double write.
+ *        If the layout has an update template and all its descriptors are provided, the whole set
+ *        is written in a single call from a contiguous array instead of per-binding write operations.
  */
 class DescriptorSet
 {
@@ -83,6 +85,8 @@ class DescriptorSet
 
 	const DescriptorSetLayout &get_layout() const;
 
+	DescriptorPool &get_descriptor_pool();
+
 	VkDescriptorSet get_handle() const;
 
 	BindingMap<VkDescriptorBufferInfo> &get_buffer_infos();
@@ -97,6 +101,17 @@ class DescriptorSet
 	void prepare();
 
   private:
+	/**
+	 * @brief Prepares the data of the update template of the layout, if the descriptor set provides every descriptor of the layout
+	 * @return False if the descriptor set has to be written with write operations instead
+	 */
+	bool prepare_update_template();
+
+	/**
+	 * @brief Clips the range of a buffer descriptor to the limit of its descriptor type
+	 */
+	void clamp_buffer_range(uint32_t binding_index, VkDescriptorType descriptor_type, VkDescriptorBufferInfo &buffer_info) const;
+
 	Device &device;
 
 	const DescriptorSetLayout &descriptor_set_layout;
@@ -115,5 +130,10 @@ class DescriptorSet
 	// The bindings of the write descriptors that have had vkUpdateDescriptorSets since the last call to update().
 	// Each binding number is mapped to a hash of the binding description that it will be updated to.
 	std::unordered_map<uint32_t, size_t> updated_bindings;
+
+	// The descriptors in the order of the update template of the layout, used instead of the write operations if not empty
+	std::vector<DescriptorUpdateTemplateElement> update_template_data;
+
+	bool update_template_written{false};
 };
 }        // namespace vkb
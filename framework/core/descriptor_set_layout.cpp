@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -97,10 +97,12 @@ inline bool validate_flags(const PhysicalDevice &gpu, const std::vector<VkDescri
 DescriptorSetLayout::DescriptorSetLayout(Device &                           device,
                                          const uint32_t                     set_index,
                                          const std::vector<ShaderModule *> &shader_modules,
-                                         const std::vector<ShaderResource> &resource_set) :
+                                         const std::vector<ShaderResource> &resource_set,
+                                         bool                               descriptor_buffer) :
     device{device},
     set_index{set_index},
-    shader_modules{shader_modules}
+    shader_modules{shader_modules},
+    descriptor_buffer{descriptor_buffer}
 {
 	// NOTE: `shader_modules` is passed in mainly for hashing their handles in `request_resource`.
 	//        This way, different pipelines (with different shaders / shader variants) will get
@@ -118,12 +120,23 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 		}
 
 		// Convert from ShaderResourceType to VkDescriptorType.
-		auto descriptor_type = find_descriptor_type(resource.type, resource.mode == ShaderResourceMode::Dynamic);
+		// Descriptor buffers do not support dynamic descriptors, the offset is written in the descriptor instead
+		auto descriptor_type = find_descriptor_type(resource.type, resource.mode == ShaderResourceMode::Dynamic && !descriptor_buffer);
 
-		if (resource.mode == ShaderResourceMode::UpdateAfterBind)
+		if (descriptor_buffer)
+		{
+			// Descriptor buffers can be written at any time and may be partially bound, so they take no binding flags
+			binding_flags.push_back(0);
+		}
+		else if (resource.mode == ShaderResourceMode::UpdateAfterBind)
 		{
 			binding_flags.push_back(VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT);
 		}
+		else if (resource.mode == ShaderResourceMode::Bindless)
+		{
+			// Elements of the array which are not used by the shader do not need to be written
+			binding_flags.push_back(VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT);
+		}
 		else
 		{
 			// When creating a descriptor set layout, if we give a structure to create_info.pNext, each binding needs to have a binding flag
@@ -155,9 +168,15 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	create_info.bindingCount = to_u32(bindings.size());
 	create_info.pBindings    = bindings.data();
 
+	if (descriptor_buffer)
+	{
+		create_info.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
 	// Handle update-after-bind extensions
-	if (std::find_if(resource_set.begin(), resource_set.end(),
-	                 [](const ShaderResource &shader_resource) { return shader_resource.mode == ShaderResourceMode::UpdateAfterBind; }) != resource_set.end())
+	else if (std::find_if(resource_set.begin(), resource_set.end(),
+	                 [](const ShaderResource &shader_resource) { return shader_resource.mode == ShaderResourceMode::UpdateAfterBind ||
+	                                                                    shader_resource.mode == ShaderResourceMode::Bindless; }) != resource_set.end())
 	{
 		// Spec states you can't have ANY dynamic resources if you have one of the bindings set to update-after-bind
 		if (std::find_if(resource_set.begin(), resource_set.end(),
@@ -176,7 +195,10 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 		binding_flags_create_info.pBindingFlags = binding_flags.data();
 
 		create_info.pNext = &binding_flags_create_info;
-		create_info.flags |= std::find(binding_flags.begin(), binding_flags.end(), VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) != binding_flags.end() ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT : 0;
+		create_info.flags |= std::find_if(binding_flags.begin(), binding_flags.end(),
+		                                  [](VkDescriptorBindingFlagsEXT binding_flag) { return binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT; }) != binding_flags.end() ?
+		                         VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT :
+		                         0;
 	}
 
 	// Create the Vulkan descriptor set layout handle
@@ -186,6 +208,103 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	{
 		throw VulkanException{result, "Cannot create DescriptorSetLayout"};
 	}
+
+	if (descriptor_buffer)
+	{
+		// Descriptors are written to buffers directly, where each binding has a fixed offset
+		vkGetDescriptorSetLayoutSizeEXT(device.get_handle(), handle, &descriptor_buffer_size);
+
+		for (auto &binding : bindings)
+		{
+			VkDeviceSize offset{0};
+			vkGetDescriptorSetLayoutBindingOffsetEXT(device.get_handle(), handle, binding.binding, &offset);
+
+			descriptor_buffer_offsets.emplace(binding.binding, offset);
+		}
+	}
+	else
+	{
+		create_update_template();
+	}
+}
+
+void DescriptorSetLayout::create_update_template()
+{
+	if (bindings.empty())
+	{
+		return;
+	}
+
+	// Descriptor update templates are core since Vulkan 1.1, which has to be supported by the device
+	// and requested by the instance. Otherwise they are only available if the extension is enabled.
+	const auto &gpu         = device.get_gpu();
+	uint32_t    api_version = std::min(gpu.get_instance().get_api_version(), gpu.get_properties().apiVersion);
+
+	if (api_version < VK_API_VERSION_1_1)
+	{
+		if (!device.is_enabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME))
+		{
+			return;
+		}
+
+		update_template_khr = true;
+	}
+
+	std::vector<VkDescriptorUpdateTemplateEntry> entries;
+
+	for (auto &binding : bindings)
+	{
+		switch (binding.descriptorType)
+		{
+			case VK_DESCRIPTOR_TYPE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+				break;
+			default:
+				// Other descriptors are not described by buffer or image infos
+				update_template_entries.clear();
+				update_template_element_count = 0;
+				return;
+		}
+
+		VkDescriptorUpdateTemplateEntry entry{};
+
+		entry.dstBinding      = binding.binding;
+		entry.dstArrayElement = 0;
+		entry.descriptorCount = binding.descriptorCount;
+		entry.descriptorType  = binding.descriptorType;
+		entry.offset          = update_template_element_count * sizeof(DescriptorUpdateTemplateElement);
+		entry.stride          = sizeof(DescriptorUpdateTemplateElement);
+
+		entries.push_back(entry);
+		update_template_entries.emplace(binding.binding, entry);
+
+		update_template_element_count += binding.descriptorCount;
+	}
+
+	VkDescriptorUpdateTemplateCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
+
+	create_info.descriptorUpdateEntryCount = to_u32(entries.size());
+	create_info.pDescriptorUpdateEntries   = entries.data();
+	create_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+	create_info.descriptorSetLayout        = handle;
+
+	VkResult result = update_template_khr ?
+	                      vkCreateDescriptorUpdateTemplateKHR(device.get_handle(), &create_info, nullptr, &update_template) :
+	                      vkCreateDescriptorUpdateTemplate(device.get_handle(), &create_info, nullptr, &update_template);
+
+	if (result != VK_SUCCESS)
+	{
+		// Descriptor sets of this layout are written without a template
+		LOGW("Cannot create descriptor update template for set {}", set_index);
+		update_template = VK_NULL_HANDLE;
+	}
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -197,13 +316,33 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     binding_flags{std::move(other.binding_flags)},
     bindings_lookup{std::move(other.bindings_lookup)},
     binding_flags_lookup{std::move(other.binding_flags_lookup)},
-    resources_lookup{std::move(other.resources_lookup)}
+    resources_lookup{std::move(other.resources_lookup)},
+    update_template{other.update_template},
+    update_template_khr{other.update_template_khr},
+    update_template_entries{std::move(other.update_template_entries)},
+    update_template_element_count{other.update_template_element_count},
+    descriptor_buffer{other.descriptor_buffer},
+    descriptor_buffer_size{other.descriptor_buffer_size},
+    descriptor_buffer_offsets{std::move(other.descriptor_buffer_offsets)}
 {
-	other.handle = VK_NULL_HANDLE;
+	other.handle          = VK_NULL_HANDLE;
+	other.update_template = VK_NULL_HANDLE;
 }
 
 DescriptorSetLayout::~DescriptorSetLayout()
 {
+	if (update_template != VK_NULL_HANDLE)
+	{
+		if (update_template_khr)
+		{
+			vkDestroyDescriptorUpdateTemplateKHR(device.get_handle(), update_template, nullptr);
+		}
+		else
+		{
+			vkDestroyDescriptorUpdateTemplate(device.get_handle(), update_template, nullptr);
+		}
+	}
+
 	// Destroy descriptor set layout
 	if (handle != VK_NULL_HANDLE)
 	{
@@ -272,4 +411,60 @@ const std::vector<ShaderModule *> &DescriptorSetLayout::get_shader_modules() con
 	return shader_modules;
 }
 
+VkDescriptorUpdateTemplate DescriptorSetLayout::get_update_template() const
+{
+	return update_template;
+}
+
+const VkDescriptorUpdateTemplateEntry *DescriptorSetLayout::get_update_template_entry(uint32_t binding_index) const
+{
+	auto it = update_template_entries.find(binding_index);
+
+	if (it == update_template_entries.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+uint32_t DescriptorSetLayout::get_update_template_element_count() const
+{
+	return update_template_element_count;
+}
+
+void DescriptorSetLayout::update_with_template(VkDescriptorSet descriptor_set, const void *data) const
+{
+	if (update_template_khr)
+	{
+		vkUpdateDescriptorSetWithTemplateKHR(device.get_handle(), descriptor_set, update_template, data);
+	}
+	else
+	{
+		vkUpdateDescriptorSetWithTemplate(device.get_handle(), descriptor_set, update_template, data);
+	}
+}
+
+bool DescriptorSetLayout::uses_descriptor_buffer() const
+{
+	return descriptor_buffer;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_size() const
+{
+	return descriptor_buffer_size;
+}
+
+VkDeviceSize DescriptorSetLayout::get_descriptor_buffer_offset(uint32_t binding_index) const
+{
+	auto it = descriptor_buffer_offsets.find(binding_index);
+
+	if (it == descriptor_buffer_offsets.end())
+	{
+		throw std::runtime_error("Binding " + std::to_string(binding_index) + " is not in the descriptor buffer layout of set " + std::to_string(set_index));
+	}
+
+	return it->second;
+}
+
 }        // namespace vkb
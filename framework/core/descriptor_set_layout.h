@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -28,6 +28,16 @@ class ShaderModule;
 
 struct ShaderResource;
 
+/**
+ * @brief Element of the data read by the update template of a DescriptorSetLayout, one per descriptor
+ */
+union DescriptorUpdateTemplateElement
+{
+	VkDescriptorBufferInfo buffer_info;
+
+	VkDescriptorImageInfo image_info;
+};
+
 /**
  * @brief Caches DescriptorSet objects for the shader's set index.
  *        Creates a DescriptorPool to allocate the DescriptorSet objects
@@ -41,11 +51,13 @@ class DescriptorSetLayout
 	 * @param set_index The descriptor set index this layout maps to
 	 * @param shader_modules The shader modules this set layout will be used for
 	 * @param resource_set A grouping of shader resources belonging to the same set
+	 * @param descriptor_buffer Whether descriptors are written to descriptor buffers (VK_EXT_descriptor_buffer) instead of descriptor sets
 	 */
 	DescriptorSetLayout(Device &                           device,
 	                    const uint32_t                     set_index,
 	                    const std::vector<ShaderModule *> &shader_modules,
-	                    const std::vector<ShaderResource> &resource_set);
+	                    const std::vector<ShaderResource> &resource_set,
+	                    bool                               descriptor_buffer = false);
 
 	DescriptorSetLayout(const DescriptorSetLayout &) = delete;
 
@@ -73,7 +85,48 @@ class DescriptorSetLayout
 
 	const std::vector<ShaderModule *> &get_shader_modules() const;
 
+	/**
+	 * @brief Returns a template writing all the descriptors of the layout in a single call, or VK_NULL_HANDLE if the layout cannot use one
+	 *        The template reads a contiguous array of DescriptorUpdateTemplateElement, binding after binding.
+	 */
+	VkDescriptorUpdateTemplate get_update_template() const;
+
+	/**
+	 * @brief Returns the entry of the update template describing a binding, or nullptr if the binding is not in the layout
+	 *        The offset of the entry, divided by its stride, is the index of the first element of the binding.
+	 */
+	const VkDescriptorUpdateTemplateEntry *get_update_template_entry(uint32_t binding_index) const;
+
+	/**
+	 * @brief Returns the number of elements read by the update template, that is the number of descriptors of the layout
+	 */
+	uint32_t get_update_template_element_count() const;
+
+	/**
+	 * @brief Writes all the descriptors of a set with the update template
+	 * @param descriptor_set The set to write, allocated with this layout
+	 * @param data The contiguous array of DescriptorUpdateTemplateElement read by the template
+	 */
+	void update_with_template(VkDescriptorSet descriptor_set, const void *data) const;
+
+	/**
+	 * @brief Returns whether the layout was created for descriptor buffers, in which case it cannot be used to allocate descriptor sets
+	 */
+	bool uses_descriptor_buffer() const;
+
+	/**
+	 * @brief Returns the size of the descriptors of a set in a descriptor buffer, or 0 if the layout is not for descriptor buffers
+	 */
+	VkDeviceSize get_descriptor_buffer_size() const;
+
+	/**
+	 * @brief Returns the offset of the first descriptor of a binding, from the start of the set in a descriptor buffer
+	 */
+	VkDeviceSize get_descriptor_buffer_offset(uint32_t binding_index) const;
+
   private:
+	void create_update_template();
+
 	Device &device;
 
 	VkDescriptorSetLayout handle{VK_NULL_HANDLE};
@@ -91,5 +144,20 @@ class DescriptorSetLayout
 	std::unordered_map<std::string, uint32_t> resources_lookup;
 
 	std::vector<ShaderModule *> shader_modules;
+
+	VkDescriptorUpdateTemplate update_template{VK_NULL_HANDLE};
+
+	// Whether the template comes from VK_KHR_descriptor_update_template, on Vulkan 1.0 devices
+	bool update_template_khr{false};
+
+	std::unordered_map<uint32_t, VkDescriptorUpdateTemplateEntry> update_template_entries;
+
+	uint32_t update_template_element_count{0};
+
+	bool descriptor_buffer{false};
+
+	VkDeviceSize descriptor_buffer_size{0};
+
+	std::unordered_map<uint32_t, VkDeviceSize> descriptor_buffer_offsets;
 };
 }        // namespace vkb
@@ -571,4 +571,9 @@ ResourceCache &Device::get_resource_cache()
 {
 	return resource_cache;
 }
+
+const ResourceCache &Device::get_resource_cache() const
+{
+	return resource_cache;
+}
 }        // namespace vkb
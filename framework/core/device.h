@@ -212,6 +212,8 @@ class Device : public core::VulkanResource<VkDevice>
 
 	ResourceCache &get_resource_cache();
 
+	const ResourceCache &get_resource_cache() const;
+
   private:
 	const PhysicalDevice &gpu;
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2024, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -569,11 +569,17 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 	{
 		resource_binding_state.clear_dirty();
 
+		auto &resource_sets = resource_binding_state.get_resource_sets();
+
 		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+		for (uint32_t descriptor_set_id = 0; descriptor_set_id < to_u32(resource_sets.size()); ++descriptor_set_id)
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			auto &resource_set = resource_sets[descriptor_set_id];
+
+			if (resource_set.empty())
+			{
+				continue;
+			}
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
 			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
@@ -600,76 +606,85 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 
 			std::vector<uint32_t> dynamic_offsets;
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
+			// Layout binding of the current binding, looked up once for all its array elements
+			std::unique_ptr<vk::DescriptorSetLayoutBinding> binding_info;
+
+			auto check_bindings_to_update = [&]() {
+				assert((!update_after_bind || !binding_info ||
+				        (buffer_infos.count(binding_info->binding) > 0 || (image_infos.count(binding_info->binding) > 0))) &&
+				       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+			};
+
+			// Iterate over all resources, which are sorted by binding and array element
+			for (auto &resource_info : resource_set)
 			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+				auto binding_index = resource_info.binding;
+				auto array_element = resource_info.array_element;
+
+				if (&resource_info == resource_set.begin() || binding_index != (&resource_info - 1)->binding)
+				{
+					check_bindings_to_update();
+
+					binding_info = descriptor_set_layout.get_layout_binding(binding_index);
+				}
 
 				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+				if (!binding_info)
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
-					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+					continue;
+				}
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+				// Pointer references
+				auto &buffer     = resource_info.buffer;
+				auto &sampler    = resource_info.sampler;
+				auto &image_view = resource_info.image_view;
 
-						// Get buffer info
-						if (buffer != nullptr && vkb::common::is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							vk::DescriptorBufferInfo buffer_info(resource_info.buffer->get_handle(), resource_info.offset, resource_info.range);
+				// Get buffer info
+				if (buffer != nullptr && vkb::common::is_buffer_descriptor_type(binding_info->descriptorType))
+				{
+					vk::DescriptorBufferInfo buffer_info(resource_info.buffer->get_handle(), resource_info.offset, resource_info.range);
 
-							if (vkb::common::is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
-								buffer_info.offset = 0;
-							}
+					if (vkb::common::is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						dynamic_offsets.push_back(to_u32(buffer_info.offset));
+						buffer_info.offset = 0;
+					}
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+					buffer_infos[binding_index][array_element] = buffer_info;
+				}
+
+				// Get image info
+				else if (image_view != nullptr || sampler != nullptr)
+				{
+					// Can be null for input attachments
+					vk::DescriptorImageInfo image_info(sampler ? sampler->get_handle() : nullptr, image_view->get_handle());
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+					if (image_view != nullptr)
+					{
+						// Add image layout info based on descriptor type
+						switch (binding_info->descriptorType)
 						{
-							// Can be null for input attachments
-							vk::DescriptorImageInfo image_info(sampler ? sampler->get_handle() : nullptr, image_view->get_handle());
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
-								{
-									case vk::DescriptorType::eCombinedImageSampler:
-										image_info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-										break;
-									case vk::DescriptorType::eInputAttachment:
-										image_info.imageLayout =
-										    vkb::common::is_depth_format(image_view->get_format()) ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eShaderReadOnlyOptimal;
-										break;
-									case vk::DescriptorType::eStorageImage:
-										image_info.imageLayout = vk::ImageLayout::eGeneral;
-										break;
-									default:
-										continue;
-								}
-							}
-
-							image_infos[binding_index][array_element] = image_info;
+							case vk::DescriptorType::eCombinedImageSampler:
+								image_info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+								break;
+							case vk::DescriptorType::eInputAttachment:
+								image_info.imageLayout =
+								    vkb::common::is_depth_format(image_view->get_format()) ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eShaderReadOnlyOptimal;
+								break;
+							case vk::DescriptorType::eStorageImage:
+								image_info.imageLayout = vk::ImageLayout::eGeneral;
+								break;
+							default:
+								continue;
 						}
 					}
 
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+					image_infos[binding_index][array_element] = image_info;
 				}
 			}
 
+			check_bindings_to_update();
+
 			vk::DescriptorSet descriptor_set_handle = command_pool.get_render_frame()->request_descriptor_set(
 			    descriptor_set_layout, buffer_infos, image_infos, update_after_bind, command_pool.get_thread_index());
 
@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2024, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -53,7 +53,9 @@ enum class HPPShaderResourceMode
 {
 	Static,
 	Dynamic,
-	UpdateAfterBind
+	UpdateAfterBind,
+	// Update-after-bind array which does not need all of its elements to be written, used to index resources in shaders
+	Bindless
 };
 
 /// Store shader resource data.
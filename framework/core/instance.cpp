@@ -187,7 +187,8 @@ Instance::Instance(const std::string                            &application_nam
                    const std::unordered_map<const char *, bool> &required_extensions,
                    const std::vector<const char *>              &required_validation_layers,
                    bool                                          headless,
-                   uint32_t                                      api_version)
+                   uint32_t                                      api_version) :
+    api_version{api_version}
 {
 	uint32_t instance_extension_count;
 	VK_CHECK(vkEnumerateInstanceExtensionProperties(nullptr, &instance_extension_count, nullptr));
@@ -527,6 +528,11 @@ VkInstance Instance::get_handle() const
 	return handle;
 }
 
+uint32_t Instance::get_api_version() const
+{
+	return api_version;
+}
+
 const std::vector<const char *> &Instance::get_extensions()
 {
 	return enabled_extensions;
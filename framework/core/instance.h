@@ -102,6 +102,11 @@ class Instance
 
 	VkInstance get_handle() const;
 
+	/**
+	 * @brief Returns the Vulkan API version requested when creating the instance
+	 */
+	uint32_t get_api_version() const;
+
 	const std::vector<const char *> &get_extensions();
 
 	/**
@@ -124,6 +129,11 @@ class Instance
 	 */
 	VkInstance handle{VK_NULL_HANDLE};
 
+	/**
+	 * @brief The requested API version, unknown for an instance created externally
+	 */
+	uint32_t api_version{VK_API_VERSION_1_0};
+
 	/**
 	 * @brief The enabled extensions
 	 */
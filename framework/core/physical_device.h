@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -128,6 +128,19 @@ class PhysicalDevice
 		return *extension_ptr;
 	}
 
+	/**
+	 * @brief Returns the features of an extension requested to be enabled in the logical device
+	 * @param type The VkStructureType of the extension feature struct
+	 * @returns The extension feature struct, or nullptr if it was never requested
+	 */
+	template <typename T>
+	const T *get_extension_features(VkStructureType type) const
+	{
+		auto extension_features_it = extension_features.find(type);
+
+		return extension_features_it != extension_features.end() ? static_cast<const T *>(extension_features_it->second.get()) : nullptr;
+	}
+
 	/**
 	 * @brief Sets whether or not the first graphics queue should have higher priority than other queues.
 	 * Very specific feature which is used by async compute samples.
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -112,6 +112,11 @@ ComputePipeline::ComputePipeline(Device &        device,
 	create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
 	create_info.stage  = stage;
 
+	if (pipeline_state.get_pipeline_layout().uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
 	result = vkCreateComputePipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
 
 	if (result != VK_SUCCESS)
@@ -127,6 +132,69 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
                                    PipelineState & pipeline_state) :
     Pipeline{device}
 {
+	create_pipeline(pipeline_cache, pipeline_state, graphics_pipeline_library_all_parts, false);
+}
+
+GraphicsPipeline::GraphicsPipeline(Device &                          device,
+                                   VkPipelineCache                   pipeline_cache,
+                                   PipelineState &                   pipeline_state,
+                                   VkGraphicsPipelineLibraryFlagsEXT library_parts) :
+    Pipeline{device}
+{
+	create_pipeline(pipeline_cache, pipeline_state, library_parts, true);
+}
+
+GraphicsPipeline::GraphicsPipeline(Device &                                     device,
+                                   VkPipelineCache                              pipeline_cache,
+                                   PipelineState &                              pipeline_state,
+                                   const std::vector<const GraphicsPipeline *> &libraries) :
+    Pipeline{device}
+{
+	std::vector<VkPipeline> library_handles;
+
+	for (auto library : libraries)
+	{
+		library_handles.push_back(library->get_handle());
+	}
+
+	VkPipelineLibraryCreateInfoKHR library_info{VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR};
+
+	library_info.libraryCount = to_u32(library_handles.size());
+	library_info.pLibraries   = library_handles.data();
+
+	// Without VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT the libraries are only linked, which is fast
+	VkGraphicsPipelineCreateInfo create_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+
+	create_info.pNext      = &library_info;
+	create_info.layout     = pipeline_state.get_pipeline_layout().get_handle();
+	create_info.renderPass = pipeline_state.get_render_pass()->get_handle();
+	create_info.subpass    = pipeline_state.get_subpass_index();
+
+	if (pipeline_state.get_pipeline_layout().uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
+	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot link GraphicsPipelines"};
+	}
+
+	state = pipeline_state;
+}
+
+void GraphicsPipeline::create_pipeline(VkPipelineCache                   pipeline_cache,
+                                       PipelineState &                   pipeline_state,
+                                       VkGraphicsPipelineLibraryFlagsEXT parts,
+                                       bool                              library)
+{
+	bool vertex_input_part    = parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+	bool pre_rasterization    = parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+	bool fragment_shader_part = parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+	bool fragment_output_part = parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
 	std::vector<VkShaderModule> shader_modules;
 
 	std::vector<VkPipelineShaderStageCreateInfo> stage_create_infos;
@@ -151,6 +219,14 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 
 	for (const ShaderModule *shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
 	{
+		// Only compile the stages which belong to the requested parts
+		bool fragment_stage = shader_module->get_stage() == VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		if (fragment_stage ? !fragment_shader_part : !pre_rasterization)
+		{
+			continue;
+		}
+
 		VkPipelineShaderStageCreateInfo stage_create_info{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
 
 		stage_create_info.stage = shader_module->get_stage();
@@ -165,6 +241,11 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 		VkResult result = vkCreateShaderModule(device.get_handle(), &vk_create_info, nullptr, &stage_create_info.module);
 		if (result != VK_SUCCESS)
 		{
+			for (auto shader_module : shader_modules)
+			{
+				vkDestroyShaderModule(device.get_handle(), shader_module, nullptr);
+			}
+
 			throw VulkanException{result};
 		}
 
@@ -182,7 +263,6 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 
 	create_info.stageCount = to_u32(stage_create_infos.size());
 	create_info.pStages    = stage_create_infos.data();
-
 	VkPipelineVertexInputStateCreateInfo vertex_input_state{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
 
 	vertex_input_state.pVertexAttributeDescriptions    = pipeline_state.get_vertex_input_state().attributes.data();
@@ -276,31 +356,71 @@ GraphicsPipeline::GraphicsPipeline(Device &        device,
 	dynamic_state.pDynamicStates    = dynamic_states.data();
 	dynamic_state.dynamicStateCount = to_u32(dynamic_states.size());
 
-	create_info.pVertexInputState   = &vertex_input_state;
-	create_info.pInputAssemblyState = &input_assembly_state;
-	create_info.pViewportState      = &viewport_state;
-	create_info.pRasterizationState = &rasterization_state;
-	create_info.pMultisampleState   = &multisample_state;
-	create_info.pDepthStencilState  = &depth_stencil_state;
-	create_info.pColorBlendState    = &color_blend_state;
-	create_info.pDynamicState       = &dynamic_state;
+	if (vertex_input_part)
+	{
+		create_info.pVertexInputState   = &vertex_input_state;
+		create_info.pInputAssemblyState = &input_assembly_state;
+	}
+
+	if (pre_rasterization)
+	{
+		create_info.pViewportState      = &viewport_state;
+		create_info.pRasterizationState = &rasterization_state;
+	}
+
+	if (fragment_shader_part)
+	{
+		create_info.pDepthStencilState = &depth_stencil_state;
+	}
+
+	if (fragment_shader_part || fragment_output_part)
+	{
+		create_info.pMultisampleState = &multisample_state;
+	}
+
+	if (fragment_output_part)
+	{
+		create_info.pColorBlendState = &color_blend_state;
+	}
+
+	create_info.pDynamicState = &dynamic_state;
+
+	if (pre_rasterization || fragment_shader_part)
+	{
+		create_info.layout = pipeline_state.get_pipeline_layout().get_handle();
+	}
 
-	create_info.layout     = pipeline_state.get_pipeline_layout().get_handle();
 	create_info.renderPass = pipeline_state.get_render_pass()->get_handle();
 	create_info.subpass    = pipeline_state.get_subpass_index();
 
-	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
+	VkGraphicsPipelineLibraryCreateInfoEXT library_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT};
 
-	if (result != VK_SUCCESS)
+	if (library)
 	{
-		throw VulkanException{result, "Cannot create GraphicsPipelines"};
+		library_info.flags = parts;
+
+		create_info.pNext = &library_info;
+		create_info.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
 	}
 
+	// Libraries and the pipelines linked from them must all use descriptor buffers, or none of them
+	if (pipeline_state.get_pipeline_layout().uses_descriptor_buffers())
+	{
+		create_info.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+	}
+
+	auto result = vkCreateGraphicsPipelines(device.get_handle(), pipeline_cache, 1, &create_info, nullptr, &handle);
+
 	for (auto shader_module : shader_modules)
 	{
 		vkDestroyShaderModule(device.get_handle(), shader_module, nullptr);
 	}
 
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create GraphicsPipelines"};
+	}
+
 	state = pipeline_state;
 }
 }        // namespace vkb
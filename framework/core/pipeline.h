@@ -1,4 +1,4 @@
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -64,6 +64,13 @@ class ComputePipeline : public Pipeline
 	                PipelineState & pipeline_state);
 };
 
+/// All the parts of a graphics pipeline, as split by VK_EXT_graphics_pipeline_library
+constexpr VkGraphicsPipelineLibraryFlagsEXT graphics_pipeline_library_all_parts =
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT |
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT |
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
 class GraphicsPipeline : public Pipeline
 {
   public:
@@ -71,8 +78,37 @@ class GraphicsPipeline : public Pipeline
 
 	virtual ~GraphicsPipeline() = default;
 
+	/**
+	 * @brief Creates a complete pipeline from the full pipeline state
+	 */
 	GraphicsPipeline(Device &        device,
 	                 VkPipelineCache pipeline_cache,
 	                 PipelineState & pipeline_state);
+
+	/**
+	 * @brief Creates a graphics pipeline library (VK_EXT_graphics_pipeline_library)
+	 *        Only the part of the pipeline state used by the given library parts is compiled.
+	 * @param library_parts The parts of the pipeline the library contains
+	 */
+	GraphicsPipeline(Device &                          device,
+	                 VkPipelineCache                   pipeline_cache,
+	                 PipelineState &                   pipeline_state,
+	                 VkGraphicsPipelineLibraryFlagsEXT library_parts);
+
+	/**
+	 * @brief Creates a complete pipeline by linking graphics pipeline libraries, without link time optimization
+	 *        The libraries can be destroyed once the pipeline is created.
+	 * @param libraries Libraries covering all the parts of the pipeline, created from compatible pipeline states
+	 */
+	GraphicsPipeline(Device &                                     device,
+	                 VkPipelineCache                              pipeline_cache,
+	                 PipelineState &                              pipeline_state,
+	                 const std::vector<const GraphicsPipeline *> &libraries);
+
+  private:
+	void create_pipeline(VkPipelineCache                   pipeline_cache,
+	                     PipelineState &                   pipeline_state,
+	                     VkGraphicsPipelineLibraryFlagsEXT parts,
+	                     bool                              library);
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -206,4 +206,10 @@ VkShaderStageFlags PipelineLayout::get_push_constant_range_stage(uint32_t size,
 	}
 	return stages;
 }
+
+bool PipelineLayout::uses_descriptor_buffers() const
+{
+	return std::any_of(descriptor_set_layouts.begin(), descriptor_set_layouts.end(),
+	                   [](const DescriptorSetLayout *descriptor_set_layout) { return descriptor_set_layout->uses_descriptor_buffer(); });
+}
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -57,6 +57,12 @@ class PipelineLayout
 
 	VkShaderStageFlags get_push_constant_range_stage(uint32_t size, uint32_t offset = 0) const;
 
+	/**
+	 * @brief Returns whether the descriptor set layouts were created for descriptor buffers
+	 *        Pipelines created with this layout must then use descriptor buffers too.
+	 */
+	bool uses_descriptor_buffers() const;
+
   private:
 	Device &device;
 
@@ -464,6 +464,7 @@ void RenderPass::create_renderpass(const std::vector<Attachment> &attachments, c
 
 RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses) :
     VulkanResource{VK_NULL_HANDLE, &device},
+    id{hash_render_pass(attachments, load_store_infos, subpasses)},
     subpass_count{std::max<size_t>(1, subpasses.size())},        // At least 1 subpass
     color_output_count{}
 {
@@ -479,6 +480,7 @@ RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachment
 
 RenderPass::RenderPass(RenderPass &&other) :
     VulkanResource{std::move(other)},
+    id{other.id},
     subpass_count{other.subpass_count},
     color_output_count{other.color_output_count}
 {
@@ -506,4 +508,32 @@ const VkExtent2D RenderPass::get_render_area_granularity() const
 
 	return render_area_granularity;
 }
+
+uint64_t RenderPass::get_id() const
+{
+	return id;
+}
+
+uint64_t hash_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
+{
+	StableHasher hasher;
+
+	// Attachment and LoadStoreInfo only contain 32-bit members, so they have no padding
+	hasher.update(attachments);
+	hasher.update(load_store_infos);
+
+	hasher.update(static_cast<uint64_t>(subpasses.size()));
+
+	for (auto &subpass : subpasses)
+	{
+		hasher.update(subpass.input_attachments);
+		hasher.update(subpass.output_attachments);
+		hasher.update(subpass.color_resolve_attachments);
+		hasher.update(static_cast<uint32_t>(subpass.disable_depth_stencil_attachment));
+		hasher.update(subpass.depth_stencil_resolve_attachment);
+		hasher.update(subpass.depth_stencil_resolve_mode);
+	}
+
+	return hasher.result();
+}
 }        // namespace vkb
@@ -43,6 +43,11 @@ struct SubpassInfo
 	std::string debug_name;
 };
 
+/**
+ * @brief Computes a hash of a render pass description, which is stable across runs
+ */
+uint64_t hash_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses);
+
 class RenderPass : public core::VulkanResource<VkRenderPass>
 {
   public:
@@ -65,7 +70,14 @@ class RenderPass : public core::VulkanResource<VkRenderPass>
 
 	const VkExtent2D get_render_area_granularity() const;
 
+	/**
+	 * @brief Returns a hash of the description the render pass was created from, which is stable across runs
+	 */
+	uint64_t get_id() const;
+
   private:
+	uint64_t id;
+
 	size_t subpass_count;
 
 	template <typename T_SubpassDescription, typename T_AttachmentDescription, typename T_AttachmentReference, typename T_SubpassDependency, typename T_RenderPassCreateInfo>
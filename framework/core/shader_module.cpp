@@ -120,10 +120,8 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
 	}
 
-	// Generate a unique id, determined by source and variant
-	std::hash<std::string> hasher{};
-	id = hasher(std::string{reinterpret_cast<const char *>(spirv.data()),
-	                        reinterpret_cast<const char *>(spirv.data() + spirv.size())});
+	// Generate a unique id, determined by source and variant, which is stable across runs
+	id = static_cast<size_t>(hash64(spirv.data(), spirv.size() * sizeof(uint32_t)));
 }
 
 ShaderModule::ShaderModule(ShaderModule &&other) :
@@ -286,16 +284,14 @@ void ShaderVariant::clear()
 
 void ShaderVariant::update_id()
 {
-	std::hash<std::string> hasher{};
-	id = hasher(preamble);
+	id = static_cast<size_t>(hash64(preamble.data(), preamble.size()));
 }
 
 ShaderSource::ShaderSource(const std::string &filename) :
     filename{filename},
     source{fs::read_shader(filename)}
 {
-	std::hash<std::string> hasher{};
-	id = hasher(std::string{this->source.cbegin(), this->source.cend()});
+	id = static_cast<size_t>(hash64(this->source.data(), this->source.size()));
 }
 
 size_t ShaderSource::get_id() const
@@ -311,8 +307,7 @@ const std::string &ShaderSource::get_filename() const
 void ShaderSource::set_source(const std::string &source_)
 {
 	source = source_;
-	std::hash<std::string> hasher{};
-	id = hasher(std::string{this->source.cbegin(), this->source.cend()});
+	id = static_cast<size_t>(hash64(this->source.data(), this->source.size()));
 }
 
 const std::string &ShaderSource::get_source() const
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -50,7 +50,9 @@ enum class ShaderResourceMode
 {
 	Static,
 	Dynamic,
-	UpdateAfterBind
+	UpdateAfterBind,
+	// Update-after-bind array which does not need all of its elements to be written, used to index resources in shaders
+	Bindless
 };
 
 /// A bitmask of qualifiers applied to a resource
@@ -1,4 +1,5 @@
 /* Copyright (c) 2019, Sascha Willems
+ * Copyright (c) 2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -69,6 +70,17 @@ bool Frustum::check_sphere(glm::vec3 pos, float radius)
 	}
 	return true;
 }
+
+FrustumPlanes Frustum::get_culling_planes() const
+{
+	FrustumPlanes result;
+	for (size_t i = 0; i < planes.size(); i++)
+	{
+		result[i] = {planes[i].x, planes[i].y, planes[i].z, planes[i].w};
+	}
+	return result;
+}
+
 const std::array<glm::vec4, 6> &Frustum::get_planes() const
 {
 	return planes;
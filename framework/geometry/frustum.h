@@ -1,4 +1,5 @@
 /* Copyright (c) 2019-2022, Sascha Willems
+ * Copyright (c) 2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,6 +21,7 @@
 #include <array>
 
 #include "common/error.h"
+#include "core/util/frustum_culling.hpp"
 
 VKBP_DISABLE_WARNINGS()
 #include "common/glm_common.h"
@@ -57,6 +59,11 @@ class Frustum
 	 */
 	bool check_sphere(glm::vec3 pos, float radius);
 
+	/**
+	 * @brief Returns the planes in the layout of the batch culling functions, see core/util/frustum_culling.hpp
+	 */
+	FrustumPlanes get_culling_planes() const;
+
 	const std::array<glm::vec4, 6> &get_planes() const;
 
   private:
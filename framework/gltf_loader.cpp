@@ -19,7 +19,12 @@
 #define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
 #include <limits>
+#include <numeric>
 #include <queue>
 
 #include "common/error.h"
@@ -44,6 +49,7 @@ VKBP_ENABLE_WARNINGS()
 #include "scene_graph/components/pbr_material.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "scene_graph/components/sampler.h"
+#include "scene_graph/components/skin.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/components/transform.h"
@@ -149,6 +155,140 @@ inline size_t get_attribute_stride(const tinygltf::Model *model, uint32_t access
 	return accessor.ByteStride(bufferView);
 };
 
+/**
+ * @brief Reads the components of an accessor as floats, normalized integers are converted to [0, 1]
+ */
+inline std::vector<float> get_attribute_floats(const tinygltf::Model *model, uint32_t accessorId)
+{
+	assert(accessorId < model->accessors.size());
+	auto &accessor = model->accessors[accessorId];
+
+	auto   data            = get_attribute_data(model, accessorId);
+	size_t stride          = get_attribute_stride(model, accessorId);
+	size_t component_count = tinygltf::GetNumComponentsInType(accessor.type);
+	size_t component_size  = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+
+	std::vector<float> result(accessor.count * component_count);
+
+	for (size_t i = 0; i < accessor.count; ++i)
+	{
+		for (size_t c = 0; c < component_count; ++c)
+		{
+			const uint8_t *component = data.data() + i * stride + c * component_size;
+
+			switch (accessor.componentType)
+			{
+				case TINYGLTF_COMPONENT_TYPE_FLOAT:
+					std::memcpy(&result[i * component_count + c], component, sizeof(float));
+					break;
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+					result[i * component_count + c] = *component / 255.0f;
+					break;
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+				{
+					uint16_t value;
+					std::memcpy(&value, component, sizeof(value));
+					result[i * component_count + c] = value / 65535.0f;
+					break;
+				}
+				default:
+					LOGW("Gltf accessor #{} has unsupported component type for float data", accessorId);
+					return {};
+			}
+		}
+	}
+
+	return result;
+};
+
+/**
+ * @brief Reads the components of an accessor of unsigned integers as 16-bit integers
+ */
+inline std::vector<uint16_t> get_attribute_uint16s(const tinygltf::Model *model, uint32_t accessorId)
+{
+	assert(accessorId < model->accessors.size());
+	auto &accessor = model->accessors[accessorId];
+
+	auto   data            = get_attribute_data(model, accessorId);
+	size_t stride          = get_attribute_stride(model, accessorId);
+	size_t component_count = tinygltf::GetNumComponentsInType(accessor.type);
+	size_t component_size  = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+
+	std::vector<uint16_t> result(accessor.count * component_count);
+
+	for (size_t i = 0; i < accessor.count; ++i)
+	{
+		for (size_t c = 0; c < component_count; ++c)
+		{
+			const uint8_t *component = data.data() + i * stride + c * component_size;
+
+			switch (accessor.componentType)
+			{
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+					result[i * component_count + c] = *component;
+					break;
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+					std::memcpy(&result[i * component_count + c], component, sizeof(uint16_t));
+					break;
+				default:
+					LOGW("Gltf accessor #{} has unsupported component type for 16-bit integer data", accessorId);
+					return {};
+			}
+		}
+	}
+
+	return result;
+};
+
+/**
+ * @brief Loads the bind pose of a primitive with joints and weights, for skinning
+ * @return The vertex data, or nullptr if the primitive is not skinned
+ */
+inline std::unique_ptr<sg::SkinnedVertexData> load_skinned_vertices(const tinygltf::Model *model, const tinygltf::Primitive &primitive)
+{
+	auto position_it = primitive.attributes.find("POSITION");
+	auto normal_it   = primitive.attributes.find("NORMAL");
+	auto joints_it   = primitive.attributes.find("JOINTS_0");
+	auto weights_it  = primitive.attributes.find("WEIGHTS_0");
+
+	if (position_it == primitive.attributes.end() || joints_it == primitive.attributes.end() || weights_it == primitive.attributes.end())
+	{
+		return nullptr;
+	}
+
+	auto skinned_vertices = std::make_unique<sg::SkinnedVertexData>();
+
+	skinned_vertices->positions = get_attribute_floats(model, position_it->second);
+	skinned_vertices->joints    = get_attribute_uint16s(model, joints_it->second);
+	skinned_vertices->weights   = get_attribute_floats(model, weights_it->second);
+
+	if (normal_it != primitive.attributes.end())
+	{
+		skinned_vertices->normals = get_attribute_floats(model, normal_it->second);
+	}
+
+	size_t vertex_count = model->accessors[position_it->second].count;
+
+	if (skinned_vertices->positions.size() != vertex_count * 3 ||
+	    skinned_vertices->joints.size() != vertex_count * 4 ||
+	    skinned_vertices->weights.size() != vertex_count * 4 ||
+	    (!skinned_vertices->normals.empty() && skinned_vertices->normals.size() != vertex_count * 3))
+	{
+		LOGW("Gltf primitive has invalid skinning attributes, it is not skinned");
+		return nullptr;
+	}
+
+	return skinned_vertices;
+};
+
+template <class T>
+inline std::vector<uint8_t> to_bytes(const std::vector<T> &values)
+{
+	auto data = reinterpret_cast<const uint8_t *>(values.data());
+
+	return {data, data + values.size() * sizeof(T)};
+};
+
 inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
@@ -563,15 +703,68 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		image_component_futures.push_back(std::move(fut));
 	}
 
-	std::vector<std::unique_ptr<sg::Image>> image_components;
+	// Primitives only read the model and fill their own buffers, so they are loaded by the pool
+	// once it is done with the images, while the images are uploaded
+	std::vector<std::vector<std::future<std::unique_ptr<sg::SubMesh>>>> submesh_futures(model.meshes.size());
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
+	{
+		for (size_t primitive_index = 0; primitive_index < model.meshes[mesh_index].primitives.size(); primitive_index++)
+		{
+			submesh_futures[mesh_index].push_back(thread_pool.push(
+			    [this, mesh_index, primitive_index](size_t) {
+				    return load_primitive(model.meshes[mesh_index], primitive_index);
+			    }));
+		}
+	}
+
+	std::vector<std::unique_ptr<sg::Image>> image_components(image_count);
+
+	// Images are staged in the order they finish loading, rather than in the order of the file
+	std::vector<size_t> pending_images(image_count);
+	std::iota(pending_images.begin(), pending_images.end(), size_t{0});
+
+	auto take_loaded_image = [&]() {
+		auto it = std::find_if(pending_images.begin(), pending_images.end(), [&](size_t index) {
+			return image_component_futures[index].wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		});
+
+		// If no image is ready yet, wait for the first one of the file
+		if (it == pending_images.end())
+		{
+			it = pending_images.begin();
+		}
+
+		size_t index = *it;
+		pending_images.erase(it);
+
+		image_components[index] = image_component_futures[index].get();
+
+		return index;
+	};
+
+	struct UploadBatch
+	{
+		VkFence fence{VK_NULL_HANDLE};
+
+		std::vector<core::Buffer> staging_buffers;
+	};
 
 	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
 	// double the amount of memory (all the images and all the corresponding buffers).
 	// This helps keep memory footprint lower which is helpful on smaller devices.
-	size_t image_index = 0;
-	while (image_index < image_count)
+	// Batches are submitted without waiting for the GPU, so that the copies overlap with the
+	// loading and staging of the next images. Only once too many batches are in flight is the
+	// oldest one waited for, and its staging buffers released.
+	const size_t max_batches_in_flight = 2;
+
+	std::deque<UploadBatch> upload_batches;
+
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	size_t staged_count = 0;
+	while (staged_count < image_count)
 	{
-		std::vector<core::Buffer> transient_buffers;
+		UploadBatch batch;
 
 		auto &command_buffer = device.request_command_buffer();
 
@@ -580,12 +773,9 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		size_t batch_size = 0;
 
 		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
+		while (staged_count < image_count && batch_size < 64 * 1024 * 1024)
 		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
-
-			auto &image = image_components[image_index];
+			auto &image = image_components[take_loaded_image()];
 
 			core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, image->get_data());
 
@@ -593,31 +783,33 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 			upload_image_to_gpu(command_buffer, stage_buffer, *image);
 
-			transient_buffers.push_back(std::move(stage_buffer));
+			batch.staging_buffers.push_back(std::move(stage_buffer));
 
-			image_index++;
+			staged_count++;
 		}
 
 		command_buffer.end();
 
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+		if (upload_batches.size() >= max_batches_in_flight)
+		{
+			auto &oldest_batch = upload_batches.front();
+			VK_CHECK(vkWaitForFences(device.get_handle(), 1, &oldest_batch.fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+
+			upload_batches.pop_front();
+		}
 
-		queue.submit(command_buffer, device.request_fence());
+		batch.fence = device.request_fence();
 
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
+		queue.submit(command_buffer, batch.fence);
 
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+		upload_batches.push_back(std::move(batch));
 	}
 
 	scene.set_components(std::move(image_components));
 
 	auto elapsed_time = timer.stop();
 
-	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
+	LOGI("Time spent loading and submitting images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
 
 	// Load textures
 	auto images          = scene.get_components<sg::Image>();
@@ -703,89 +895,20 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	auto default_material = create_default_material();
 
-	// Load meshes
+	// Load meshes, from the primitives loaded by the thread pool
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
-	for (auto &gltf_mesh : model.meshes)
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); ++mesh_index)
 	{
+		auto &gltf_mesh = model.meshes[mesh_index];
+
 		auto mesh = parse_mesh(gltf_mesh);
 
 		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
 		{
 			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
 
-			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
-			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
-
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
-
-				auto vertex_data = get_attribute_data(&model, attribute.second);
-
-				if (attrib_name == "position")
-				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
-
-				core::Buffer buffer{device,
-				                    vertex_data.size(),
-				                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-				                    VMA_MEMORY_USAGE_CPU_TO_GPU};
-				buffer.update(vertex_data);
-				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
-
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
-
-				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
-
-				submesh->set_attribute(attrib_name, attrib);
-			}
-
-			if (gltf_primitive.indices >= 0)
-			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
-
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
-
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
-
-				switch (format)
-				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
-				}
-
-				submesh->index_buffer = std::make_unique<core::Buffer>(device,
-				                                                       index_data.size(),
-				                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-				                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
-				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
-				                                                  gltf_mesh.name, i_primitive));
-
-				submesh->index_buffer->update(index_data);
-			}
-			else
-			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
-			}
+			auto submesh = submesh_futures[mesh_index][i_primitive].get();
 
 			if (gltf_primitive.material < 0)
 			{
@@ -805,10 +928,13 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		scene.add_component(std::move(mesh));
 	}
 
+	// Wait for the last image uploads, which ran while the meshes were being loaded
 	device.get_fence_pool().wait();
 	device.get_fence_pool().reset();
 	device.get_command_pool().reset_pool();
 
+	upload_batches.clear();
+
 	scene.add_component(std::move(default_material));
 
 	// Load cameras
@@ -864,6 +990,76 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		nodes.push_back(std::move(node));
 	}
 
+	// Load skins, once all the nodes they use as joints exist
+	std::vector<std::unique_ptr<sg::Skin>> skins;
+
+	for (size_t skin_index = 0; skin_index < model.skins.size(); ++skin_index)
+	{
+		auto &gltf_skin = model.skins[skin_index];
+
+		std::vector<sg::Node *> joints;
+
+		for (auto joint_index : gltf_skin.joints)
+		{
+			assert(joint_index < nodes.size());
+			joints.push_back(nodes[joint_index].get());
+		}
+
+		std::vector<glm::mat4> inverse_bind_matrices;
+
+		if (gltf_skin.inverseBindMatrices >= 0)
+		{
+			auto matrix_data = get_attribute_floats(&model, gltf_skin.inverseBindMatrices);
+
+			for (size_t i = 0; i + 16 <= matrix_data.size(); i += 16)
+			{
+				inverse_bind_matrices.push_back(glm::make_mat4(&matrix_data[i]));
+			}
+		}
+
+		if (joints.empty())
+		{
+			LOGW("Gltf skin #{} has no joints", skin_index);
+		}
+
+		auto skin = std::make_unique<sg::Skin>(gltf_skin.name);
+		skin->set_joints(std::move(joints), std::move(inverse_bind_matrices));
+
+		skins.push_back(std::move(skin));
+	}
+
+	for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
+	{
+		int skin_index = model.nodes[node_index].skin;
+
+		if (skin_index < 0 || model.nodes[node_index].mesh < 0)
+		{
+			continue;
+		}
+
+		assert(skin_index < skins.size());
+		auto &skin = *skins[skin_index];
+
+		for (auto sub_mesh : meshes[model.nodes[node_index].mesh]->get_submeshes())
+		{
+			if (!sub_mesh->skinned_vertices)
+			{
+				continue;
+			}
+
+			auto &joints = sub_mesh->skinned_vertices->joints;
+
+			if (!joints.empty() && *std::max_element(joints.begin(), joints.end()) >= skin.get_joints().size())
+			{
+				LOGW("Gltf node #{} has vertices referring to joints missing from skin #{}", node_index, skin_index);
+			}
+		}
+
+		nodes[node_index]->set_component(skin);
+	}
+
+	scene.set_components(std::move(skins));
+
 	std::vector<std::unique_ptr<sg::Animation>> animations;
 
 	// Load animations
@@ -1063,9 +1259,112 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		vkb::add_directional_light(scene, glm::quat({glm::radians(-90.0f), 0.0f, glm::radians(30.0f)}));
 	}
 
+	// Samples which do not update the scene every frame still query up to date world matrices
+	scene.update_transforms();
+
 	return scene;
 }
 
+std::unique_ptr<sg::SubMesh> GLTFLoader::load_primitive(const tinygltf::Mesh &gltf_mesh, size_t primitive_index) const
+{
+	const auto &gltf_primitive = gltf_mesh.primitives[primitive_index];
+
+	auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, primitive_index);
+	auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
+
+	submesh->skinned_vertices = load_skinned_vertices(&model, gltf_primitive);
+
+	for (auto &attribute : gltf_primitive.attributes)
+	{
+		std::string attrib_name = attribute.first;
+		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+
+		std::vector<uint8_t> vertex_data;
+
+		sg::VertexAttribute attrib;
+
+		// Joints and weights of skinned primitives are converted to a single format, shared by the vertex shader and CPU skinning
+		if (submesh->skinned_vertices && attrib_name == "joints_0")
+		{
+			vertex_data   = to_bytes(submesh->skinned_vertices->joints);
+			attrib.format = VK_FORMAT_R16G16B16A16_UINT;
+			attrib.stride = 4 * sizeof(uint16_t);
+		}
+		else if (submesh->skinned_vertices && attrib_name == "weights_0")
+		{
+			vertex_data   = to_bytes(submesh->skinned_vertices->weights);
+			attrib.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attrib.stride = 4 * sizeof(float);
+		}
+		else
+		{
+			vertex_data   = get_attribute_data(&model, attribute.second);
+			attrib.format = get_attribute_format(&model, attribute.second);
+			attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+		}
+
+		if (attrib_name == "position")
+		{
+			assert(attribute.second < model.accessors.size());
+			submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
+		}
+
+		core::Buffer buffer{device,
+		                    vertex_data.size(),
+		                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		                    VMA_MEMORY_USAGE_CPU_TO_GPU};
+		buffer.update(vertex_data);
+		buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
+		                                  gltf_mesh.name, primitive_index, attrib_name));
+
+		submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+
+		submesh->set_attribute(attrib_name, attrib);
+	}
+
+	if (gltf_primitive.indices >= 0)
+	{
+		submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+
+		auto format = get_attribute_format(&model, gltf_primitive.indices);
+
+		auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+
+		switch (format)
+		{
+			case VK_FORMAT_R8_UINT:
+				// Converts uint8 data into uint16 data, still represented by a uint8 vector
+				index_data          = convert_underlying_data_stride(index_data, 1, 2);
+				submesh->index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R16_UINT:
+				submesh->index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R32_UINT:
+				submesh->index_type = VK_INDEX_TYPE_UINT32;
+				break;
+			default:
+				LOGE("gltf primitive has invalid format type");
+				break;
+		}
+
+		submesh->index_buffer = std::make_unique<core::Buffer>(device,
+		                                                       index_data.size(),
+		                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+		submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
+		                                                  gltf_mesh.name, primitive_index));
+
+		submesh->index_buffer->update(index_data);
+	}
+	else
+	{
+		submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+	}
+
+	return submesh;
+}
+
 std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage_buffer)
 {
 	auto submesh = std::make_unique<sg::SubMesh>();
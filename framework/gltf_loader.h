@@ -135,5 +135,11 @@ class GLTFLoader
 	sg::Scene load_scene(int scene_index = -1);
 
 	std::unique_ptr<sg::SubMesh> load_model(uint32_t index, bool storage_buffer = false);
+
+	/**
+	 * @brief Loads the vertex and index buffers of a mesh primitive, without its material
+	 *        Only reads the model, so primitives can be loaded from several threads at once.
+	 */
+	std::unique_ptr<sg::SubMesh> load_primitive(const tinygltf::Mesh &gltf_mesh, size_t primitive_index) const;
 };
 }        // namespace vkb
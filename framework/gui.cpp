@@ -438,13 +438,13 @@ bool Gui::update_buffers()
 	return updated;
 }
 
-void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame)
+bool Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame)
 {
 	ImDrawData *draw_data = ImGui::GetDrawData();
 
 	if (!draw_data)
 	{
-		return;
+		return false;
 	}
 
 	size_t vertex_buffer_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
@@ -452,17 +452,23 @@ void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_fram
 
 	if ((vertex_buffer_size == 0) || (index_buffer_size == 0))
 	{
-		return;
+		return false;
 	}
 
-	std::vector<uint8_t> vertex_data(vertex_buffer_size);
-	std::vector<uint8_t> index_data(index_buffer_size);
+	auto vertex_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
+	auto index_allocation  = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
 
-	upload_draw_data(draw_data, vertex_data.data(), index_data.data());
+	if (vertex_allocation.empty() || index_allocation.empty())
+	{
+		LOGE("Failed to allocate the GUI vertex and index buffers, the GUI is not drawn");
+		return false;
+	}
 
-	auto vertex_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
+	// Upload the draw data straight to the mapped memory of the allocations
+	upload_draw_data(draw_data, vertex_allocation.map(vertex_buffer_size), index_allocation.map(index_buffer_size));
 
-	vertex_allocation.update(vertex_data);
+	vertex_allocation.flush();
+	index_allocation.flush();
 
 	std::vector<std::reference_wrapper<const core::Buffer>> buffers;
 	buffers.emplace_back(std::ref(vertex_allocation.get_buffer()));
@@ -471,11 +477,9 @@ void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_fram
 
 	command_buffer.bind_vertex_buffers(0, buffers, offsets);
 
-	auto index_allocation = sample.get_render_context().get_active_frame().allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
-
-	index_allocation.update(index_data);
-
 	command_buffer.bind_index_buffer(index_allocation.get_buffer(), index_allocation.get_offset(), VK_INDEX_TYPE_UINT16);
+
+	return true;
 }
 
 void Gui::resize(const uint32_t width, const uint32_t height) const
@@ -581,7 +585,10 @@ void Gui::draw(CommandBuffer &command_buffer)
 	// If a render context is used, then use the frames buffer pools to allocate GUI vertex/index data from
 	if (!explicit_update)
 	{
-		update_buffers(command_buffer, sample.get_render_context().get_active_frame());
+		if (!update_buffers(command_buffer, sample.get_render_context().get_active_frame()))
+		{
+			return;
+		}
 	}
 	else
 	{
@@ -257,8 +257,9 @@ class Gui
 	/**
 	 * @brief Updates Vulkan buffers
 	 * @param frame Frame to render into
+	 * @return False if there is nothing to draw, or the buffers could not be allocated
 	 */
-	void update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame);
+	bool update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame);
 
 	static const double press_time_ms;
 
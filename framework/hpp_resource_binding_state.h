@@ -1,4 +1,4 @@
-/* Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2023-2024, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -31,23 +31,30 @@ namespace vkb
  */
 struct HPPResourceInfo
 {
-	bool                           dirty      = false;
-	const vkb::core::HPPBuffer    *buffer     = nullptr;
-	vk::DeviceSize                 offset     = 0;
-	vk::DeviceSize                 range      = 0;
-	const vkb::core::HPPImageView *image_view = nullptr;
-	const vkb::core::HPPSampler   *sampler    = nullptr;
+	uint32_t                       binding       = 0;
+	uint32_t                       array_element = 0;
+	const vkb::core::HPPBuffer    *buffer        = nullptr;
+	vk::DeviceSize                 offset        = 0;
+	vk::DeviceSize                 range         = 0;
+	const vkb::core::HPPImageView *image_view    = nullptr;
+	const vkb::core::HPPSampler   *sampler       = nullptr;
 };
 
 class HPPResourceSet : private vkb::ResourceSet
 {
   public:
+	using vkb::ResourceSet::empty;
 	using vkb::ResourceSet::is_dirty;
 
   public:
-	const BindingMap<HPPResourceInfo> &get_resource_bindings() const
+	const HPPResourceInfo *begin() const
 	{
-		return reinterpret_cast<BindingMap<HPPResourceInfo> const &>(vkb::ResourceSet::get_resource_bindings());
+		return reinterpret_cast<HPPResourceInfo const *>(vkb::ResourceSet::begin());
+	}
+
+	const HPPResourceInfo *end() const
+	{
+		return reinterpret_cast<HPPResourceInfo const *>(vkb::ResourceSet::end());
 	}
 };
 
@@ -56,6 +63,7 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
   public:
 	using vkb::ResourceBindingState::clear_dirty;
 	using vkb::ResourceBindingState::is_dirty;
+	using vkb::ResourceBindingState::max_resource_sets;
 	using vkb::ResourceBindingState::reset;
 
   public:
@@ -85,9 +93,9 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
 		vkb::ResourceBindingState::bind_input(reinterpret_cast<vkb::core::ImageView const &>(image_view), set, binding, array_element);
 	}
 
-	const std::unordered_map<uint32_t, vkb::HPPResourceSet> &get_resource_sets()
+	const std::array<vkb::HPPResourceSet, max_resource_sets> &get_resource_sets()
 	{
-		return reinterpret_cast<std::unordered_map<uint32_t, vkb::HPPResourceSet> const &>(vkb::ResourceBindingState::get_resource_sets());
+		return reinterpret_cast<std::array<vkb::HPPResourceSet, max_resource_sets> const &>(vkb::ResourceBindingState::get_resource_sets());
 	}
 };
 }        // namespace vkb
@@ -207,6 +207,6 @@ void HPPResourceCache::warmup(const std::vector<uint8_t> &data)
 {
 	recorder.set_data(data);
 
-	replayer.play(*this, recorder);
+	replayer.play(*this, data);
 }
 }        // namespace vkb
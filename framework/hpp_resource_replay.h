@@ -22,7 +22,6 @@
 namespace vkb
 {
 class HPPResourceCache;
-class HPPResourceRecord;
 
 /**
  * @brief facade class around vkb::ResourceReplay, providing a vulkan.hpp-based interface
@@ -32,9 +31,9 @@ class HPPResourceRecord;
 class HPPResourceReplay : private vkb::ResourceReplay
 {
   public:
-	void play(vkb::HPPResourceCache &resource_cache, vkb::HPPResourceRecord &recorder)
+	void play(vkb::HPPResourceCache &resource_cache, const std::vector<uint8_t> &data)
 	{
-		vkb::ResourceReplay::play(reinterpret_cast<vkb::ResourceCache &>(resource_cache), reinterpret_cast<vkb::ResourceRecord &>(recorder));
+		vkb::ResourceReplay::play(reinterpret_cast<vkb::ResourceCache &>(resource_cache), data);
 	}
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -53,6 +53,8 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 {
 	device.wait_idle();
 
+	buffer_rings = RenderFrame::create_buffer_rings(thread_count);
+
 	if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
@@ -67,7 +69,7 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 			    swapchain->get_format(),
 			    swapchain->get_usage()};
 			auto render_target = create_render_target_func(std::move(swapchain_image));
-			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count, buffer_rings.get()));
 		}
 	}
 	else
@@ -82,7 +84,7 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 		                               VMA_MEMORY_USAGE_GPU_ONLY};
 
 		auto render_target = create_render_target_func(std::move(color_image));
-		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count, buffer_rings.get()));
 	}
 
 	this->create_render_target_func = create_render_target_func;
@@ -200,7 +202,7 @@ void RenderContext::recreate()
 		else
 		{
 			// Create a new frame if the new swapchain has more images than current frames
-			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count, buffer_rings.get()));
 		}
 
 		++frame_it;
@@ -332,6 +334,9 @@ void RenderContext::begin_frame()
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	// Cached objects only used by retired frames can now be evicted
+	device.get_resource_cache().begin_frame(to_u32(frames.size()));
 }
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
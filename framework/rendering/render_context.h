@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -240,6 +240,9 @@ class RenderContext
 
 	SwapchainProperties swapchain_properties;
 
+	/// Buffer rings shared by the frames, destroyed after them
+	std::unique_ptr<BufferRings> buffer_rings;
+
 	std::vector<std::unique_ptr<RenderFrame>> frames;
 
 	VkSemaphore acquired_semaphore;
@@ -17,24 +17,67 @@
 
 #include "render_frame.h"
 
+#include <chrono>
+
 #include "common/utils.h"
 #include "core/util/logging.hpp"
 
 namespace vkb
 {
-RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count) :
+namespace
+{
+/**
+ * @brief Returns the usage of the buffers created for a supported usage
+ */
+VkBufferUsageFlags get_buffer_usage(Device &device, VkBufferUsageFlags usage)
+{
+	// Descriptor buffers reference buffers, and are themselves bound, by device address
+	if (device.get_resource_cache().uses_descriptor_buffers() &&
+	    (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT || usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT || usage == RenderFrame::DESCRIPTOR_BUFFER_USAGE))
+	{
+		usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+	}
+
+	return usage;
+}
+}        // namespace
+
+const std::unordered_map<VkBufferUsageFlags, uint32_t> RenderFrame::supported_usage_map = {
+    {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 1},
+    {VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2},        // x2 the size of BUFFER_POOL_BLOCK_SIZE since SSBOs are normally much larger than other types of buffers
+    {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1},
+    {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1},
+    {RenderFrame::DESCRIPTOR_BUFFER_USAGE, 1}};
+
+std::unique_ptr<BufferRings> RenderFrame::create_buffer_rings(size_t thread_count)
+{
+	auto buffer_rings = std::make_unique<BufferRings>();
+
+	// Only the slots are created here, so that threads never insert in the map concurrently
+	for (auto &usage_it : supported_usage_map)
+	{
+		buffer_rings->rings[usage_it.first].resize(thread_count);
+	}
+
+	return buffer_rings;
+}
+
+RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count, BufferRings *buffer_rings) :
     device{device},
     fence_pool{device},
     semaphore_pool{device},
     swapchain_render_target{std::move(render_target)},
-    thread_count{thread_count}
+    thread_count{thread_count},
+    buffer_rings{buffer_rings}
 {
 	for (auto &usage_it : supported_usage_map)
 	{
+		VkBufferUsageFlags buffer_usage = get_buffer_usage(device, usage_it.first);
+
 		std::vector<std::pair<BufferPool, BufferBlock *>> usage_buffer_pools;
 		for (size_t i = 0; i < thread_count; ++i)
 		{
-			usage_buffer_pools.push_back(std::make_pair(BufferPool{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, usage_it.first}, nullptr));
+			usage_buffer_pools.push_back(std::make_pair(BufferPool{device, BUFFER_POOL_BLOCK_SIZE * 1024 * usage_it.second, buffer_usage}, nullptr));
 		}
 
 		auto res_ins_it = buffer_pools.emplace(usage_it.first, std::move(usage_buffer_pools));
@@ -50,6 +93,10 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
 		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorSet>>());
 	}
+
+	descriptor_set_last_use.resize(thread_count);
+	descriptor_set_counters.resize(thread_count);
+	command_counters.resize(thread_count);
 }
 
 Device &RenderFrame::get_device()
@@ -87,10 +134,75 @@ void RenderFrame::reset()
 
 	semaphore_pool.reset();
 
+	if (buffer_rings)
+	{
+		// The GPU is done with what the frame allocated from the rings, and the frame starts allocating again
+		uint64_t frame = ++buffer_rings->frame_count;
+
+		for (auto &rings_per_usage : buffer_rings->rings)
+		{
+			for (auto &buffer_ring : rings_per_usage.second)
+			{
+				if (buffer_ring)
+				{
+					buffer_ring->release_frame(buffer_ring_frame);
+					buffer_ring->begin_frame(frame);
+				}
+			}
+		}
+
+		buffer_ring_frame = frame;
+	}
+
 	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly)
 	{
 		clear_descriptors();
 	}
+	else if (descriptor_set_budget > 0)
+	{
+		evict_descriptor_sets();
+	}
+
+	++reset_count;
+}
+
+void RenderFrame::evict_descriptor_sets()
+{
+	for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+	{
+		auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+		auto &last_use               = descriptor_set_last_use[thread_index];
+
+		if (thread_descriptor_sets.size() <= descriptor_set_budget)
+		{
+			continue;
+		}
+
+		// Pairs of last use and hash
+		std::vector<std::pair<uint64_t, size_t>> candidates;
+		candidates.reserve(thread_descriptor_sets.size());
+
+		for (auto &descriptor_set_it : thread_descriptor_sets)
+		{
+			candidates.emplace_back(last_use[descriptor_set_it.second.get_handle()], descriptor_set_it.first);
+		}
+
+		size_t evict_count = thread_descriptor_sets.size() - descriptor_set_budget;
+
+		std::nth_element(candidates.begin(), candidates.begin() + evict_count, candidates.end());
+
+		for (size_t i = 0; i < evict_count; ++i)
+		{
+			auto descriptor_set_it = thread_descriptor_sets.find(candidates[i].second);
+			auto handle            = descriptor_set_it->second.get_handle();
+
+			descriptor_set_it->second.get_descriptor_pool().free(handle);
+			last_use.erase(handle);
+			thread_descriptor_sets.erase(descriptor_set_it);
+		}
+
+		descriptor_set_counters[thread_index].evictions += evict_count;
+	}
 }
 
 std::vector<std::unique_ptr<CommandPool>> &RenderFrame::get_command_pools(const Queue &queue, CommandBuffer::ResetMode reset_mode)
@@ -209,7 +321,11 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 	assert(thread_index < thread_count && "Thread index is out of bounds");
 
 	assert(thread_index < descriptor_pools.size());
-	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
+	// Sets over budget are freed, the pools of frames without budget do not need to support it
+	uint32_t pool_size            = DescriptorPool::MAX_SETS_PER_POOL;
+	bool     free_descriptor_sets = descriptor_set_budget > 0;
+
+	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout, pool_size, free_descriptor_sets);
 	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache)
 	{
 		// The bindings we want to update before binding, if empty we update all bindings
@@ -222,8 +338,29 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 
 		// Request a descriptor set from the render frame, and write the buffer infos and image infos of all the specified bindings
 		assert(thread_index < descriptor_sets.size());
-		auto &descriptor_set = request_resource(device, nullptr, *descriptor_sets[thread_index], descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+		auto  &thread_descriptor_sets = *descriptor_sets[thread_index];
+		size_t cached_count           = thread_descriptor_sets.size();
+		auto   start                  = std::chrono::steady_clock::now();
+
+		auto &descriptor_set = request_resource(device, nullptr, thread_descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+
+		auto &counters = descriptor_set_counters[thread_index];
+		if (thread_descriptor_sets.size() == cached_count)
+		{
+			++counters.hits;
+		}
+		else
+		{
+			counters.add_miss(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
 		descriptor_set.update(bindings_to_update);
+
+		if (descriptor_set_budget > 0)
+		{
+			descriptor_set_last_use[thread_index][descriptor_set.get_handle()] = reset_count;
+		}
+
 		return descriptor_set.get_handle();
 	}
 	else
@@ -252,6 +389,11 @@ void RenderFrame::clear_descriptors()
 		desc_sets_per_thread->clear();
 	}
 
+	for (auto &last_use_per_thread : descriptor_set_last_use)
+	{
+		last_use_per_thread.clear();
+	}
+
 	for (auto &desc_pools_per_thread : descriptor_pools)
 	{
 		for (auto &desc_pool : *desc_pools_per_thread)
@@ -266,6 +408,42 @@ void RenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_st
 	buffer_allocation_strategy = new_strategy;
 }
 
+void RenderFrame::set_descriptor_set_budget(size_t max_descriptor_sets)
+{
+	descriptor_set_budget = max_descriptor_sets;
+}
+
+CacheCounters RenderFrame::get_descriptor_set_counters() const
+{
+	CacheCounters result;
+
+	for (auto &counters : descriptor_set_counters)
+	{
+		result += counters;
+	}
+
+	return result;
+}
+
+void RenderFrame::add_command_counters(const CommandCounters &counters, size_t thread_index)
+{
+	assert(thread_index < command_counters.size() && "Thread index is out of bounds");
+
+	command_counters[thread_index] += counters;
+}
+
+CommandCounters RenderFrame::get_command_counters() const
+{
+	CommandCounters result;
+
+	for (auto &counters : command_counters)
+	{
+		result += counters;
+	}
+
+	return result;
+}
+
 void RenderFrame::set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy)
 {
 	descriptor_management_strategy = new_strategy;
@@ -275,6 +453,38 @@ BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, co
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
 
+	if (usage == DESCRIPTOR_BUFFER_USAGE && !device.get_resource_cache().uses_descriptor_buffers())
+	{
+		LOGE("Descriptor buffers are not enabled, no descriptor buffer can be allocated");
+		return BufferAllocation{};
+	}
+
+	if (buffer_rings && buffer_allocation_strategy == BufferAllocationStrategy::MultipleAllocationsPerBuffer)
+	{
+		auto buffer_rings_it = buffer_rings->rings.find(usage);
+		if (buffer_rings_it == buffer_rings->rings.end())
+		{
+			LOGE("No buffer ring for buffer usage {}", usage);
+			return BufferAllocation{};
+		}
+
+		assert(thread_index < buffer_rings_it->second.size());
+		auto &buffer_ring = buffer_rings_it->second[thread_index];
+
+		// Rings are created on first use, so that frames which never allocate from them do not hold their memory
+		if (!buffer_ring)
+		{
+			buffer_ring = std::make_unique<BufferRing>(device, BUFFER_RING_SIZE * 1024 * supported_usage_map.at(usage), get_buffer_usage(device, usage));
+
+			if (buffer_ring_frame > 0)
+			{
+				buffer_ring->begin_frame(buffer_ring_frame);
+			}
+		}
+
+		return buffer_ring->allocate(size);
+	}
+
 	// Find a pool for this usage
 	auto buffer_pool_it = buffer_pools.find(usage);
 	if (buffer_pool_it == buffer_pools.end())
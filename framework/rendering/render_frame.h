@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,6 +18,8 @@
 #pragma once
 
 #include "buffer_pool.h"
+#include "common/cache_counters.h"
+#include "common/command_counters.h"
 #include "common/helpers.h"
 #include "common/resource_caching.h"
 #include "common/vk_common.h"
@@ -46,6 +48,18 @@ enum DescriptorManagementStrategy
 	CreateDirectly
 };
 
+/**
+ * @brief Buffer rings shared by the frames of a RenderContext
+ */
+struct BufferRings
+{
+	/// Rings of each supported usage, for each thread. A ring is null until a buffer is first allocated from it
+	std::map<VkBufferUsageFlags, std::vector<std::unique_ptr<BufferRing>>> rings;
+
+	/// Number of frames started on the rings
+	uint64_t frame_count{0};
+};
+
 /**
  * @brief RenderFrame is a container for per-frame data, including BufferPool objects,
  * synchronization primitives (semaphores, fences) and the swapchain RenderTarget.
@@ -67,14 +81,32 @@ class RenderFrame
 	 */
 	static constexpr uint32_t BUFFER_POOL_BLOCK_SIZE = 256;
 
-	// A map of the supported usages to a multiplier for the BUFFER_POOL_BLOCK_SIZE
-	const std::unordered_map<VkBufferUsageFlags, uint32_t> supported_usage_map = {
-	    {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 1},
-	    {VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2},        // x2 the size of BUFFER_POOL_BLOCK_SIZE since SSBOs are normally much larger than other types of buffers
-	    {VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 1},
-	    {VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 1}};
+	/**
+	 * @brief Initial size of a buffer ring in kilobytes, shared by all the frames in flight
+	 */
+	static constexpr uint32_t BUFFER_RING_SIZE = 1024;
+
+	/**
+	 * @brief Usage of the buffers command buffers write descriptors to, when the resource cache uses descriptor buffers
+	 */
+	static constexpr VkBufferUsageFlags DESCRIPTOR_BUFFER_USAGE = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+
+	// A map of the supported usages to a multiplier for the BUFFER_POOL_BLOCK_SIZE and BUFFER_RING_SIZE
+	static const std::unordered_map<VkBufferUsageFlags, uint32_t> supported_usage_map;
+
+	/**
+	 * @brief Creates the buffer rings of all the supported usages, to be shared by the frames of a RenderContext
+	 *        The buffers of a ring are only created once a frame allocates from it.
+	 * @param thread_count The number of threads allocating buffers, each one gets its own rings
+	 */
+	static std::unique_ptr<BufferRings> create_buffer_rings(size_t thread_count = 1);
 
-	RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count = 1);
+	/**
+	 * @brief Creates a frame
+	 * @param buffer_rings Rings shared with the other frames which buffers are allocated from.
+	 *        If null, the frame allocates buffers from its own buffer pools.
+	 */
+	RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_target, size_t thread_count = 1, BufferRings *buffer_rings = nullptr);
 
 	RenderFrame(const RenderFrame &) = delete;
 
@@ -144,6 +176,33 @@ class RenderFrame
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
 	/**
+	 * @brief Sets the maximum number of descriptor sets cached by each thread with DescriptorManagementStrategy::StoreInCache
+	 *        The least recently used descriptor sets over budget are freed when the frame is reset.
+	 *        Should be set before any descriptor set is requested, as their pools must be created to free them.
+	 * @param max_descriptor_sets The maximum number of descriptor sets per thread, 0 meaning unlimited
+	 */
+	void set_descriptor_set_budget(size_t max_descriptor_sets);
+
+	/**
+	 * @brief Returns the usage counters of the descriptor sets cached by the frame, summed over all threads
+	 */
+	CacheCounters get_descriptor_set_counters() const;
+
+	/**
+	 * @brief Adds the counters of a command buffer recorded for the frame
+	 * @param counters The counters of the command buffer
+	 * @param thread_index Index of the thread the command buffer was recorded on
+	 */
+	void add_command_counters(const CommandCounters &counters, size_t thread_index = 0);
+
+	/**
+	 * @brief Returns the counters of all the command buffers recorded for the frame since it was created, summed over all threads
+	 */
+	CommandCounters get_command_counters() const;
+
+	/**
+	 * @brief Allocates memory from the buffer rings of the frame, or from its buffer pools if it has no rings
+	 *        or uses BufferAllocationStrategy::OneAllocationPerBuffer
 	 * @param usage Usage of the buffer
 	 * @param size Amount of memory required
 	 * @param thread_index Index of the buffer pool to be used by the current thread
@@ -177,6 +236,19 @@ class RenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> descriptor_sets;
 
+	/// Number of resets of the frame at the last request of each cached descriptor set, per thread
+	std::vector<std::unordered_map<VkDescriptorSet, uint64_t>> descriptor_set_last_use;
+
+	/// Usage counters of the cached descriptor sets, per thread
+	std::vector<CacheCounters> descriptor_set_counters;
+
+	/// Counters of the command buffers recorded for the frame, per thread
+	std::vector<CommandCounters> command_counters;
+
+	size_t descriptor_set_budget{0};
+
+	uint64_t reset_count{0};
+
 	FencePool fence_pool;
 
 	SemaphorePool semaphore_pool;
@@ -190,6 +262,17 @@ class RenderFrame
 
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPool, BufferBlock *>>> buffer_pools;
 
+	BufferRings *buffer_rings{nullptr};
+
+	/// Index of the frame the allocations from the rings belong to since the last reset
+	uint64_t buffer_ring_frame{0};
+
+	/**
+	 * @brief Frees the least recently used descriptor sets of each thread which exceed the budget
+	 *        Must only be called once the GPU is done with the frame.
+	 */
+	void evict_descriptor_sets();
+
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
 }        // namespace vkb
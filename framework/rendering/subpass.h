@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -148,8 +148,8 @@ class Subpass
 	 * @param light_count The maximum amount of lights allowed for any given type of light.
 	 */
 	template <typename T>
-	void allocate_lights(const std::vector<sg::Light *> &scene_lights,
-	                     size_t                          light_count)
+	void allocate_lights(const sg::ComponentView<sg::Light> &scene_lights,
+	                     size_t                              light_count)
 	{
 		assert(scene_lights.size() <= (light_count * sg::LightType::Max) && "Exceeding Max Light Capacity");
 
@@ -157,7 +157,7 @@ class Subpass
 		lighting_state.point_lights.clear();
 		lighting_state.spot_lights.clear();
 
-		for (auto &scene_light : scene_lights)
+		for (auto scene_light : scene_lights)
 		{
 			const auto &properties = scene_light->get_properties();
 			auto &      transform  = scene_light->get_node()->get_transform();
@@ -198,15 +198,22 @@ class Subpass
 			}
 		}
 
-		T light_info;
+		auto &render_frame          = get_render_context().get_active_frame();
+		lighting_state.light_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(T));
+
+		if (lighting_state.light_buffer.empty())
+		{
+			throw std::runtime_error("Failed to allocate the light buffer of the frame");
+		}
+
+		// Copy the lights straight to the mapped memory of the buffer
+		auto &light_info = *lighting_state.light_buffer.emplace<T>();
 
 		std::copy(lighting_state.directional_lights.begin(), lighting_state.directional_lights.end(), light_info.directional_lights);
 		std::copy(lighting_state.point_lights.begin(), lighting_state.point_lights.end(), light_info.point_lights);
 		std::copy(lighting_state.spot_lights.begin(), lighting_state.spot_lights.end(), light_info.spot_lights);
 
-		auto &render_frame          = get_render_context().get_active_frame();
-		lighting_state.light_buffer = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(T));
-		lighting_state.light_buffer.update(light_info);
+		lighting_state.light_buffer.flush();
 	}
 
   protected:
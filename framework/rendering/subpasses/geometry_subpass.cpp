@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,46 +16,280 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <cstring>
+
+#include "common/radix_sort.h"
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "core/util/hash.hpp"
+#include "core/util/logging.hpp"
+#include "core/util/skinning.hpp"
+#include "geometry/frustum.h"
 #include "rendering/render_context.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/material.h"
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
+#include "scene_graph/components/skin.h"
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 
 namespace vkb
 {
+namespace
+{
+// Name of the texture array in shaders using bindless textures
+constexpr const char *bindless_texture_array_name = "bindless_textures";
+
+// Binding of the joint matrices in set 0 of the vertex shaders skinning on the GPU
+constexpr uint32_t joint_matrices_binding = 2;
+
+/**
+ * @brief Checks that a vertex shader skins vertices with the joints, weights and joint matrices bound by the subpass
+ */
+bool supports_gpu_skinning(const ShaderModule &vert_shader_module)
+{
+	bool has_joints         = false;
+	bool has_weights        = false;
+	bool has_joint_matrices = false;
+
+	for (auto &resource : vert_shader_module.get_resources())
+	{
+		if (resource.type == ShaderResourceType::Input)
+		{
+			has_joints |= resource.name == "joints_0";
+			has_weights |= resource.name == "weights_0";
+		}
+		else if (resource.type == ShaderResourceType::BufferStorage)
+		{
+			has_joint_matrices |= resource.name == "JointMatrices" && resource.set == 0 && resource.binding == joint_matrices_binding;
+		}
+	}
+
+	return has_joints && has_weights && has_joint_matrices;
+}
+
+// Layout of the sort keys, from the most significant bits:
+// - opaque draws:      pass | pipeline | material | depth, front-to-back
+// - transparent draws: pass | depth, back-to-front | pipeline | material
+constexpr uint32_t sort_key_pass_bits     = 2;
+constexpr uint32_t sort_key_pipeline_bits = 22;
+constexpr uint32_t sort_key_material_bits = 16;
+constexpr uint32_t sort_key_depth_bits    = 24;
+
+constexpr uint32_t sort_key_pass_shift = 64 - sort_key_pass_bits;
+
+constexpr uint64_t get_sort_key_mask(uint32_t bits)
+{
+	return (uint64_t{1} << bits) - 1;
+}
+
+/**
+ * @brief Quantizes a distance to the camera for the sort keys
+ */
+uint64_t get_depth_bits(float distance)
+{
+	// Bits of positive floats are ordered like the floats, so the most significant ones are kept
+	uint32_t bits;
+	std::memcpy(&bits, &distance, sizeof(bits));
+
+	return distance > 0.0f ? bits >> (32 - 1 - sort_key_depth_bits) : 0;
+}
+}        // namespace
+
 GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     Subpass{render_context, std::move(vertex_source), std::move(fragment_source)},
     meshes{scene_.get_components<sg::Mesh>()},
     camera{camera},
     scene{scene_}
 {
+	for (auto &mesh : meshes)
+	{
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			material_ids.emplace(sub_mesh->get_material(), to_u32(material_ids.size()));
+		}
+	}
 }
 
 void GeometrySubpass::prepare()
 {
 	// Build all shader variance upfront
-	auto &device = render_context.get_device();
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			prepare_submesh(*sub_mesh);
+		}
+	}
+}
+
+void GeometrySubpass::prepare_submesh(sg::SubMesh &sub_mesh)
+{
+	auto &device = render_context.get_device();
+
+	std::vector<const ShaderVariant *> variants{&sub_mesh.get_shader_variant()};
+
+	// Submeshes are only skinned on the GPU if the vertex shader implements it, otherwise they are skinned on the CPU.
+	// Both skinning modes are prepared, so that switching between them does not compile shaders
+	if (sub_mesh.skinned_vertices)
+	{
+		auto &skinned_vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_skinned_shader_variant());
+
+		if (supports_gpu_skinning(skinned_vert_module))
+		{
+			gpu_skinned_submeshes.insert(&sub_mesh);
+			variants.push_back(&sub_mesh.get_skinned_shader_variant());
+		}
+	}
+
+	for (auto variant : variants)
+	{
+		auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), *variant);
+		auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), *variant);
+
+		if (bindless_textures)
+		{
+			prepare_bindless_textures(vert_module, frag_module);
+		}
+	}
+}
+
+void GeometrySubpass::prepare_bindless_textures(ShaderModule &vert_shader_module, ShaderModule &frag_shader_module)
+{
+	// Shader modules are cached, so the mode is kept when they are requested again for drawing
+	frag_shader_module.set_resource_mode(bindless_texture_array_name, ShaderResourceMode::Bindless);
+
+	if (bindless_descriptor_set)
+	{
+		return;
+	}
+
+	auto &device = render_context.get_device();
+
+	auto &resources = frag_shader_module.get_resources();
+
+	auto resource_it = std::find_if(resources.begin(), resources.end(), [](const ShaderResource &resource) { return resource.name == bindless_texture_array_name; });
+
+	if (resource_it == resources.end())
+	{
+		throw std::runtime_error("Fragment shader does not declare the bindless texture array");
+	}
+
+	bindless_texture_set = resource_it->set;
+
+	// Pipeline layouts of the other submeshes define an identical set, so the descriptor set is compatible with all of them
+	auto &pipeline_layout       = device.get_resource_cache().request_pipeline_layout({&vert_shader_module, &frag_shader_module});
+	auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(bindless_texture_set);
+	auto  layout_binding        = descriptor_set_layout.get_layout_binding(resource_it->binding);
+
+	BindingMap<VkDescriptorImageInfo> image_infos;
+
+	for (auto texture : scene.get_components<sg::Texture>())
+	{
+		if (!texture->get_image() || !texture->get_sampler())
+		{
+			continue;
+		}
+
+		uint32_t index = to_u32(bindless_texture_indices.size());
+
+		if (index >= layout_binding->descriptorCount)
+		{
+			LOGE("Scene has more textures than the bindless texture array can hold ({})", layout_binding->descriptorCount);
+			throw std::runtime_error("Too many textures for the bindless texture array");
 		}
+
+		bindless_texture_indices.emplace(texture, index);
+
+		VkDescriptorImageInfo image_info{};
+		image_info.sampler     = texture->get_sampler()->vk_sampler.get_handle();
+		image_info.imageView   = texture->get_image()->get_vk_image_view().get_handle();
+		image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		image_infos[resource_it->binding][index] = image_info;
+	}
+
+	// Textures are written once, before any command buffer uses the set
+	bindless_descriptor_pool = std::make_unique<DescriptorPool>(device, descriptor_set_layout, 1);
+	bindless_descriptor_set  = std::make_unique<DescriptorSet>(device, descriptor_set_layout, *bindless_descriptor_pool, BindingMap<VkDescriptorBufferInfo>{}, image_infos);
+
+	bindless_descriptor_set->update();
+}
+
+uint32_t GeometrySubpass::get_bindless_texture_index(const sg::SubMesh &sub_mesh, const std::string &name) const
+{
+	auto &textures = sub_mesh.get_material()->textures;
+
+	auto texture_it = textures.find(name);
+
+	if (texture_it == textures.end())
+	{
+		return invalid_texture_index;
+	}
+
+	auto index_it = bindless_texture_indices.find(texture_it->second);
+
+	return index_it != bindless_texture_indices.end() ? index_it->second : invalid_texture_index;
+}
+
+GeometrySubpass::DrawPass GeometrySubpass::get_draw_pass(uint64_t sort_key)
+{
+	return static_cast<DrawPass>(sort_key >> sort_key_pass_shift);
+}
+
+uint64_t GeometrySubpass::get_sort_key(DrawPass pass, const sg::SubMesh &sub_mesh, const ShaderVariant &shader_variant, VkFrontFace front_face, float distance) const
+{
+	auto material = sub_mesh.get_material();
+
+	// The pipeline state depends on the shader variant and on the rasterization state
+	size_t pipeline_hash = shader_variant.get_id();
+	hash_combine(pipeline_hash, material->double_sided);
+	hash_combine(pipeline_hash, front_face);
+
+	// Fold the hash to the bits available in the key
+	uint64_t pipeline_bits = static_cast<uint64_t>(pipeline_hash);
+	pipeline_bits ^= (pipeline_bits >> sort_key_pipeline_bits) ^ (pipeline_bits >> (2 * sort_key_pipeline_bits));
+	pipeline_bits &= get_sort_key_mask(sort_key_pipeline_bits);
+
+	auto     material_it   = material_ids.find(material);
+	uint64_t material_bits = material_it != material_ids.end() ? material_it->second : get_sort_key_mask(sort_key_material_bits);
+	material_bits          = std::min(material_bits, get_sort_key_mask(sort_key_material_bits));
+
+	uint64_t depth_bits = get_depth_bits(distance);
+
+	uint64_t key = static_cast<uint64_t>(pass) << sort_key_pass_shift;
+
+	if (pass == DrawPass::Transparent)
+	{
+		depth_bits = get_sort_key_mask(sort_key_depth_bits) - depth_bits;
+
+		key |= depth_bits << (sort_key_pipeline_bits + sort_key_material_bits);
+		key |= pipeline_bits << sort_key_material_bits;
+		key |= material_bits;
+	}
+	else
+	{
+		key |= pipeline_bits << (sort_key_material_bits + sort_key_depth_bits);
+		key |= material_bits << sort_key_depth_bits;
+		key |= depth_bits;
 	}
+
+	return key;
 }
 
-void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+uint32_t GeometrySubpass::get_sorted_nodes(std::vector<DrawItem> &draw_items)
 {
-	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
+	draw_items.clear();
+
+	auto camera_position = glm::vec3(camera.get_node()->get_transform().get_world_matrix()[3]);
+
+	mesh_instances.clear();
+	mesh_instance_bounds.clear();
+	mesh_instance_distances.clear();
 
 	for (auto &mesh : meshes)
 	{
@@ -68,44 +302,116 @@ void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *
 			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
 			world_bounds.transform(node_transform);
 
-			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+			auto min = world_bounds.get_min();
+			auto max = world_bounds.get_max();
+
+			mesh_instances.emplace_back(mesh, node);
+			mesh_instance_bounds.push_back(min.x, min.y, min.z, max.x, max.y, max.z);
+			mesh_instance_distances.push_back(glm::length(camera_position - world_bounds.get_center()));
+		}
+	}
 
-			for (auto &sub_mesh : mesh->get_submeshes())
+	mesh_instance_visibility.resize(mesh_instances.size());
+
+	if (frustum_culling)
+	{
+		Frustum frustum;
+		frustum.update(vulkan_style_projection(camera.get_projection()) * camera.get_view());
+
+		cull_boxes(frustum.get_culling_planes(), mesh_instance_bounds, 0, mesh_instances.size(), mesh_instance_visibility.data());
+
+		// The bounds of skinned meshes are those of their bind pose, which the joints move around
+		for (size_t i = 0; i < mesh_instances.size(); i++)
+		{
+			if (!mesh_instance_visibility[i] && mesh_instances[i].second->has_component<sg::Skin>())
 			{
-				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
-				{
-					transparent_nodes.emplace(distance, std::make_pair(node, sub_mesh));
-				}
-				else
-				{
-					opaque_nodes.emplace(distance, std::make_pair(node, sub_mesh));
-				}
+				mesh_instance_visibility[i] = 1;
 			}
 		}
 	}
+	else
+	{
+		std::fill(mesh_instance_visibility.begin(), mesh_instance_visibility.end(), 1);
+	}
+
+	uint32_t culled_count = 0;
+
+	for (size_t i = 0; i < mesh_instances.size(); i++)
+	{
+		auto &mesh = *mesh_instances[i].first;
+
+		if (mesh_instance_visibility[i])
+		{
+			add_draw_items(draw_items, mesh, *mesh_instances[i].second, mesh_instance_distances[i]);
+		}
+		else
+		{
+			culled_count += to_u32(mesh.get_submeshes().size());
+		}
+	}
+
+	radix_sort(draw_items, draw_items_scratch, [](const DrawItem &item) { return item.sort_key; });
+
+	return culled_count;
+}
+
+void GeometrySubpass::add_draw_items(std::vector<DrawItem> &draw_items, sg::Mesh &mesh, sg::Node &node, float distance) const
+{
+	// Invert the front face if the mesh was flipped
+	const auto &scale      = node.get_transform().get_scale();
+	bool        flipped    = scale.x * scale.y * scale.z < 0;
+	VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+	sg::Skin *node_skin = node.has_component<sg::Skin>() ? &node.get_component<sg::Skin>() : nullptr;
+
+	for (auto &sub_mesh : mesh.get_submeshes())
+	{
+		sg::Skin *skin = sub_mesh->skinned_vertices ? node_skin : nullptr;
+
+		bool gpu_skinning = skin && skinning_mode == SkinningMode::GPU && gpu_skinned_submeshes.count(sub_mesh) != 0;
+
+		auto &shader_variant = gpu_skinning ? sub_mesh->get_skinned_shader_variant() : sub_mesh->get_shader_variant();
+
+		if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+		{
+			// Transparent objects are drawn with the default front face
+			draw_items.push_back({get_sort_key(DrawPass::Transparent, *sub_mesh, shader_variant, VK_FRONT_FACE_COUNTER_CLOCKWISE, distance), &node, sub_mesh, skin, gpu_skinning});
+		}
+		else
+		{
+			draw_items.push_back({get_sort_key(DrawPass::Opaque, *sub_mesh, shader_variant, front_face, distance), &node, sub_mesh, skin, gpu_skinning});
+		}
+	}
 }
 
 void GeometrySubpass::draw(CommandBuffer &command_buffer)
 {
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+	command_buffer.add_culled_draws(get_sorted_nodes(draw_items));
 
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
+	auto transparent_begin = std::find_if(draw_items.begin(), draw_items.end(),
+	                                      [](const DrawItem &item) { return get_draw_pass(item.sort_key) == DrawPass::Transparent; });
 
-	// Draw opaque objects in front-to-back order
+	// Draw opaque objects grouped by pipeline state and material, in front-to-back order within a group
 	{
 		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		for (auto item_it = draw_items.begin(); item_it != transparent_begin; item_it++)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			update_uniform(command_buffer, *item_it->node, thread_index);
 
 			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
+			const auto &scale      = item_it->node->get_transform().get_scale();
 			bool        flipped    = scale.x * scale.y * scale.z < 0;
 			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+			if (item_it->skin)
+			{
+				draw_skinned_submesh(command_buffer, *item_it, front_face);
+			}
+			else
+			{
+				draw_submesh(command_buffer, *item_it->sub_mesh, front_face);
+			}
 		}
 	}
 
@@ -130,37 +436,125 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 	{
 		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+		for (auto item_it = transparent_begin; item_it != draw_items.end(); item_it++)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			update_uniform(command_buffer, *item_it->node, thread_index);
 
-			draw_submesh(command_buffer, *node_it->second.second);
+			if (item_it->skin)
+			{
+				draw_skinned_submesh(command_buffer, *item_it);
+			}
+			else
+			{
+				draw_submesh(command_buffer, *item_it->sub_mesh);
+			}
 		}
 	}
 }
 
 void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
 {
-	GlobalUniform global_uniform;
-
-	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
-
 	auto &render_frame = get_render_context().get_active_frame();
 
 	auto &transform = node.get_transform();
 
 	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(GlobalUniform), thread_index);
 
+	if (allocation.empty())
+	{
+		throw std::runtime_error("Failed to allocate the uniform buffer of node " + node.get_name());
+	}
+
+	// Write the uniform in place, in the mapped memory of the allocation
+	auto &global_uniform = *allocation.emplace<GlobalUniform>();
+
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+
 	global_uniform.model = transform.get_world_matrix();
 
 	global_uniform.camera_position = glm::vec3(glm::inverse(camera.get_view())[3]);
 
-	allocation.update(global_uniform);
+	allocation.flush();
 
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
 }
 
 void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
+{
+	draw_submesh(command_buffer, sub_mesh, sub_mesh.get_shader_variant(), nullptr, front_face);
+}
+
+void GeometrySubpass::draw_skinned_submesh(CommandBuffer &command_buffer, const DrawItem &item, VkFrontFace front_face)
+{
+	auto &render_frame         = get_render_context().get_active_frame();
+	auto &sub_mesh             = *item.sub_mesh;
+	auto &world_joint_matrices = item.skin->get_joint_matrices();
+
+	if (world_joint_matrices.empty() || !sub_mesh.skinned_vertices)
+	{
+		draw_submesh(command_buffer, sub_mesh, front_face);
+		return;
+	}
+
+	// The model matrix of the node is applied to skinned submeshes as to any other, so the joints are brought to the space of the node
+	glm::mat4 world_to_node = glm::inverse(item.node->get_transform().get_world_matrix());
+
+	joint_matrices.resize(world_joint_matrices.size());
+
+	for (size_t i = 0; i < world_joint_matrices.size(); ++i)
+	{
+		joint_matrices[i] = world_to_node * world_joint_matrices[i];
+	}
+
+	if (item.gpu_skinning)
+	{
+		auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, joint_matrices.size() * sizeof(glm::mat4), thread_index);
+
+		if (allocation.empty())
+		{
+			LOGE("Failed to allocate the joint matrices of submesh {}", sub_mesh.get_name());
+			return;
+		}
+
+		allocation.update(reinterpret_cast<const uint8_t *>(joint_matrices.data()), joint_matrices.size() * sizeof(glm::mat4));
+
+		command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, joint_matrices_binding, 0);
+
+		draw_submesh(command_buffer, sub_mesh, sub_mesh.get_skinned_shader_variant(), nullptr, front_face);
+		return;
+	}
+
+	static_assert(sizeof(glm::mat4) == sizeof(JointMatrix), "Joint matrices must have the layout of the skinning kernels");
+
+	auto  &vertices     = *sub_mesh.skinned_vertices;
+	size_t vertex_count = vertices.positions.size() / 3;
+	size_t data_size    = (vertices.positions.size() + vertices.normals.size()) * sizeof(float);
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, data_size, thread_index);
+
+	if (allocation.empty())
+	{
+		LOGE("Failed to allocate the skinned vertices of submesh {}", sub_mesh.get_name());
+		return;
+	}
+
+	// Skinned vertices are written in place, to the mapped memory of the allocation
+	auto data = reinterpret_cast<float *>(allocation.map(data_size));
+
+	SkinnedVertices input;
+	input.positions = vertices.positions.data();
+	input.normals   = vertices.normals.empty() ? nullptr : vertices.normals.data();
+	input.joints    = vertices.joints.data();
+	input.weights   = vertices.weights.data();
+
+	skin_vertices(reinterpret_cast<const JointMatrix *>(joint_matrices.data()), joint_matrices.size(), input, 0, vertex_count, data, data + 3 * vertex_count);
+
+	allocation.flush();
+
+	draw_submesh(command_buffer, sub_mesh, sub_mesh.get_shader_variant(), &allocation, front_face);
+}
+
+void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, const ShaderVariant &shader_variant, BufferAllocation *skinned_vertices, VkFrontFace front_face)
 {
 	auto &device = command_buffer.get_device();
 
@@ -172,8 +566,8 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	multisample_state.rasterization_samples = sample_count;
 	command_buffer.set_multisample_state(multisample_state);
 
-	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
-	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), shader_variant);
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), shader_variant);
 
 	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
 
@@ -181,25 +575,59 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 
 	command_buffer.bind_pipeline_layout(pipeline_layout);
 
-	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	uint32_t material_uniform_size = bindless_textures ? sizeof(BindlessPBRMaterialUniform) : sizeof(PBRMaterialUniform);
+
+	if (pipeline_layout.get_push_constant_range_stage(material_uniform_size) != 0)
 	{
 		prepare_push_constants(command_buffer, sub_mesh);
 	}
 
-	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
-
-	for (auto &texture : sub_mesh.get_material()->textures)
+	if (bindless_textures)
 	{
-		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+		// The textures are referenced by index, so the same set is used by every draw
+		command_buffer.bind_descriptor_set(bindless_texture_set, bindless_descriptor_set->get_handle());
+	}
+	else
+	{
+		DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
+
+		for (auto &texture : sub_mesh.get_material()->textures)
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
-			                          texture.second->get_sampler()->vk_sampler,
-			                          0, layout_binding->binding, 0);
+			if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
+			{
+				command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+				                          texture.second->get_sampler()->vk_sampler,
+				                          0, layout_binding->binding, 0);
+			}
 		}
 	}
 
 	auto vertex_input_resources = pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
 
+	// Finds the offset of a vertex input in the skinned vertices, if they replace the vertex buffer of the submesh
+	auto find_skinned_vertex_offset = [&](const std::string &name, VkDeviceSize &offset) {
+		if (!skinned_vertices || !sub_mesh.skinned_vertices)
+		{
+			return false;
+		}
+
+		auto &vertices = *sub_mesh.skinned_vertices;
+
+		if (name == "position")
+		{
+			offset = skinned_vertices->get_offset();
+			return true;
+		}
+
+		if (name == "normal" && !vertices.normals.empty())
+		{
+			offset = skinned_vertices->get_offset() + vertices.positions.size() * sizeof(float);
+			return true;
+		}
+
+		return false;
+	};
+
 	VertexInputState vertex_input_state;
 
 	for (auto &input_resource : vertex_input_resources)
@@ -211,6 +639,16 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 			continue;
 		}
 
+		VkDeviceSize skinned_offset;
+
+		if (find_skinned_vertex_offset(input_resource.name, skinned_offset))
+		{
+			// Skinned vertices are tightly packed
+			attribute.format = VK_FORMAT_R32G32B32_SFLOAT;
+			attribute.stride = 3 * sizeof(float);
+			attribute.offset = 0;
+		}
+
 		VkVertexInputAttributeDescription vertex_attribute{};
 		vertex_attribute.binding  = input_resource.location;
 		vertex_attribute.format   = attribute.format;
@@ -231,6 +669,17 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	// Find submesh vertex buffers matching the shader input attribute names
 	for (auto &input_resource : vertex_input_resources)
 	{
+		VkDeviceSize skinned_offset;
+
+		if (find_skinned_vertex_offset(input_resource.name, skinned_offset))
+		{
+			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
+			buffers.emplace_back(std::ref(skinned_vertices->get_buffer()));
+
+			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {skinned_offset});
+			continue;
+		}
+
 		const auto &buffer_iter = sub_mesh.vertex_buffers.find(input_resource.name);
 
 		if (buffer_iter != sub_mesh.vertex_buffers.end())
@@ -281,17 +730,28 @@ void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::
 {
 	auto pbr_material = dynamic_cast<const sg::PBRMaterial *>(sub_mesh.get_material());
 
+	if (bindless_textures)
+	{
+		BindlessPBRMaterialUniform bindless_material_uniform{};
+		bindless_material_uniform.base_color_factor                = pbr_material->base_color_factor;
+		bindless_material_uniform.metallic_factor                  = pbr_material->metallic_factor;
+		bindless_material_uniform.roughness_factor                 = pbr_material->roughness_factor;
+		bindless_material_uniform.base_color_texture_index         = get_bindless_texture_index(sub_mesh, "base_color_texture");
+		bindless_material_uniform.normal_texture_index             = get_bindless_texture_index(sub_mesh, "normal_texture");
+		bindless_material_uniform.metallic_roughness_texture_index = get_bindless_texture_index(sub_mesh, "metallic_roughness_texture");
+		bindless_material_uniform.occlusion_texture_index          = get_bindless_texture_index(sub_mesh, "occlusion_texture");
+		bindless_material_uniform.emissive_texture_index           = get_bindless_texture_index(sub_mesh, "emissive_texture");
+
+		command_buffer.push_constants(bindless_material_uniform);
+		return;
+	}
+
 	PBRMaterialUniform pbr_material_uniform{};
 	pbr_material_uniform.base_color_factor = pbr_material->base_color_factor;
 	pbr_material_uniform.metallic_factor   = pbr_material->metallic_factor;
 	pbr_material_uniform.roughness_factor  = pbr_material->roughness_factor;
 
-	auto data = to_bytes(pbr_material_uniform);
-
-	if (!data.empty())
-	{
-		command_buffer.push_constants(data);
-	}
+	command_buffer.push_constants(pbr_material_uniform);
 }
 
 void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
@@ -316,4 +776,24 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_bindless_textures(bool enable)
+{
+	bindless_textures = enable;
+}
+
+void GeometrySubpass::set_frustum_culling(bool enable)
+{
+	frustum_culling = enable;
+}
+
+void GeometrySubpass::set_skinning_mode(SkinningMode mode)
+{
+	skinning_mode = mode;
+}
+
+GeometrySubpass::SkinningMode GeometrySubpass::get_skinning_mode() const
+{
+	return skinning_mode;
+}
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,12 +17,17 @@
 
 #pragma once
 
+#include <unordered_set>
+
 #include "common/error.h"
 
 VKBP_DISABLE_WARNINGS()
 #include "common/glm_common.h"
 VKBP_ENABLE_WARNINGS()
 
+#include "core/descriptor_pool.h"
+#include "core/descriptor_set.h"
+#include "core/util/frustum_culling.hpp"
 #include "rendering/subpass.h"
 
 namespace vkb
@@ -34,6 +39,9 @@ class Node;
 class Mesh;
 class SubMesh;
 class Camera;
+class Material;
+class Skin;
+class Texture;
 }        // namespace sg
 
 /**
@@ -60,6 +68,29 @@ struct PBRMaterialUniform
 	float roughness_factor;
 };
 
+/**
+ * @brief PBR material uniform for the bindless base shader
+ *        Textures are referenced by their index in the bindless texture array.
+ */
+struct BindlessPBRMaterialUniform
+{
+	glm::vec4 base_color_factor;
+
+	float metallic_factor;
+
+	float roughness_factor;
+
+	uint32_t base_color_texture_index;
+
+	uint32_t normal_texture_index;
+
+	uint32_t metallic_roughness_texture_index;
+
+	uint32_t occlusion_texture_index;
+
+	uint32_t emissive_texture_index;
+};
+
 /**
  * @brief This subpass is responsible for rendering a Scene
  */
@@ -90,11 +121,113 @@ class GeometrySubpass : public Subpass
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Samples the material textures from a single array instead of binding them for each draw
+	 *        All the textures of the scene are written once by prepare() to the `bindless_textures` array
+	 *        of the fragment shader (see base_bindless.frag), and materials reference them by index in
+	 *        BindlessPBRMaterialUniform push constants. The device must support the
+	 *        descriptorBindingPartiallyBound and descriptorBindingSampledImageUpdateAfterBind features.
+	 *        Must be called before prepare().
+	 */
+	void set_bindless_textures(bool enable);
+
+	/**
+	 * @brief Skips the nodes whose bounding box is outside the camera frustum, enabled by default
+	 *        The number of culled submeshes is added to the counters of the command buffer.
+	 */
+	void set_frustum_culling(bool enable);
+
+	/**
+	 * @brief Where the submeshes of nodes with a skin are skinned
+	 */
+	enum class SkinningMode
+	{
+		GPU,        // In the vertex shader, with the HAS_SKIN shader variant
+		CPU         // With the SIMD skinning kernels, into vertex buffers of the frame
+	};
+
+	/**
+	 * @brief Selects how skinned submeshes are drawn, GPU by default. Can be changed between frames.
+	 *        The GPU mode reads the joint matrices from a storage buffer at set 0, binding 2 of the vertex shader.
+	 *        It is only used if the vertex shader declares the joints_0 and weights_0 inputs and the JointMatrices
+	 *        buffer in its HAS_SKIN variant, submeshes are skinned on the CPU otherwise.
+	 *        The CPU mode replaces the positions and normals of the submeshes, and works with any vertex shader.
+	 */
+	void set_skinning_mode(SkinningMode mode);
+
+	SkinningMode get_skinning_mode() const;
+
+	/// Index of a material texture which is not present
+	static constexpr uint32_t invalid_texture_index = ~0u;
+
+	/**
+	 * @brief Pass a draw belongs to, stored in the most significant bits of its sort key
+	 */
+	enum class DrawPass : uint32_t
+	{
+		Opaque      = 0,
+		Transparent = 1
+	};
+
+	/**
+	 * @brief Submesh to draw, with the key draws are sorted by
+	 */
+	struct DrawItem
+	{
+		uint64_t sort_key;
+
+		sg::Node *node;
+
+		sg::SubMesh *sub_mesh;
+
+		/// Skin of the node, if the submesh is skinned
+		sg::Skin *skin;
+
+		/// Whether the submesh is skinned by the vertex shader, rather than on the CPU
+		bool gpu_skinning;
+	};
+
+	/**
+	 * @brief Returns the pass of a draw from its sort key
+	 */
+	static DrawPass get_draw_pass(uint64_t sort_key);
+
   protected:
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
+	/**
+	 * @brief Builds the shader modules of a submesh upfront, for every way it may be drawn
+	 *        Also finds whether the submesh can be skinned on the GPU, and fills the bindless texture array.
+	 */
+	void prepare_submesh(sg::SubMesh &sub_mesh);
+
 	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
 
+	/**
+	 * @brief Draws a submesh with a given shader variant
+	 * @param skinned_vertices Positions of the submesh skinned on the CPU, followed by its normals if it has any.
+	 *        They replace the position and normal vertex buffers of the submesh. Ignored if nullptr.
+	 */
+	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, const ShaderVariant &shader_variant, BufferAllocation *skinned_vertices, VkFrontFace front_face);
+
+	/**
+	 * @brief Draws the submesh of a draw item deformed by the joints of its skin, on the GPU or on the CPU
+	 */
+	void draw_skinned_submesh(CommandBuffer &command_buffer, const DrawItem &item, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
+
+	/**
+	 * @brief Prepares the shader modules of a submesh to use the bindless texture array
+	 *        The first call assigns an index to every texture of the scene, and writes them to the array.
+	 * @param vert_shader_module The vertex shader module of a submesh
+	 * @param frag_shader_module The fragment shader module of the same submesh
+	 */
+	void prepare_bindless_textures(ShaderModule &vert_shader_module, ShaderModule &frag_shader_module);
+
+	/**
+	 * @brief Returns the index of a material texture in the bindless texture array
+	 */
+	uint32_t get_bindless_texture_index(const sg::SubMesh &sub_mesh, const std::string &name) const;
+
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
 
 	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules);
@@ -104,11 +237,34 @@ class GeometrySubpass : public Subpass
 	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
 
 	/**
-	 * @brief Sorts objects based on distance from camera and classifies them
-	 *        into opaque and transparent in the arrays provided
+	 * @brief Builds the list of submeshes to draw, sorted by their sort key
+	 *        Nodes whose bounding box is outside the camera frustum are culled, unless frustum culling is disabled.
+	 *        Opaque draws come first, grouped by pipeline state and material to minimize state changes,
+	 *        and sorted front-to-back within a group. Transparent draws follow in back-to-front order.
+	 *        Draws with equal keys keep the order of the scene, so the result is deterministic.
+	 * @param draw_items The sorted draws, the vector is cleared first so it can be reused between frames
+	 * @return The number of submeshes culled
+	 */
+	uint32_t get_sorted_nodes(std::vector<DrawItem> &draw_items);
+
+	/**
+	 * @brief Adds a draw for every submesh of a mesh instance
+	 * @param draw_items The draws to add to
+	 * @param mesh The mesh to draw
+	 * @param node The node of the mesh instance
+	 * @param distance The distance of the instance to the camera
 	 */
-	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
-	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
+	void add_draw_items(std::vector<DrawItem> &draw_items, sg::Mesh &mesh, sg::Node &node, float distance) const;
+
+	/**
+	 * @brief Packs the sort key of a draw
+	 * @param pass The pass of the draw
+	 * @param sub_mesh The submesh to draw
+	 * @param shader_variant The shader variant the submesh is drawn with
+	 * @param front_face The front face the submesh is drawn with
+	 * @param distance The distance of the submesh to the camera
+	 */
+	uint64_t get_sort_key(DrawPass pass, const sg::SubMesh &sub_mesh, const ShaderVariant &shader_variant, VkFrontFace front_face, float distance) const;
 
 	sg::Camera &camera;
 
@@ -119,6 +275,44 @@ class GeometrySubpass : public Subpass
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+	bool bindless_textures{false};
+
+	bool frustum_culling{true};
+
+	SkinningMode skinning_mode{SkinningMode::GPU};
+
+	// Skinned submeshes whose vertex shader supports skinning on the GPU
+	std::unordered_set<const sg::SubMesh *> gpu_skinned_submeshes;
+
+	// Joint matrices of the skin being drawn, in the space of its node. Kept between draws to avoid reallocations
+	std::vector<glm::mat4> joint_matrices;
+
+	// Set of the bindless texture array in the pipeline layout
+	uint32_t bindless_texture_set{0};
+
+	std::unordered_map<const sg::Texture *, uint32_t> bindless_texture_indices;
+
+	std::unique_ptr<DescriptorPool> bindless_descriptor_pool;
+
+	std::unique_ptr<DescriptorSet> bindless_descriptor_set;
+
+	// Materials numbered in the order of the scene, so that sort keys do not depend on memory addresses
+	std::unordered_map<const sg::Material *, uint32_t> material_ids;
+
+	// Kept between frames to avoid reallocations
+	std::vector<DrawItem> draw_items;
+
+	std::vector<DrawItem> draw_items_scratch;
+
+	// Mesh instances of the scene, with their world space bounds, gathered for culling
+	std::vector<std::pair<sg::Mesh *, sg::Node *>> mesh_instances;
+
+	BoundingBoxes mesh_instance_bounds;
+
+	std::vector<float> mesh_instance_distances;
+
+	std::vector<uint8_t> mesh_instance_visibility;
 };
 
 }        // namespace vkb
@@ -82,8 +82,17 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	rasterization_state.cull_mode = VK_CULL_MODE_FRONT_BIT;
 	command_buffer.set_rasterization_state(rasterization_state);
 
-	// Populate uniform values
-	LightUniform light_uniform;
+	// Allocate a buffer using the buffer pool from the active frame to store uniform values
+	auto &render_frame = get_render_context().get_active_frame();
+	auto  allocation   = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(LightUniform));
+
+	if (allocation.empty())
+	{
+		throw std::runtime_error("Failed to allocate the light uniform of the lighting subpass");
+	}
+
+	// Populate uniform values in place
+	auto &light_uniform = *allocation.emplace<LightUniform>();
 
 	// Inverse resolution
 	light_uniform.inv_resolution.x = 1.0f / render_target.get_extent().width;
@@ -92,10 +101,9 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	// Inverse view projection
 	light_uniform.inv_view_proj = glm::inverse(vulkan_style_projection(camera.get_projection()) * camera.get_view());
 
-	// Allocate a buffer using the buffer pool from the active frame to store uniform values and bind it
-	auto &render_frame = get_render_context().get_active_frame();
-	auto  allocation   = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(LightUniform));
-	allocation.update(light_uniform);
+	allocation.flush();
+
+	// Bind the uniform values
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 3, 0);
 
 	// Draw full screen triangle triangle
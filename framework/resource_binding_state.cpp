@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,13 +17,18 @@
 
 #include "resource_binding_state.h"
 
+#include <algorithm>
+
 namespace vkb
 {
 void ResourceBindingState::reset()
 {
 	clear_dirty();
 
-	resource_sets.clear();
+	for (auto &resource_set : resource_sets)
+	{
+		resource_set.reset();
+	}
 }
 
 bool ResourceBindingState::is_dirty()
@@ -38,103 +43,168 @@ void ResourceBindingState::clear_dirty()
 
 void ResourceBindingState::clear_dirty(uint32_t set)
 {
-	resource_sets[set].clear_dirty();
+	get_resource_set(set).clear_dirty();
 }
 
 void ResourceBindingState::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_buffer(buffer, offset, range, binding, array_element);
+	get_resource_set(set).bind_buffer(buffer, offset, range, binding, array_element);
 
 	dirty = true;
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, sampler, binding, array_element);
+	get_resource_set(set).bind_image(image_view, sampler, binding, array_element);
 
 	dirty = true;
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, binding, array_element);
+	get_resource_set(set).bind_image(image_view, binding, array_element);
 
 	dirty = true;
 }
 
 void ResourceBindingState::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_input(image_view, binding, array_element);
+	get_resource_set(set).bind_input(image_view, binding, array_element);
 
 	dirty = true;
 }
 
-const std::unordered_map<uint32_t, ResourceSet> &ResourceBindingState::get_resource_sets()
+const std::array<ResourceSet, ResourceBindingState::max_resource_sets> &ResourceBindingState::get_resource_sets()
 {
 	return resource_sets;
 }
 
+ResourceSet &ResourceBindingState::get_resource_set(uint32_t set)
+{
+	if (set >= max_resource_sets)
+	{
+		throw std::runtime_error("Descriptor set " + std::to_string(set) + " exceeds the maximum number of resource sets");
+	}
+
+	return resource_sets[set];
+}
+
 void ResourceSet::reset()
 {
 	clear_dirty();
 
-	resource_bindings.clear();
+	resource_count = 0;
 }
 
 bool ResourceSet::is_dirty() const
 {
-	return dirty;
+	return dirty_resources != 0;
 }
 
 void ResourceSet::clear_dirty()
 {
-	dirty = false;
+	dirty_resources = 0;
 }
 
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty = false;
+	uint32_t index = lower_bound(binding, array_element);
+
+	if (index < resource_count && resources[index].binding == binding && resources[index].array_element == array_element)
+	{
+		dirty_resources &= ~(uint64_t{1} << index);
+	}
 }
 
 void ResourceSet::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	auto &resource = resources[find_or_insert(binding, array_element)];
 
-	dirty = true;
+	resource.buffer = &buffer;
+	resource.offset = offset;
+	resource.range  = range;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	auto &resource = resources[find_or_insert(binding, array_element)];
 
-	dirty = true;
+	resource.image_view = &image_view;
+	resource.sampler    = &sampler;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	auto &resource = resources[find_or_insert(binding, array_element)];
 
-	dirty = true;
+	resource.image_view = &image_view;
+	resource.sampler    = nullptr;
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	auto &resource = resources[find_or_insert(binding, array_element)];
 
-	dirty = true;
+	resource.image_view = &image_view;
+}
+
+bool ResourceSet::empty() const
+{
+	return resource_count == 0;
+}
+
+const ResourceInfo *ResourceSet::begin() const
+{
+	return resources.data();
+}
+
+const ResourceInfo *ResourceSet::end() const
+{
+	return resources.data() + resource_count;
 }
 
-const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
+uint32_t ResourceSet::find_or_insert(uint32_t binding, uint32_t array_element)
 {
-	return resource_bindings;
+	uint32_t index = lower_bound(binding, array_element);
+
+	if (index == resource_count || resources[index].binding != binding || resources[index].array_element != array_element)
+	{
+		if (resource_count == max_resources)
+		{
+			throw std::runtime_error("Too many resources bound to a descriptor set, the maximum is " + std::to_string(max_resources));
+		}
+
+		// Make room for the new resource, moving the dirty bits of the following resources along
+		std::move_backward(resources.begin() + index, resources.begin() + resource_count, resources.begin() + resource_count + 1);
+
+		uint64_t lower_mask = (uint64_t{1} << index) - 1;
+		dirty_resources     = (dirty_resources & lower_mask) | ((dirty_resources & ~lower_mask) << 1);
+
+		resources[index]               = {};
+		resources[index].binding       = binding;
+		resources[index].array_element = array_element;
+
+		++resource_count;
+	}
+
+	dirty_resources |= uint64_t{1} << index;
+
+	return index;
 }
 
+uint32_t ResourceSet::lower_bound(uint32_t binding, uint32_t array_element) const
+{
+	// Sets hold few resources, usually bound in order, so check the end first
+	if (resource_count == 0 || resources[resource_count - 1].binding < binding ||
+	    (resources[resource_count - 1].binding == binding && resources[resource_count - 1].array_element < array_element))
+	{
+		return resource_count;
+	}
+
+	auto it = std::lower_bound(begin(), end(), std::make_pair(binding, array_element), [](const ResourceInfo &resource, const std::pair<uint32_t, uint32_t> &key) {
+		return resource.binding < key.first || (resource.binding == key.first && resource.array_element < key.second);
+	});
+
+	return static_cast<uint32_t>(it - begin());
+}
 }        // namespace vkb
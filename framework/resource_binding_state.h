@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "common/vk_common.h"
 #include "core/buffer.h"
 #include "core/image_view.h"
@@ -31,7 +33,9 @@ namespace vkb
  */
 struct ResourceInfo
 {
-	bool dirty{false};
+	uint32_t binding{0};
+
+	uint32_t array_element{0};
 
 	const core::Buffer *buffer{nullptr};
 
@@ -49,10 +53,16 @@ struct ResourceInfo
  *        by a command buffer.
  *
  * The ResourceSet has a one to one mapping with a DescriptorSet.
+ * Resources are stored in a fixed-capacity array sorted by binding and array element,
+ * so binding resources does not allocate and flushing them walks contiguous memory.
+ * Resources bound since the last flush are tracked with one dirty bit each.
  */
 class ResourceSet
 {
   public:
+	/// Maximum number of resources which can be bound to a set
+	static constexpr uint32_t max_resources = 64;
+
 	void reset();
 
 	bool is_dirty() const;
@@ -69,12 +79,34 @@ class ResourceSet
 
 	void bind_input(const core::ImageView &image_view, uint32_t binding, uint32_t array_element);
 
-	const BindingMap<ResourceInfo> &get_resource_bindings() const;
+	bool empty() const;
+
+	/**
+	 * @brief Iterators over the bound resources, sorted by binding and array element
+	 */
+	const ResourceInfo *begin() const;
+
+	const ResourceInfo *end() const;
 
   private:
-	bool dirty{false};
+	/**
+	 * @brief Finds the resource bound to a binding and array element, inserting an empty one if there is none
+	 * @return The index of the resource in the array
+	 */
+	uint32_t find_or_insert(uint32_t binding, uint32_t array_element);
+
+	/**
+	 * @brief Finds the position of a binding and array element in the array
+	 * @return The index of the resource, or of the first resource after it if it is not bound
+	 */
+	uint32_t lower_bound(uint32_t binding, uint32_t array_element) const;
+
+	std::array<ResourceInfo, max_resources> resources;
 
-	BindingMap<ResourceInfo> resource_bindings;
+	uint32_t resource_count{0};
+
+	/// One bit per resource of the array, set if the resource changed since the last flush
+	uint64_t dirty_resources{0};
 };
 
 /**
@@ -82,10 +114,14 @@ class ResourceSet
  *
  * Keeps track of all the resources bound by the command buffer. The ResourceBindingState is used by
  * the command buffer to create the appropriate descriptor sets when it comes to draw.
+ * Sets are stored in a fixed-capacity array indexed by set number.
  */
 class ResourceBindingState
 {
   public:
+	/// Maximum number of descriptor sets resources can be bound to
+	static constexpr uint32_t max_resource_sets = 8;
+
 	void reset();
 
 	bool is_dirty();
@@ -102,11 +138,16 @@ class ResourceBindingState
 
 	void bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
-	const std::unordered_map<uint32_t, ResourceSet> &get_resource_sets();
+	/**
+	 * @brief Returns the resource sets indexed by set number, sets without resources are empty
+	 */
+	const std::array<ResourceSet, max_resource_sets> &get_resource_sets();
 
   private:
+	ResourceSet &get_resource_set(uint32_t set);
+
 	bool dirty{false};
 
-	std::unordered_map<uint32_t, ResourceSet> resource_sets;
+	std::array<ResourceSet, max_resource_sets> resource_sets;
 };
 }        // namespace vkb
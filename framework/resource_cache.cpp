@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,93 +17,608 @@
 
 #include "resource_cache.h"
 
+#include <ctpl_stl.h>
+
 #include "common/resource_caching.h"
 #include "core/device.h"
+#include "filesystem/legacy.h"
+#include "resource_cache_file.h"
 
 namespace vkb
 {
 namespace
 {
-template <class T, class... A>
-T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &... args)
+/**
+ * @brief Finds an object in the cache, or builds it with a given function without holding any lock if it is missing
+ *        New objects are recorded with the arguments they were requested with, before they become visible to other threads.
+ */
+template <class T, class CreateFunc, class... A>
+T &find_or_build_resource(ResourceRecord &recorder, std::mutex &recorder_mutex, ConcurrentResourceMap<T> &resources, CreateFunc &&create, A &... args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	std::size_t hash{0U};
+	hash_param(hash, args...);
+
+	return resources.find_or_create(
+	    hash,
+	    [&]() {
+		    LOGD("Building cache object ({})", typeid(T).name());
 
-	auto &res = request_resource(device, &recorder, resources, args...);
+		    return create();
+	    },
+	    [&](T &resource) {
+		    std::lock_guard<std::mutex> guard(recorder_mutex);
 
-	return res;
+		    RecordHelper<T, A...> record_helper;
+
+		    size_t index = record_helper.record(recorder, args...);
+		    record_helper.index(recorder, index, resource);
+	    });
+}
+
+/**
+ * @brief Finds an object in the cache, or builds it without holding any lock if it is missing
+ */
+template <class T, class... A>
+T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ConcurrentResourceMap<T> &resources, A &... args)
+{
+	return find_or_build_resource(
+	    recorder, recorder_mutex, resources, [&]() { return T(device, args...); }, args...);
 }
 }        // namespace
 
+bool ResourceCache::descriptor_buffers_requested = false;
+
 ResourceCache::ResourceCache(Device &device) :
     device{device}
 {
 }
 
+ResourceCache::~ResourceCache()
+{
+	// Pipelines still compiling use the pipeline cache
+	async_pipeline_pool.reset();
+}
+
 void ResourceCache::warmup(const std::vector<uint8_t> &data)
 {
-	recorder.set_data(data);
+	{
+		std::lock_guard<std::mutex> guard(recorder_mutex);
+
+		recorder.set_data(data);
+	}
 
-	replayer.play(*this, recorder);
+	play_recorded_resources();
 }
 
 std::vector<uint8_t> ResourceCache::serialize()
 {
+	std::lock_guard<std::mutex> guard(recorder_mutex);
+
 	return recorder.get_data();
 }
 
+bool ResourceCache::load(const std::string &filename)
+{
+	std::vector<uint8_t> data;
+
+	try
+	{
+		data = fs::read_temp(filename);
+	}
+	catch (std::runtime_error &ex)
+	{
+		LOGW("No resource cache file found. {}", ex.what());
+		return false;
+	}
+
+	ResourceCacheFile file;
+
+	if (!decode_resource_cache_file(device.get_gpu().get_properties(), data, file))
+	{
+		return false;
+	}
+
+	if (!file.pipeline_cache.empty())
+	{
+		VkPipelineCacheCreateInfo create_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+		create_info.initialDataSize = file.pipeline_cache.size();
+		create_info.pInitialData    = file.pipeline_cache.data();
+
+		VkPipelineCache loaded_pipeline_cache{VK_NULL_HANDLE};
+		VK_CHECK(vkCreatePipelineCache(device.get_handle(), &create_info, nullptr, &loaded_pipeline_cache));
+
+		if (pipeline_cache == VK_NULL_HANDLE)
+		{
+			owned_pipeline_cache = loaded_pipeline_cache;
+			pipeline_cache       = owned_pipeline_cache;
+		}
+		else
+		{
+			VK_CHECK(vkMergePipelineCaches(device.get_handle(), pipeline_cache, 1, &loaded_pipeline_cache));
+			vkDestroyPipelineCache(device.get_handle(), loaded_pipeline_cache, nullptr);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(recorder_mutex);
+
+		recorder.set_data(file.resource_record);
+	}
+
+	replay_pending = true;
+
+	return true;
+}
+
+void ResourceCache::save(const std::string &filename)
+{
+	ResourceCacheFile file;
+
+	file.resource_record = serialize();
+
+	if (pipeline_cache != VK_NULL_HANDLE)
+	{
+		size_t size{};
+		VK_CHECK(vkGetPipelineCacheData(device.get_handle(), pipeline_cache, &size, nullptr));
+
+		file.pipeline_cache.resize(size);
+		VK_CHECK(vkGetPipelineCacheData(device.get_handle(), pipeline_cache, &size, file.pipeline_cache.data()));
+	}
+
+	fs::write_temp(encode_resource_cache_file(device.get_gpu().get_properties(), file), filename);
+}
+
+void ResourceCache::replay_pending_resources()
+{
+	// Only the first request replays, requests made meanwhile by other threads build their objects themselves
+	if (replay_pending.exchange(false))
+	{
+		play_recorded_resources();
+	}
+}
+
+void ResourceCache::play_recorded_resources()
+{
+	// The objects created while replaying are recorded again, so the replay reads a copy of the record
+	auto data = serialize();
+
+	if (replay_thread_count == 1)
+	{
+		replayer.play(*this, data);
+	}
+	else
+	{
+		replayer.play_parallel(*this, data, replay_thread_count);
+	}
+}
+
 void ResourceCache::set_pipeline_cache(VkPipelineCache new_pipeline_cache)
 {
 	pipeline_cache = new_pipeline_cache;
 }
 
+void ResourceCache::set_replay_thread_count(uint32_t thread_count)
+{
+	replay_thread_count = thread_count;
+}
+
+void ResourceCache::set_budget(const ResourceCacheBudget &new_budget)
+{
+	budget = new_budget;
+}
+
+void ResourceCache::begin_frame(uint32_t frames_in_flight)
+{
+	++frame_index;
+
+	state.shader_modules.set_frame(frame_index);
+	state.pipeline_layouts.set_frame(frame_index);
+	state.descriptor_set_layouts.set_frame(frame_index);
+	state.descriptor_pools.set_frame(frame_index);
+	state.render_passes.set_frame(frame_index);
+	state.graphics_pipelines.set_frame(frame_index);
+	state.graphics_pipeline_libraries.set_frame(frame_index);
+	state.compute_pipelines.set_frame(frame_index);
+	state.descriptor_sets.set_frame(frame_index);
+	state.framebuffers.set_frame(frame_index);
+
+	if (frame_index < frames_in_flight)
+	{
+		return;
+	}
+
+	{
+		// Workers compiling pipelines insert into the maps being evicted, eviction waits for a frame where none is running
+		std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+		if (!async_pipelines.empty())
+		{
+			return;
+		}
+	}
+
+	// The frame which last used the slot of the new frame has retired, along with the frames before it
+	uint64_t last_retired_frame = frame_index - frames_in_flight;
+
+	auto evict = [last_retired_frame](auto &resources, size_t capacity, auto &&on_evict) {
+		if (capacity > 0)
+		{
+			if (size_t count = resources.evict(capacity, last_retired_frame, on_evict))
+			{
+				LOGD("Evicted {} cache objects", count);
+			}
+		}
+	};
+
+	auto destroy = [](auto &) {};
+
+	evict(state.graphics_pipelines, budget.graphics_pipelines, destroy);
+	evict(state.compute_pipelines, budget.compute_pipelines, destroy);
+	evict(state.framebuffers, budget.framebuffers, destroy);
+
+	// Descriptor set handles belong to their pool, they have to be given back explicitly
+	evict(state.descriptor_sets, budget.descriptor_sets, [](DescriptorSet &descriptor_set) {
+		descriptor_set.get_descriptor_pool().free(descriptor_set.get_handle());
+	});
+}
+
 ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant)
 {
+	replay_pending_resources();
+
 	std::string entry_point{"main"};
-	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+	return request_resource(device, recorder, recorder_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
-	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
+	replay_pending_resources();
+
+	return request_resource(device, recorder, recorder_mutex, state.pipeline_layouts, shader_modules);
 }
 
 DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const uint32_t                     set_index,
                                                                   const std::vector<ShaderModule *> &shader_modules,
                                                                   const std::vector<ShaderResource> &set_resources)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	replay_pending_resources();
+
+	if (!descriptor_buffers)
+	{
+		return request_resource(device, recorder, recorder_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	}
+
+	return find_or_build_resource(
+	    recorder, recorder_mutex, state.descriptor_set_layouts, [&]() { return DescriptorSetLayout(device, set_index, shader_modules, set_resources, true); }, set_index, shader_modules, set_resources);
 }
 
 GraphicsPipeline &ResourceCache::request_graphics_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	replay_pending_resources();
+
+	if (!graphics_pipeline_library_linking)
+	{
+		return request_resource(device, recorder, recorder_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	}
+
+	// Linked pipelines are cached and recorded like monolithic ones, only their creation differs
+	return find_or_build_resource(
+	    recorder, recorder_mutex, state.graphics_pipelines, [&]() { return link_graphics_pipeline(pipeline_state); }, pipeline_cache, pipeline_state);
+}
+
+bool ResourceCache::set_graphics_pipeline_library_linking(bool enable)
+{
+	if (enable && !device.is_enabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+	{
+		LOGW("{} is not enabled, graphics pipelines are not linked from libraries", VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+		enable = false;
+	}
+
+	if (enable)
+	{
+		auto features = device.get_gpu().get_extension_features<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+
+		if (!features || !features->graphicsPipelineLibrary)
+		{
+			LOGW("graphicsPipelineLibrary feature is not enabled, graphics pipelines are not linked from libraries");
+			enable = false;
+		}
+	}
+
+	graphics_pipeline_library_linking = enable;
+
+	return enable;
+}
+
+bool ResourceCache::set_descriptor_buffers(bool enable)
+{
+	if (enable == descriptor_buffers)
+	{
+		return enable;
+	}
+
+	if (state.descriptor_set_layouts.size() > 0)
+	{
+		// Existing layouts, and the pipelines created from them, cannot be mixed with the new ones
+		LOGW("Descriptor set layouts were already created, descriptor buffers can no longer be {}", enable ? "enabled" : "disabled");
+		return descriptor_buffers;
+	}
+
+	if (enable && (!device.is_enabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) || !device.is_enabled(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME)))
+	{
+		LOGW("{} or {} is not enabled, descriptor sets are used instead of descriptor buffers", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+		return false;
+	}
+
+	if (enable)
+	{
+		auto features = device.get_gpu().get_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+
+		if (!features || !features->descriptorBuffer)
+		{
+			LOGW("descriptorBuffer feature is not enabled, descriptor sets are used instead of descriptor buffers");
+			return false;
+		}
+
+		VkPhysicalDeviceProperties2KHR properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+		properties.pNext = &descriptor_buffer_properties;
+
+		vkGetPhysicalDeviceProperties2KHR(device.get_gpu().get_handle(), &properties);
+	}
+
+	descriptor_buffers = enable;
+
+	return enable;
+}
+
+bool ResourceCache::uses_descriptor_buffers() const
+{
+	return descriptor_buffers;
+}
+
+const VkPhysicalDeviceDescriptorBufferPropertiesEXT &ResourceCache::get_descriptor_buffer_properties() const
+{
+	return descriptor_buffer_properties;
+}
+
+GraphicsPipeline ResourceCache::link_graphics_pipeline(PipelineState &pipeline_state)
+{
+	std::vector<const GraphicsPipeline *> libraries;
+
+	// Each part is looked up separately, so pipelines which only differ in one part share the libraries of the others
+	for (VkGraphicsPipelineLibraryFlagsEXT part : {VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+	                                               VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+	                                               VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+	                                               VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT})
+	{
+		auto &library = state.graphics_pipeline_libraries.find_or_create(
+		    hash_graphics_pipeline_library(pipeline_state, part),
+		    [&]() { return GraphicsPipeline(device, pipeline_cache, pipeline_state, part); },
+		    [](GraphicsPipeline &) {});
+
+		libraries.push_back(&library);
+	}
+
+	return GraphicsPipeline(device, pipeline_cache, pipeline_state, libraries);
+}
+
+void ResourceCache::set_async_pipeline_thread_count(uint32_t thread_count)
+{
+	wait_for_async_pipelines();
+
+	async_pipeline_pool.reset();
+
+	if (thread_count > 0)
+	{
+		async_pipeline_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+	}
+}
+
+GraphicsPipeline *ResourceCache::request_graphics_pipeline_async(PipelineState &pipeline_state, bool &ready)
+{
+	ready = true;
+
+	if (!async_pipeline_pool)
+	{
+		return &request_graphics_pipeline(pipeline_state);
+	}
+
+	replay_pending_resources();
+
+	std::size_t hash{0U};
+	hash_param(hash, pipeline_cache, pipeline_state);
+
+	if (auto pipeline = state.graphics_pipelines.touch(hash))
+	{
+		return pipeline;
+	}
+
+	std::unique_lock<std::mutex> lock(async_pipeline_mutex);
+
+	if (failed_async_pipelines.erase(hash))
+	{
+		// Compile it again on this thread, so that the error reaches the caller
+		lock.unlock();
+
+		return &request_graphics_pipeline(pipeline_state);
+	}
+
+	if (async_pipelines.insert(hash).second)
+	{
+		// The render pass and pipeline layout referenced by the state are cached, so they outlive the compilation
+		async_pipeline_pool->push([this, hash, pipeline_state](size_t) mutable {
+			bool failed = false;
+
+			try
+			{
+				request_graphics_pipeline(pipeline_state);
+			}
+			catch (const std::exception &e)
+			{
+				LOGE("Asynchronous pipeline compilation failed: {}", e.what());
+				failed = true;
+			}
+
+			{
+				std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+				async_pipelines.erase(hash);
+
+				if (failed)
+				{
+					failed_async_pipelines.insert(hash);
+				}
+			}
+
+			async_pipeline_done.notify_all();
+		});
+	}
+
+	ready = false;
+
+	auto fallback_it = fallback_pipelines.find(get_fallback_key(pipeline_state));
+
+	if (fallback_it == fallback_pipelines.end())
+	{
+		return nullptr;
+	}
+
+	// The fallback pipeline is requested again, as it may have been evicted
+	PipelineState fallback_state = fallback_it->second;
+
+	lock.unlock();
+
+	return &request_graphics_pipeline(fallback_state);
+}
+
+void ResourceCache::register_fallback_pipeline(PipelineState &pipeline_state)
+{
+	request_graphics_pipeline(pipeline_state);
+
+	std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+	fallback_pipelines[get_fallback_key(pipeline_state)] = pipeline_state;
+}
+
+void ResourceCache::wait_for_async_pipelines()
+{
+	std::unique_lock<std::mutex> lock(async_pipeline_mutex);
+
+	async_pipeline_done.wait(lock, [this]() { return async_pipelines.empty(); });
+}
+
+size_t ResourceCache::get_fallback_key(const PipelineState &pipeline_state)
+{
+	size_t key{0U};
+
+	hash_combine(key, pipeline_state.get_render_pass());
+	hash_combine(key, pipeline_state.get_subpass_index());
+
+	// Pipeline layouts are cached by shader modules, so a fallback with other shaders is matched by the
+	// contents of its layout instead. Bindings and ranges are collected from hash maps in no particular
+	// order, so their hashes are summed.
+	auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+
+	std::vector<uint32_t> set_indices;
+	for (auto &shader_set : pipeline_layout.get_shader_sets())
+	{
+		set_indices.push_back(shader_set.first);
+	}
+	std::sort(set_indices.begin(), set_indices.end());
+
+	for (uint32_t set_index : set_indices)
+	{
+		size_t bindings_key{0U};
+
+		for (auto &binding : pipeline_layout.get_descriptor_set_layout(set_index).get_bindings())
+		{
+			size_t binding_key{0U};
+			hash_combine(binding_key, binding.binding);
+			hash_combine(binding_key, binding.descriptorType);
+			hash_combine(binding_key, binding.descriptorCount);
+			hash_combine(binding_key, binding.stageFlags);
+
+			bindings_key += binding_key;
+		}
+
+		hash_combine(key, set_index);
+		hash_combine(key, bindings_key);
+	}
+
+	size_t push_constants_key{0U};
+
+	for (auto &push_constant : pipeline_layout.get_resources(ShaderResourceType::PushConstant))
+	{
+		size_t range_key{0U};
+		hash_combine(range_key, push_constant.stages);
+		hash_combine(range_key, push_constant.offset);
+		hash_combine(range_key, push_constant.size);
+
+		push_constants_key += range_key;
+	}
+
+	hash_combine(key, push_constants_key);
+
+	return key;
 }
 
 ComputePipeline &ResourceCache::request_compute_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	replay_pending_resources();
+
+	return request_resource(device, recorder, recorder_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
 }
 
 DescriptorSet &ResourceCache::request_descriptor_set(DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
-	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	replay_pending_resources();
+
+	// Sets over budget are freed, pools only support it if there is a budget
+	bool free_descriptor_sets = budget.descriptor_sets > 0;
+
+	auto &descriptor_pool = find_or_build_resource(
+	    recorder, recorder_mutex, state.descriptor_pools, [&]() { return DescriptorPool(device, descriptor_set_layout, DescriptorPool::MAX_SETS_PER_POOL, free_descriptor_sets); }, descriptor_set_layout, free_descriptor_sets);
+
+	std::size_t hash{0U};
+	hash_param(hash, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+
+	return state.descriptor_sets.find_or_create(
+	    hash,
+	    [&]() {
+		    // Descriptor sets sharing a pool cannot be allocated concurrently
+		    std::lock_guard<std::mutex> guard(descriptor_set_mutex);
+
+		    return DescriptorSet(device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	    },
+	    [](DescriptorSet &) {});
 }
 
 RenderPass &ResourceCache::request_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
 {
-	return request_resource(device, recorder, render_pass_mutex, state.render_passes, attachments, load_store_infos, subpasses);
+	replay_pending_resources();
+
+	return request_resource(device, recorder, recorder_mutex, state.render_passes, attachments, load_store_infos, subpasses);
 }
 
 Framebuffer &ResourceCache::request_framebuffer(const RenderTarget &render_target, const RenderPass &render_pass)
 {
-	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
+	replay_pending_resources();
+
+	return request_resource(device, recorder, recorder_mutex, state.framebuffers, render_target, render_pass);
 }
 
 void ResourceCache::clear_pipelines()
 {
+	wait_for_async_pipelines();
+
+	{
+		std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+		fallback_pipelines.clear();
+	}
+
 	state.graphics_pipelines.clear();
+	state.graphics_pipeline_libraries.clear();
 	state.compute_pipelines.clear();
 }
 
@@ -118,11 +633,7 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 		auto &old_view = old_views[i];
 		auto &new_view = new_views[i];
 
-		for (auto &kd_pair : state.descriptor_sets)
-		{
-			auto &key            = kd_pair.first;
-			auto &descriptor_set = kd_pair.second;
-
+		state.descriptor_sets.for_each([&](size_t key, DescriptorSet &descriptor_set) {
 			auto &image_infos = descriptor_set.get_image_infos();
 
 			for (auto &ba_pair : image_infos)
@@ -166,7 +677,7 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 					}
 				}
 			}
-		}
+		});
 	}
 
 	if (!set_updates.empty())
@@ -175,20 +686,16 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 		                       0, nullptr);
 	}
 
-	// Delete old entries (moved out descriptor sets)
+	// Move updated descriptor sets to their new keys
 	for (auto &match : matches)
 	{
-		// Move out of the map
-		auto it             = state.descriptor_sets.find(match);
-		auto descriptor_set = std::move(it->second);
-		state.descriptor_sets.erase(match);
+		auto descriptor_set = state.descriptor_sets.find(match);
 
 		// Generate new key
 		size_t new_key = 0U;
-		hash_param(new_key, descriptor_set.get_layout(), descriptor_set.get_buffer_infos(), descriptor_set.get_image_infos());
+		hash_param(new_key, descriptor_set->get_layout(), descriptor_set->get_buffer_infos(), descriptor_set->get_image_infos());
 
-		// Add (key, resource) to the cache
-		state.descriptor_sets.emplace(new_key, std::move(descriptor_set));
+		state.descriptor_sets.rehash(match, new_key);
 	}
 }
 
@@ -199,6 +706,10 @@ void ResourceCache::clear_framebuffers()
 
 void ResourceCache::clear()
 {
+	// Workers compiling pipelines read the layouts and render passes destroyed below
+	wait_for_async_pipelines();
+	async_pipeline_pool.reset();
+
 	state.shader_modules.clear();
 	state.pipeline_layouts.clear();
 	state.descriptor_sets.clear();
@@ -206,6 +717,18 @@ void ResourceCache::clear()
 	state.render_passes.clear();
 	clear_pipelines();
 	clear_framebuffers();
+
+	// The device owning the pipeline cache is destroyed right after the cache is cleared
+	if (owned_pipeline_cache != VK_NULL_HANDLE)
+	{
+		if (pipeline_cache == owned_pipeline_cache)
+		{
+			pipeline_cache = VK_NULL_HANDLE;
+		}
+
+		vkDestroyPipelineCache(device.get_handle(), owned_pipeline_cache, nullptr);
+		owned_pipeline_cache = VK_NULL_HANDLE;
+	}
 }
 
 const ResourceCacheState &ResourceCache::get_internal_state() const
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,10 +17,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "common/concurrent_resource_map.h"
 #include "common/helpers.h"
 #include "core/descriptor_pool.h"
 #include "core/descriptor_set.h"
@@ -30,6 +36,11 @@
 #include "resource_record.h"
 #include "resource_replay.h"
 
+namespace ctpl
+{
+class thread_pool;
+}
+
 namespace vkb
 {
 class Device;
@@ -45,40 +56,74 @@ class ImageView;
  */
 struct ResourceCacheState
 {
-	std::unordered_map<std::size_t, ShaderModule> shader_modules;
+	ConcurrentResourceMap<ShaderModule> shader_modules;
 
-	std::unordered_map<std::size_t, PipelineLayout> pipeline_layouts;
+	ConcurrentResourceMap<PipelineLayout> pipeline_layouts;
 
-	std::unordered_map<std::size_t, DescriptorSetLayout> descriptor_set_layouts;
+	ConcurrentResourceMap<DescriptorSetLayout> descriptor_set_layouts;
 
-	std::unordered_map<std::size_t, DescriptorPool> descriptor_pools;
+	ConcurrentResourceMap<DescriptorPool> descriptor_pools;
 
-	std::unordered_map<std::size_t, RenderPass> render_passes;
+	ConcurrentResourceMap<RenderPass> render_passes;
 
-	std::unordered_map<std::size_t, GraphicsPipeline> graphics_pipelines;
+	ConcurrentResourceMap<GraphicsPipeline> graphics_pipelines;
 
-	std::unordered_map<std::size_t, ComputePipeline> compute_pipelines;
+	/// Graphics pipeline libraries of a single part each, by hash of the state of that part
+	ConcurrentResourceMap<GraphicsPipeline> graphics_pipeline_libraries;
 
-	std::unordered_map<std::size_t, DescriptorSet> descriptor_sets;
+	ConcurrentResourceMap<ComputePipeline> compute_pipelines;
 
-	std::unordered_map<std::size_t, Framebuffer> framebuffers;
+	ConcurrentResourceMap<DescriptorSet> descriptor_sets;
+
+	ConcurrentResourceMap<Framebuffer> framebuffers;
+};
+
+/**
+ * @brief Maximum number of objects of each type kept in the Resource Cache, 0 meaning unlimited
+ *        Only the types which are not referenced by other cached objects can be evicted.
+ */
+struct ResourceCacheBudget
+{
+	size_t graphics_pipelines{0};
+
+	size_t compute_pipelines{0};
+
+	size_t descriptor_sets{0};
+
+	size_t framebuffers{0};
 };
 
 /**
  * @brief Cache all sorts of Vulkan objects specific to a Vulkan device.
  * Supports serialization and deserialization of cached resources.
- * There is only one cache for all these objects, with several unordered_map of hash indices
+ * There is only one cache for all these objects, with several ConcurrentResourceMap of hash indices
  * and objects. For every object requested, there is a templated version on request_resource.
- * Some objects may need building if they are not found in the cache.
+ * Some objects may need building if they are not found in the cache. Lookups of cached objects
+ * from different threads do not block each other, and objects are built without holding any lock.
  *
  * The resource cache is also linked with ResourceRecord and ResourceReplay. Replay can warm-up
  * the cache on app startup by creating all necessary objects.
+ * The recorded objects and the pipeline cache data can be persisted to disk with save() and
+ * restored with load(), in which case they are replayed lazily on the first request.
  * The cache holds pointers to objects and has a mapping from such pointers to hashes.
- * It can only be destroyed in bulk, single elements cannot be removed.
+ * Pipelines, descriptor sets and framebuffers can be given a budget, in which case the least
+ * recently used ones are evicted in begin_frame() once the frames using them have retired.
+ * Other objects are referenced by cached objects and can only be destroyed in bulk.
+ *
+ * Graphics pipelines can also be compiled asynchronously on worker threads, in which case
+ * request_graphics_pipeline_async() returns a registered fallback pipeline, or nothing,
+ * until the requested pipeline is ready.
+ *
+ * With VK_EXT_graphics_pipeline_library, graphics pipelines can instead be linked from libraries
+ * of their vertex input, pre-rasterization, fragment shader and fragment output parts. Each
+ * library is cached separately, so only the parts which differ from existing pipelines are compiled.
  */
 class ResourceCache
 {
   public:
+	/// Set with the --descriptor-buffers command line flag, samples supporting descriptor buffers then enable them
+	static bool descriptor_buffers_requested;
+
 	ResourceCache(Device &device);
 
 	ResourceCache(const ResourceCache &) = delete;
@@ -89,12 +134,54 @@ class ResourceCache
 
 	ResourceCache &operator=(ResourceCache &&) = delete;
 
+	~ResourceCache();
+
 	void warmup(const std::vector<uint8_t> &data);
 
 	std::vector<uint8_t> serialize();
 
+	/**
+	 * @brief Loads a resource cache file written by save()
+	 *        The pipeline cache data is merged into the current pipeline cache, or into a new
+	 *        pipeline cache owned by this resource cache if none was set. The recorded objects
+	 *        are not created here, they are replayed on the first request to the cache.
+	 *        Should be called before any object is requested.
+	 * @param filename The path to the file (relative to the temporary storage directory)
+	 * @return False if the file does not exist or was rejected
+	 */
+	bool load(const std::string &filename);
+
+	/**
+	 * @brief Writes the recorded objects and the current pipeline cache data to a resource cache file
+	 * @param filename The path to the file (relative to the temporary storage directory)
+	 */
+	void save(const std::string &filename);
+
 	void set_pipeline_cache(VkPipelineCache pipeline_cache);
 
+	/**
+	 * @brief Sets the number of threads used to replay recorded objects in warmup() and after load()
+	 * @param thread_count 1 to replay serially on the calling thread (default), 0 to use one thread per hardware thread
+	 */
+	void set_replay_thread_count(uint32_t thread_count);
+
+	/**
+	 * @brief Sets the maximum number of objects of each type kept in the cache
+	 *        Objects over budget are evicted by the next calls to begin_frame().
+	 *        The descriptor set budget should be set before any descriptor set is requested, the sets
+	 *        allocated before from pools which cannot free them are never given back to their pool.
+	 */
+	void set_budget(const ResourceCacheBudget &new_budget);
+
+	/**
+	 * @brief Starts a new frame, and evicts the least recently used objects of the types over budget
+	 *        Objects used by one of the frames in flight are kept until the fence of that frame has been waited on.
+	 *        Nothing is evicted while pipelines are being compiled asynchronously.
+	 *        Must not be called while other threads are requesting objects.
+	 * @param frames_in_flight The number of frames which may still be executing on the GPU
+	 */
+	void begin_frame(uint32_t frames_in_flight);
+
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
@@ -105,6 +192,68 @@ class ResourceCache
 
 	GraphicsPipeline &request_graphics_pipeline(PipelineState &pipeline_state);
 
+	/**
+	 * @brief Sets whether missing graphics pipelines are linked from cached pipeline libraries instead of being fully compiled
+	 *        Linking is done without link time optimization, trading some GPU performance for much faster pipeline creation.
+	 *        Requires VK_EXT_graphics_pipeline_library with the graphicsPipelineLibrary feature.
+	 * @param enable True to link pipelines from libraries, false to create monolithic pipelines (default)
+	 * @return True if pipelines are linked from libraries from now on
+	 */
+	bool set_graphics_pipeline_library_linking(bool enable);
+
+	/**
+	 * @brief Sets whether descriptors are written to descriptor buffers (VK_EXT_descriptor_buffer) instead of descriptor sets
+	 *        Descriptor set layouts, and the pipelines using them, are then created for descriptor buffers, and command
+	 *        buffers write the descriptors to a buffer of the render frame instead of allocating descriptor sets.
+	 *        Must be called before any descriptor set layout is requested, and before the render frames are created,
+	 *        for example in an override of VulkanSample::create_device. Requires VK_EXT_descriptor_buffer with the
+	 *        descriptorBuffer feature, and VK_KHR_buffer_device_address with the bufferDeviceAddress feature.
+	 *        Uniform and storage buffers created from then on get VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, and
+	 *        binding a buffer without it throws.
+	 * @param enable True to use descriptor buffers, false to use descriptor sets (default)
+	 * @return True if descriptor buffers are used from now on
+	 */
+	bool set_descriptor_buffers(bool enable);
+
+	bool uses_descriptor_buffers() const;
+
+	/**
+	 * @brief Returns the descriptor buffer properties of the device, only valid if descriptor buffers are used
+	 */
+	const VkPhysicalDeviceDescriptorBufferPropertiesEXT &get_descriptor_buffer_properties() const;
+
+	/**
+	 * @brief Sets the number of worker threads compiling the pipelines requested with request_graphics_pipeline_async()
+	 *        Waits for the pipelines being compiled by the previous workers.
+	 * @param thread_count The number of worker threads, 0 to compile pipelines synchronously (default)
+	 */
+	void set_async_pipeline_thread_count(uint32_t thread_count);
+
+	/**
+	 * @brief Requests a graphics pipeline without waiting for its compilation
+	 *        If the pipeline is missing and asynchronous compilation is enabled, it is compiled on a worker thread.
+	 *        Meanwhile, the fallback pipeline registered for a compatible pipeline layout, the same render pass and subpass is returned.
+	 *        If asynchronous compilation is disabled, behaves like request_graphics_pipeline().
+	 * @param pipeline_state The state of the pipeline
+	 * @param ready Set to false if the requested pipeline is not ready yet
+	 * @return The pipeline, its fallback, or nullptr if the pipeline is not ready and has no fallback
+	 */
+	GraphicsPipeline *request_graphics_pipeline_async(PipelineState &pipeline_state, bool &ready);
+
+	/**
+	 * @brief Registers a pipeline to use instead of the pipelines being compiled asynchronously
+	 *        which share its render pass and subpass, and whose pipeline layout has the same descriptor
+	 *        set bindings and push constant ranges, like an uber shader pipeline.
+	 *        The fallback pipeline itself is compiled synchronously.
+	 * @param pipeline_state The state of the fallback pipeline
+	 */
+	void register_fallback_pipeline(PipelineState &pipeline_state);
+
+	/**
+	 * @brief Waits until all the pipelines being compiled asynchronously are ready
+	 */
+	void wait_for_async_pipelines();
+
 	ComputePipeline &request_compute_pipeline(PipelineState &pipeline_state);
 
 	DescriptorSet &request_descriptor_set(DescriptorSetLayout &                     descriptor_set_layout,
@@ -127,11 +276,27 @@ class ResourceCache
 
 	void clear_framebuffers();
 
+	/**
+	 * @brief Destroys all cached objects, along with the pipeline cache created by load()
+	 *        Waits for the pipelines being compiled asynchronously, and stops the worker threads.
+	 *        Must be called before the device is destroyed.
+	 */
 	void clear();
 
 	const ResourceCacheState &get_internal_state() const;
 
   private:
+	/// @brief Replays the objects of a loaded resource cache file, if any are still pending
+	void replay_pending_resources();
+
+	void play_recorded_resources();
+
+	/// @brief Hash of the pipeline layout contents, render pass and subpass a fallback pipeline can replace
+	static size_t get_fallback_key(const PipelineState &pipeline_state);
+
+	/// @brief Creates a graphics pipeline by linking the libraries of its parts, building the missing ones
+	GraphicsPipeline link_graphics_pipeline(PipelineState &pipeline_state);
+
 	Device &device;
 
 	ResourceRecord recorder;
@@ -140,22 +305,45 @@ class ResourceCache
 
 	VkPipelineCache pipeline_cache{VK_NULL_HANDLE};
 
+	/// Pipeline cache created by load() when none was set
+	VkPipelineCache owned_pipeline_cache{VK_NULL_HANDLE};
+
 	ResourceCacheState state;
 
-	std::mutex descriptor_set_mutex;
+	std::atomic<bool> replay_pending{false};
 
-	std::mutex pipeline_layout_mutex;
+	uint32_t replay_thread_count{1};
+
+	ResourceCacheBudget budget;
+
+	bool graphics_pipeline_library_linking{false};
+
+	bool descriptor_buffers{false};
+
+	VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT};
+
+	/// Index of the current frame, objects requested before the first frame belong to frame 0
+	uint64_t frame_index{0};
+
+	std::mutex recorder_mutex;
+
+	std::mutex descriptor_set_mutex;
 
-	std::mutex shader_module_mutex;
+	/// Guards the state of asynchronous pipeline compilation below
+	std::mutex async_pipeline_mutex;
 
-	std::mutex descriptor_set_layout_mutex;
+	std::condition_variable async_pipeline_done;
 
-	std::mutex graphics_pipeline_mutex;
+	/// Hashes of the pipelines being compiled asynchronously
+	std::unordered_set<size_t> async_pipelines;
 
-	std::mutex render_pass_mutex;
+	/// Hashes of the pipelines which failed to compile asynchronously, they are compiled synchronously to report the error
+	std::unordered_set<size_t> failed_async_pipelines;
 
-	std::mutex compute_pipeline_mutex;
+	/// States of the fallback pipelines by pipeline layout contents, render pass and subpass
+	std::unordered_map<size_t, PipelineState> fallback_pipelines;
 
-	std::mutex framebuffer_mutex;
+	/// Workers compiling pipelines asynchronously, destroyed first so that no compilation outlives the cache
+	std::unique_ptr<ctpl::thread_pool> async_pipeline_pool;
 };
 }        // namespace vkb
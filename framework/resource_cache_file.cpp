@@ -0,0 +1,195 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resource_cache_file.h"
+
+#include <cstring>
+
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+namespace
+{
+// "VKBC" in little endian
+constexpr uint32_t cache_file_magic = 0x43424B56;
+
+// Bump whenever the layout of the file or of the ResourceRecord stream changes
+constexpr uint32_t cache_file_format_version = 1;
+
+enum class CacheFileSection : uint32_t
+{
+	ResourceRecord = 1,
+	PipelineCache  = 2
+};
+
+uint64_t checksum(const uint8_t *data, size_t size)
+{
+	// FNV-1a
+	uint64_t result = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		result ^= data[i];
+		result *= 0x100000001b3ULL;
+	}
+
+	return result;
+}
+
+void write_section(std::ostringstream &os, CacheFileSection section, const std::vector<uint8_t> &payload)
+{
+	write(os,
+	      section,
+	      static_cast<uint64_t>(payload.size()));
+
+	os.write(reinterpret_cast<const char *>(payload.data()), payload.size());
+
+	write(os, checksum(payload.data(), payload.size()));
+}
+
+bool read_section(std::istringstream &is, size_t remaining, CacheFileSection &section, std::vector<uint8_t> &payload)
+{
+	uint64_t size{};
+
+	read(is,
+	     section,
+	     size);
+
+	// The header and checksum of the section are part of the remaining bytes
+	const size_t overhead = sizeof(section) + sizeof(size) + sizeof(uint64_t);
+
+	if (!is || remaining < overhead || size > remaining - overhead)
+	{
+		return false;
+	}
+
+	payload.resize(static_cast<size_t>(size));
+	is.read(reinterpret_cast<char *>(payload.data()), payload.size());
+
+	uint64_t expected_checksum{};
+	read(is, expected_checksum);
+
+	return is && checksum(payload.data(), payload.size()) == expected_checksum;
+}
+}        // namespace
+
+std::vector<uint8_t> encode_resource_cache_file(const VkPhysicalDeviceProperties &properties, const ResourceCacheFile &file)
+{
+	std::ostringstream stream;
+
+	write(stream,
+	      cache_file_magic,
+	      cache_file_format_version,
+	      properties.vendorID,
+	      properties.deviceID,
+	      properties.driverVersion);
+
+	stream.write(reinterpret_cast<const char *>(properties.pipelineCacheUUID), VK_UUID_SIZE);
+
+	uint32_t section_count = file.pipeline_cache.empty() ? 1 : 2;
+	write(stream, section_count);
+
+	write_section(stream, CacheFileSection::ResourceRecord, file.resource_record);
+
+	if (!file.pipeline_cache.empty())
+	{
+		write_section(stream, CacheFileSection::PipelineCache, file.pipeline_cache);
+	}
+
+	std::string str = stream.str();
+
+	return std::vector<uint8_t>{str.begin(), str.end()};
+}
+
+bool decode_resource_cache_file(const VkPhysicalDeviceProperties &properties, const std::vector<uint8_t> &data, ResourceCacheFile &file)
+{
+	std::istringstream stream{std::string{data.begin(), data.end()}};
+
+	uint32_t magic{};
+	uint32_t format_version{};
+	uint32_t vendor_id{};
+	uint32_t device_id{};
+	uint32_t driver_version{};
+	uint8_t  pipeline_cache_uuid[VK_UUID_SIZE]{};
+	uint32_t section_count{};
+
+	read(stream,
+	     magic,
+	     format_version,
+	     vendor_id,
+	     device_id,
+	     driver_version);
+
+	stream.read(reinterpret_cast<char *>(pipeline_cache_uuid), VK_UUID_SIZE);
+
+	read(stream, section_count);
+
+	if (!stream || magic != cache_file_magic)
+	{
+		LOGW("Resource cache file is not valid");
+		return false;
+	}
+
+	if (format_version != cache_file_format_version)
+	{
+		LOGW("Resource cache file format version {} does not match {}", format_version, cache_file_format_version);
+		return false;
+	}
+
+	if (vendor_id != properties.vendorID ||
+	    device_id != properties.deviceID ||
+	    driver_version != properties.driverVersion ||
+	    std::memcmp(pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		LOGW("Resource cache file was written by another device or driver version");
+		return false;
+	}
+
+	file = {};
+
+	for (uint32_t i = 0; i < section_count; ++i)
+	{
+		CacheFileSection     section{};
+		std::vector<uint8_t> payload;
+
+		auto offset = stream.tellg();
+
+		if (offset < 0 || !read_section(stream, data.size() - static_cast<size_t>(offset), section, payload))
+		{
+			LOGW("Resource cache file section #{} is corrupted", i);
+			return false;
+		}
+
+		switch (section)
+		{
+			case CacheFileSection::ResourceRecord:
+				file.resource_record = std::move(payload);
+				break;
+			case CacheFileSection::PipelineCache:
+				file.pipeline_cache = std::move(payload);
+				break;
+			default:
+				// Unknown sections are skipped
+				break;
+		}
+	}
+
+	return true;
+}
+}        // namespace vkb
@@ -0,0 +1,57 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief Contents of a persistent resource cache file
+ */
+struct ResourceCacheFile
+{
+	/// Serialized ResourceRecord stream
+	std::vector<uint8_t> resource_record;
+
+	/// Driver data of the pipeline cache, as returned by vkGetPipelineCacheData
+	std::vector<uint8_t> pipeline_cache;
+};
+
+/**
+ * @brief Encodes a resource cache file in a versioned binary format.
+ *        The header identifies the device and driver which wrote the file,
+ *        and every section is followed by a checksum of its payload.
+ * @param properties Properties of the physical device the resources were created on
+ * @param file The contents to encode
+ * @return The binary representation of the file
+ */
+std::vector<uint8_t> encode_resource_cache_file(const VkPhysicalDeviceProperties &properties, const ResourceCacheFile &file);
+
+/**
+ * @brief Decodes a resource cache file written by encode_resource_cache_file
+ * @param properties Properties of the physical device the resources will be created on
+ * @param data The binary representation of the file
+ * @param file The decoded contents
+ * @return False if the file is malformed, corrupted, or was written by another device,
+ *         driver or format version. In that case it should be discarded.
+ */
+bool decode_resource_cache_file(const VkPhysicalDeviceProperties &properties, const std::vector<uint8_t> &data, ResourceCacheFile &file);
+}        // namespace vkb
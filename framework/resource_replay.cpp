@@ -17,6 +17,8 @@
 
 #include "resource_replay.h"
 
+#include <ctpl_stl.h>
+
 #include "common/vk_common.h"
 #include "core/util/logging.hpp"
 #include "rendering/pipeline_state.h"
@@ -52,15 +54,77 @@ inline void read_processes(std::istringstream &is, std::vector<std::string> &val
 
 ResourceReplay::ResourceReplay()
 {
-	stream_resources[ResourceType::ShaderModule]     = std::bind(&ResourceReplay::create_shader_module, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::PipelineLayout]   = std::bind(&ResourceReplay::create_pipeline_layout, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::RenderPass]       = std::bind(&ResourceReplay::create_render_pass, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::GraphicsPipeline] = std::bind(&ResourceReplay::create_graphics_pipeline, this, std::placeholders::_1, std::placeholders::_2);
+	stream_resources[ResourceType::ShaderModule]     = std::bind(&ResourceReplay::read_shader_module, this, std::placeholders::_1);
+	stream_resources[ResourceType::PipelineLayout]   = std::bind(&ResourceReplay::read_pipeline_layout, this, std::placeholders::_1);
+	stream_resources[ResourceType::RenderPass]       = std::bind(&ResourceReplay::read_render_pass, this, std::placeholders::_1);
+	stream_resources[ResourceType::GraphicsPipeline] = std::bind(&ResourceReplay::read_graphics_pipeline, this, std::placeholders::_1);
+
+	dependency_levels[ResourceType::ShaderModule]     = 0;
+	dependency_levels[ResourceType::RenderPass]       = 0;
+	dependency_levels[ResourceType::PipelineLayout]   = 1;
+	dependency_levels[ResourceType::GraphicsPipeline] = 2;
+}
+
+void ResourceReplay::play(ResourceCache &resource_cache, const std::vector<uint8_t> &data)
+{
+	for (auto &level : read_all(data))
+	{
+		for (auto &create : level)
+		{
+			create(resource_cache);
+		}
+	}
 }
 
-void ResourceReplay::play(ResourceCache &resource_cache, ResourceRecord &recorder)
+void ResourceReplay::play_parallel(ResourceCache &resource_cache, const std::vector<uint8_t> &data, uint32_t thread_count)
 {
-	std::istringstream stream{recorder.get_stream().str()};
+	if (thread_count == 0)
+	{
+		thread_count = std::thread::hardware_concurrency();
+		thread_count = thread_count == 0 ? 1 : thread_count;
+	}
+
+	auto levels = read_all(data);
+
+	ctpl::thread_pool thread_pool(thread_count);
+
+	for (auto &level : levels)
+	{
+		std::vector<std::future<void>> futures;
+		futures.reserve(level.size());
+
+		for (auto &create : level)
+		{
+			futures.push_back(thread_pool.push(
+			    [&resource_cache, &create](size_t) {
+				    create(resource_cache);
+			    }));
+		}
+
+		// Objects of the next level depend on the objects of this one
+		for (auto &future : futures)
+		{
+			future.wait();
+		}
+
+		// Rethrow creation errors, if any
+		for (auto &future : futures)
+		{
+			future.get();
+		}
+	}
+}
+
+std::vector<std::vector<ResourceReplay::CreateFunc>> ResourceReplay::read_all(const std::vector<uint8_t> &data)
+{
+	shader_modules.clear();
+	pipeline_layouts.clear();
+	render_passes.clear();
+	graphics_pipelines.clear();
+
+	std::vector<std::vector<CreateFunc>> levels;
+
+	std::istringstream stream{std::string{data.begin(), data.end()}};
 
 	while (true)
 	{
@@ -79,17 +143,27 @@ void ResourceReplay::play(ResourceCache &resource_cache, ResourceRecord &recorde
 		// Check if command replayer supports the given command
 		if (cmd_it != stream_resources.end())
 		{
+			uint32_t level = dependency_levels.at(resource_type);
+
+			if (levels.size() <= level)
+			{
+				levels.resize(level + 1);
+			}
+
 			// Run command function
-			cmd_it->second(resource_cache, stream);
+			levels[level].push_back(cmd_it->second(stream));
 		}
 		else
 		{
 			LOGE("Replay command not supported.");
+			break;
 		}
 	}
+
+	return levels;
 }
 
-void ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::CreateFunc ResourceReplay::read_shader_module(std::istringstream &stream)
 {
 	VkShaderStageFlagBits    stage{};
 	std::string              glsl_source;
@@ -109,33 +183,39 @@ void ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::is
 	shader_source.set_source(std::move(glsl_source));
 	ShaderVariant shader_variant(std::move(preamble), std::move(processes));
 
-	auto &shader_module = resource_cache.request_shader_module(stage, shader_source, shader_variant);
+	size_t index = shader_modules.size();
+	shader_modules.push_back(nullptr);
 
-	shader_modules.push_back(&shader_module);
+	return [this, index, stage, shader_source, shader_variant](ResourceCache &resource_cache) {
+		shader_modules[index] = &resource_cache.request_shader_module(stage, shader_source, shader_variant);
+	};
 }
 
-void ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::CreateFunc ResourceReplay::read_pipeline_layout(std::istringstream &stream)
 {
 	std::vector<size_t> shader_indices;
 
 	read(stream,
 	     shader_indices);
 
-	std::vector<ShaderModule *> shader_stages(shader_indices.size());
-	std::transform(shader_indices.begin(),
-	               shader_indices.end(),
-	               shader_stages.begin(),
-	               [&](size_t shader_index) {
-		               assert(shader_index < shader_modules.size());
-		               return shader_modules[shader_index];
-	               });
-
-	auto &pipeline_layout = resource_cache.request_pipeline_layout(shader_stages);
-
-	pipeline_layouts.push_back(&pipeline_layout);
+	size_t index = pipeline_layouts.size();
+	pipeline_layouts.push_back(nullptr);
+
+	return [this, index, shader_indices](ResourceCache &resource_cache) {
+		std::vector<ShaderModule *> shader_stages(shader_indices.size());
+		std::transform(shader_indices.begin(),
+		               shader_indices.end(),
+		               shader_stages.begin(),
+		               [&](size_t shader_index) {
+			               assert(shader_index < shader_modules.size());
+			               return shader_modules[shader_index];
+		               });
+
+		pipeline_layouts[index] = &resource_cache.request_pipeline_layout(shader_stages);
+	};
 }
 
-void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::CreateFunc ResourceReplay::read_render_pass(std::istringstream &stream)
 {
 	std::vector<Attachment>    attachments;
 	std::vector<LoadStoreInfo> load_store_infos;
@@ -147,12 +227,15 @@ void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istr
 
 	read_subpass_info(stream, subpasses);
 
-	auto &render_pass = resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
+	size_t index = render_passes.size();
+	render_passes.push_back(nullptr);
 
-	render_passes.push_back(&render_pass);
+	return [this, index, attachments, load_store_infos, subpasses](ResourceCache &resource_cache) {
+		render_passes[index] = &resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
+	};
 }
 
-void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream)
+ResourceReplay::CreateFunc ResourceReplay::read_graphics_pipeline(std::istringstream &stream)
 {
 	size_t   pipeline_layout_index{};
 	size_t   render_pass_index{};
@@ -194,10 +277,6 @@ void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std
 	     color_blend_state.attachments);
 
 	PipelineState pipeline_state{};
-	assert(pipeline_layout_index < pipeline_layouts.size());
-	pipeline_state.set_pipeline_layout(*pipeline_layouts[pipeline_layout_index]);
-	assert(render_pass_index < render_passes.size());
-	pipeline_state.set_render_pass(*render_passes[render_pass_index]);
 
 	for (auto &item : specialization_constant_state)
 	{
@@ -213,8 +292,19 @@ void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std
 	pipeline_state.set_depth_stencil_state(depth_stencil_state);
 	pipeline_state.set_color_blend_state(color_blend_state);
 
-	auto &graphics_pipeline = resource_cache.request_graphics_pipeline(pipeline_state);
+	size_t index = graphics_pipelines.size();
+	graphics_pipelines.push_back(nullptr);
+
+	return [this, index, pipeline_layout_index, render_pass_index, pipeline_state](ResourceCache &resource_cache) {
+		// The layout and render pass are only known once the objects they depend on have been created
+		PipelineState state = pipeline_state;
+
+		assert(pipeline_layout_index < pipeline_layouts.size());
+		state.set_pipeline_layout(*pipeline_layouts[pipeline_layout_index]);
+		assert(render_pass_index < render_passes.size());
+		state.set_render_pass(*render_passes[render_pass_index]);
 
-	graphics_pipelines.push_back(&graphics_pipeline);
+		graphics_pipelines[index] = &resource_cache.request_graphics_pipeline(state);
+	};
 }
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -31,22 +31,49 @@ class ResourceReplay
   public:
 	ResourceReplay();
 
-	void play(ResourceCache &resource_cache, ResourceRecord &recorder);
+	/**
+	 * @brief Creates the recorded objects one after the other
+	 * @param resource_cache The cache to create the objects in
+	 * @param data The recorded objects, as serialized by a ResourceRecord
+	 */
+	void play(ResourceCache &resource_cache, const std::vector<uint8_t> &data);
+
+	/**
+	 * @brief Creates the recorded objects concurrently on a thread pool
+	 *        Objects are grouped by their dependencies: shader modules and render passes are created first,
+	 *        then the pipeline layouts using those shader modules, and finally the graphics pipelines.
+	 *        Objects within a group do not depend on each other and are created in parallel.
+	 * @param resource_cache The cache to create the objects in
+	 * @param data The recorded objects, as serialized by a ResourceRecord
+	 * @param thread_count Number of worker threads, 0 to use one per hardware thread
+	 */
+	void play_parallel(ResourceCache &resource_cache, const std::vector<uint8_t> &data, uint32_t thread_count = 0);
 
   protected:
-	void create_shader_module(ResourceCache &resource_cache, std::istringstream &stream);
+	/// Creates a previously read object in the resource cache
+	using CreateFunc = std::function<void(ResourceCache &)>;
+
+	CreateFunc read_shader_module(std::istringstream &stream);
 
-	void create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream);
+	CreateFunc read_pipeline_layout(std::istringstream &stream);
 
-	void create_render_pass(ResourceCache &resource_cache, std::istringstream &stream);
+	CreateFunc read_render_pass(std::istringstream &stream);
 
-	void create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream);
+	CreateFunc read_graphics_pipeline(std::istringstream &stream);
 
   private:
-	using ResourceFunc = std::function<void(ResourceCache &, std::istringstream &)>;
+	using ResourceFunc = std::function<CreateFunc(std::istringstream &)>;
+
+	/**
+	 * @brief Reads all the recorded objects from the stream
+	 * @return The creation functions of the objects, grouped by dependency level
+	 */
+	std::vector<std::vector<CreateFunc>> read_all(const std::vector<uint8_t> &data);
 
 	std::unordered_map<ResourceType, ResourceFunc> stream_resources;
 
+	std::unordered_map<ResourceType, uint32_t> dependency_levels;
+
 	std::vector<ShaderModule *> shader_modules;
 
 	std::vector<PipelineLayout *> pipeline_layouts;
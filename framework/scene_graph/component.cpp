@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -18,6 +18,8 @@
 #include "component.h"
 
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 
 #include "node.h"
 
@@ -25,6 +27,16 @@ namespace vkb
 {
 namespace sg
 {
+ComponentTypeId get_component_type_id(const std::type_index &type)
+{
+	static std::mutex                                           mutex;
+	static std::unordered_map<std::type_index, ComponentTypeId> type_ids;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return type_ids.emplace(type, static_cast<ComponentTypeId>(type_ids.size())).first->second;
+}
+
 Component::Component(const std::string &name) :
     name{name}
 {}
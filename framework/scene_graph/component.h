@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -28,6 +31,26 @@ namespace sg
 {
 class Node;
 
+/// Dense index of a component type, used to find components without hashing or casting
+using ComponentTypeId = uint32_t;
+
+/**
+ * @brief Returns the id of a component type, assigned the first time the type is seen.
+ *        Ids start at 0 and are contiguous, so they can index arrays.
+ * @param type The type, as returned by Component::get_type
+ */
+ComponentTypeId get_component_type_id(const std::type_index &type);
+
+/**
+ * @brief Returns the id of a component type. The id is looked up once per type, later calls only read a static
+ */
+template <class T>
+ComponentTypeId get_component_type_id()
+{
+	static const ComponentTypeId id = get_component_type_id(typeid(T));
+	return id;
+}
+
 /// @brief A generic class which can be used by nodes.
 class Component
 {
@@ -47,5 +70,105 @@ class Component
   private:
 	std::string name;
 };
+
+/**
+ * @brief Read-only view over a list of components stored under the type T, or one of its base classes.
+ *        Iterating over it reads the list in place, without allocating or casting dynamically.
+ *        It stays valid until components of the same type are added to or removed from the list.
+ */
+template <class T>
+class ComponentView
+{
+  public:
+	class Iterator
+	{
+	  public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = T *;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = T **;
+		using reference         = T *;
+
+		explicit Iterator(const std::unique_ptr<Component> *it) :
+		    it{it}
+		{}
+
+		T *operator*() const
+		{
+			return static_cast<T *>(it->get());
+		}
+
+		Iterator &operator++()
+		{
+			++it;
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator result = *this;
+			++it;
+			return result;
+		}
+
+		bool operator==(const Iterator &other) const
+		{
+			return it == other.it;
+		}
+
+		bool operator!=(const Iterator &other) const
+		{
+			return it != other.it;
+		}
+
+	  private:
+		const std::unique_ptr<Component> *it;
+	};
+
+	ComponentView() = default;
+
+	explicit ComponentView(const std::vector<std::unique_ptr<Component>> &components) :
+	    first{components.data()},
+	    last{components.data() + components.size()}
+	{}
+
+	Iterator begin() const
+	{
+		return Iterator{first};
+	}
+
+	Iterator end() const
+	{
+		return Iterator{last};
+	}
+
+	size_t size() const
+	{
+		return static_cast<size_t>(last - first);
+	}
+
+	bool empty() const
+	{
+		return first == last;
+	}
+
+	T *operator[](size_t index) const
+	{
+		return static_cast<T *>(first[index].get());
+	}
+
+	/**
+	 * @brief Copies the components to a vector, for callers which keep the list
+	 */
+	operator std::vector<T *>() const
+	{
+		return std::vector<T *>(begin(), end());
+	}
+
+  private:
+	const std::unique_ptr<Component> *first{nullptr};
+
+	const std::unique_ptr<Component> *last{nullptr};
+};
 }        // namespace sg
 }        // namespace vkb
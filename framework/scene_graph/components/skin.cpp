@@ -0,0 +1,63 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "skin.h"
+
+#include "scene_graph/node.h"
+
+namespace vkb
+{
+namespace sg
+{
+Skin::Skin(const std::string &name) :
+    Component{name}
+{}
+
+std::type_index Skin::get_type()
+{
+	return typeid(Skin);
+}
+
+void Skin::set_joints(std::vector<Node *> &&new_joints, std::vector<glm::mat4> &&new_inverse_bind_matrices)
+{
+	joints                = std::move(new_joints);
+	inverse_bind_matrices = std::move(new_inverse_bind_matrices);
+
+	inverse_bind_matrices.resize(joints.size(), glm::mat4(1.0f));
+
+	joint_matrices.assign(joints.size(), glm::mat4(1.0f));
+}
+
+const std::vector<Node *> &Skin::get_joints() const
+{
+	return joints;
+}
+
+void Skin::update_joint_matrices()
+{
+	for (size_t i = 0; i < joints.size(); ++i)
+	{
+		joint_matrices[i] = joints[i]->get_transform().get_world_matrix() * inverse_bind_matrices[i];
+	}
+}
+
+const std::vector<glm::mat4> &Skin::get_joint_matrices() const
+{
+	return joint_matrices;
+}
+}        // namespace sg
+}        // namespace vkb
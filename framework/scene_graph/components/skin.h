@@ -0,0 +1,82 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+#include "scene_graph/component.h"
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+
+/**
+ * @brief Joints deforming the meshes of the nodes the skin is attached to
+ *        Vertices of skinned submeshes refer to the joints by their index in the skin.
+ */
+class Skin : public Component
+{
+  public:
+	Skin(const std::string &name);
+
+	virtual ~Skin() = default;
+
+	virtual std::type_index get_type() override;
+
+	/**
+	 * @brief Sets the joints of the skin
+	 * @param joints The nodes of the joints
+	 * @param inverse_bind_matrices The matrices bringing the mesh into the space of each joint in bind pose,
+	 *        identity matrices are used if the vector is empty
+	 */
+	void set_joints(std::vector<Node *> &&joints, std::vector<glm::mat4> &&inverse_bind_matrices);
+
+	const std::vector<Node *> &get_joints() const;
+
+	/**
+	 * @brief Computes the matrices of all the joints in a single pass over the world matrices of the scene
+	 *        Joint matrices bring the vertices from bind pose to world space. As a skin may be shared by several
+	 *        nodes, drawing a skinned mesh with the transform of its node requires bringing them to the space
+	 *        of the node first. Must be called after the world matrices are updated.
+	 */
+	void update_joint_matrices();
+
+	/**
+	 * @return The joint matrices as of the last update, in the order of the joints
+	 */
+	const std::vector<glm::mat4> &get_joint_matrices() const;
+
+  private:
+	std::vector<Node *> joints;
+
+	std::vector<glm::mat4> inverse_bind_matrices;
+
+	std::vector<glm::mat4> joint_matrices;
+};
+}        // namespace sg
+}        // namespace vkb
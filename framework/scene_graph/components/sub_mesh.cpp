@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2021, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -92,11 +92,24 @@ void SubMesh::compute_shader_variant()
 		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::toupper);
 		shader_variant.add_define("HAS_" + attrib_name);
 	}
+
+	skinned_shader_variant = shader_variant;
+	skinned_shader_variant.add_define("HAS_SKIN");
 }
 
 ShaderVariant &SubMesh::get_mut_shader_variant()
 {
 	return shader_variant;
 }
+
+const ShaderVariant &SubMesh::get_skinned_shader_variant() const
+{
+	return skinned_shader_variant;
+}
+
+ShaderVariant &SubMesh::get_mut_skinned_shader_variant()
+{
+	return skinned_shader_variant;
+}
 }        // namespace sg
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2021, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -43,6 +43,21 @@ struct VertexAttribute
 	std::uint32_t offset = 0;
 };
 
+/**
+ * @brief Bind pose of the vertices of a skinned submesh, kept on the CPU so that it can be skinned there
+ *        Vertex i is stored at positions[3 * i], joints[4 * i] and so on, normals are empty if the submesh has none.
+ */
+struct SkinnedVertexData
+{
+	std::vector<float> positions;
+
+	std::vector<float> normals;
+
+	std::vector<uint16_t> joints;
+
+	std::vector<float> weights;
+};
+
 class SubMesh : public Component
 {
   public:
@@ -64,6 +79,9 @@ class SubMesh : public Component
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
+	/// Set for submeshes with joints and weights, which are skinned when drawn by a node with a skin
+	std::unique_ptr<SkinnedVertexData> skinned_vertices;
+
 	void set_attribute(const std::string &name, const VertexAttribute &attribute);
 
 	bool get_attribute(const std::string &name, VertexAttribute &attribute) const;
@@ -76,6 +94,16 @@ class SubMesh : public Component
 
 	ShaderVariant &get_mut_shader_variant();
 
+	/**
+	 * @return The shader variant with the HAS_SKIN define, to draw the submesh skinned in the vertex shader
+	 */
+	const ShaderVariant &get_skinned_shader_variant() const;
+
+	/**
+	 * @brief Returns the skinned shader variant, definitions added to the shader variant must be added to it as well
+	 */
+	ShaderVariant &get_mut_skinned_shader_variant();
+
   private:
 	std::unordered_map<std::string, VertexAttribute> vertex_attributes;
 
@@ -83,6 +111,8 @@ class SubMesh : public Component
 
 	ShaderVariant shader_variant;
 
+	ShaderVariant skinned_shader_variant;
+
 	void compute_shader_variant();
 };
 }        // namespace sg
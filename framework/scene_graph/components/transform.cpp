@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2022, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,6 +23,7 @@ VKBP_DISABLE_WARNINGS()
 VKBP_ENABLE_WARNINGS()
 
 #include "scene_graph/node.h"
+#include "scene_graph/transform_hierarchy.h"
 
 namespace vkb
 {
@@ -97,6 +98,20 @@ glm::mat4 Transform::get_matrix() const
 
 glm::mat4 Transform::get_world_matrix()
 {
+	if (hierarchy)
+	{
+		// World matrices are queried by the threads recording the frame, so the hierarchy is only read here.
+		// Changes made since the last Scene::update_transforms() are applied without being stored
+		if (hierarchy->is_up_to_date())
+		{
+			return hierarchy->get_world_matrix(hierarchy_index);
+		}
+
+		auto parent = node.get_parent();
+
+		return parent ? parent->get_component<Transform>().get_world_matrix() * get_matrix() : get_matrix();
+	}
+
 	update_world_transform();
 
 	return world_matrix;
@@ -104,9 +119,35 @@ glm::mat4 Transform::get_world_matrix()
 
 void Transform::invalidate_world_matrix()
 {
+	if (hierarchy)
+	{
+		hierarchy->invalidate(hierarchy_index);
+		return;
+	}
+
+	update_world_matrix = true;
+
+	// Without a hierarchy to propagate the change, the children have to be invalidated here
+	for (auto child : node.get_children())
+	{
+		child->get_transform().invalidate_world_matrix();
+	}
+}
+
+void Transform::set_hierarchy(TransformHierarchy *new_hierarchy, uint32_t index)
+{
+	hierarchy       = new_hierarchy;
+	hierarchy_index = index;
+
+	// The world matrix kept by the transform itself is stale after being part of a hierarchy
 	update_world_matrix = true;
 }
 
+TransformHierarchy *Transform::get_hierarchy() const
+{
+	return hierarchy;
+}
+
 void Transform::update_world_transform()
 {
 	if (!update_world_matrix)
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -36,6 +36,7 @@ namespace vkb
 namespace sg
 {
 class Node;
+class TransformHierarchy;
 
 class Transform : public Component
 {
@@ -64,6 +65,11 @@ class Transform : public Component
 
 	glm::mat4 get_matrix() const;
 
+	/**
+	 * @brief Returns the world matrix from the hierarchy of the scene if the node is part of one,
+	 *        or computes it from the parents of the node if the hierarchy was changed since its last update.
+	 *        Otherwise the world matrix is computed from the parents of the node.
+	 */
 	glm::mat4 get_world_matrix();
 
 	/**
@@ -73,9 +79,22 @@ class Transform : public Component
 	 */
 	void invalidate_world_matrix();
 
+	/**
+	 * @brief Sets the hierarchy storing the world matrix of the node, called by the hierarchy itself
+	 * @param hierarchy The hierarchy, or nullptr to detach the transform from it
+	 * @param index The index of the node in the hierarchy
+	 */
+	void set_hierarchy(TransformHierarchy *hierarchy, uint32_t index);
+
+	TransformHierarchy *get_hierarchy() const;
+
   private:
 	Node &node;
 
+	TransformHierarchy *hierarchy{nullptr};
+
+	uint32_t hierarchy_index{0};
+
 	glm::vec3 translation = glm::vec3(0.0, 0.0, 0.0);
 
 	glm::quat rotation = glm::quat(1.0, 0.0, 0.0, 0.0);
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,8 +17,12 @@
 
 #include "node.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "component.h"
 #include "components/transform.h"
+#include "transform_hierarchy.h"
 
 namespace vkb
 {
@@ -46,6 +50,11 @@ void Node::set_parent(Node &p)
 {
 	parent = &p;
 
+	if (auto hierarchy = transform.get_hierarchy())
+	{
+		hierarchy->invalidate_layout();
+	}
+
 	transform.invalidate_world_matrix();
 }
 
@@ -66,7 +75,9 @@ const std::vector<Node *> &Node::get_children() const
 
 void Node::set_component(Component &component)
 {
-	auto it = components.find(component.get_type());
+	auto type_id = get_component_type_id(component.get_type());
+
+	auto it = std::find_if(components.begin(), components.end(), [type_id](const auto &entry) { return entry.first == type_id; });
 
 	if (it != components.end())
 	{
@@ -74,18 +85,48 @@ void Node::set_component(Component &component)
 	}
 	else
 	{
-		components.insert(std::make_pair(component.get_type(), &component));
+		components.emplace_back(type_id, &component);
 	}
 }
 
 Component &Node::get_component(const std::type_index index)
 {
-	return *components.at(index);
+	return get_component(get_component_type_id(index));
+}
+
+Component &Node::get_component(ComponentTypeId type_id)
+{
+	auto component = find_component(type_id);
+
+	if (!component)
+	{
+		throw std::out_of_range("Node " + name + " has no component of the requested type");
+	}
+
+	return *component;
 }
 
 bool Node::has_component(const std::type_index index)
 {
-	return components.count(index) > 0;
+	return has_component(get_component_type_id(index));
+}
+
+bool Node::has_component(ComponentTypeId type_id)
+{
+	return find_component(type_id) != nullptr;
+}
+
+Component *Node::find_component(ComponentTypeId type_id)
+{
+	for (auto &entry : components)
+	{
+		if (entry.first == type_id)
+		{
+			return entry.second;
+		}
+	}
+
+	return nullptr;
 }
 
 }        // namespace sg
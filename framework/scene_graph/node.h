@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2019, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -21,16 +21,16 @@
 #include <string>
 #include <typeindex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "scene_graph/component.h"
 #include "scene_graph/components/transform.h"
 
 namespace vkb
 {
 namespace sg
 {
-class Component;
-
 /// @brief A leaf of the tree structure which can have children and a single parent.
 class Node
 {
@@ -61,19 +61,29 @@ class Node
 	template <class T>
 	inline T &get_component()
 	{
-		return dynamic_cast<T &>(get_component(typeid(T)));
+		// Components are stored under their own type or one of their bases, so no dynamic cast is needed
+		return static_cast<T &>(get_component(get_component_type_id<T>()));
 	}
 
 	Component &get_component(const std::type_index index);
 
+	/**
+	 * @brief Returns the component of a type
+	 * @param type_id The id of the type
+	 * @throws std::out_of_range if the node has no component of this type
+	 */
+	Component &get_component(ComponentTypeId type_id);
+
 	template <class T>
 	bool has_component()
 	{
-		return has_component(typeid(T));
+		return has_component(get_component_type_id<T>());
 	}
 
 	bool has_component(const std::type_index index);
 
+	bool has_component(ComponentTypeId type_id);
+
   private:
 	size_t id;
 
@@ -85,7 +95,10 @@ class Node
 
 	std::vector<Node *> children;
 
-	std::unordered_map<std::type_index, Component *> components;
+	/// Pairs of type id and component. Nodes only have a few components, so a linear search beats hashing
+	std::vector<std::pair<ComponentTypeId, Component *>> components;
+
+	Component *find_component(ComponentTypeId type_id);
 };
 }        // namespace sg
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2023, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,6 +20,7 @@
 #include <queue>
 
 #include "component.h"
+#include "components/skin.h"
 #include "components/sub_mesh.h"
 #include "node.h"
 
@@ -45,10 +46,17 @@ void Scene::set_nodes(std::vector<std::unique_ptr<Node>> &&n)
 {
 	assert(nodes.empty() && "Scene nodes were already set");
 	nodes = std::move(n);
+
+	for (auto &node : nodes)
+	{
+		transform_hierarchy->add_node(*node);
+	}
 }
 
 void Scene::add_node(std::unique_ptr<Node> &&n)
 {
+	transform_hierarchy->add_node(*n);
+
 	nodes.emplace_back(std::move(n));
 }
 
@@ -59,7 +67,7 @@ void Scene::add_child(Node &child)
 
 std::unique_ptr<Component> Scene::get_model(uint32_t index)
 {
-	auto meshes = std::move(components.at(typeid(SubMesh)));
+	auto meshes = std::move(get_component_list(get_component_type_id<SubMesh>()));
 
 	assert(index < meshes.size());
 	return std::move(meshes[index]);
@@ -71,7 +79,7 @@ void Scene::add_component(std::unique_ptr<Component> &&component, Node &node)
 
 	if (component)
 	{
-		components[component->get_type()].push_back(std::move(component));
+		get_component_list(get_component_type_id(component->get_type())).push_back(std::move(component));
 	}
 }
 
@@ -79,24 +87,38 @@ void Scene::add_component(std::unique_ptr<Component> &&component)
 {
 	if (component)
 	{
-		components[component->get_type()].push_back(std::move(component));
+		get_component_list(get_component_type_id(component->get_type())).push_back(std::move(component));
 	}
 }
 
 void Scene::set_components(const std::type_index &type_info, std::vector<std::unique_ptr<Component>> &&new_components)
 {
-	components[type_info] = std::move(new_components);
+	get_component_list(get_component_type_id(type_info)) = std::move(new_components);
 }
 
 const std::vector<std::unique_ptr<Component>> &Scene::get_components(const std::type_index &type_info) const
 {
-	return components.at(type_info);
+	return components.at(get_component_type_id(type_info));
 }
 
 bool Scene::has_component(const std::type_index &type_info) const
 {
-	auto component = components.find(type_info);
-	return (component != components.end() && !component->second.empty());
+	return has_component(get_component_type_id(type_info));
+}
+
+bool Scene::has_component(ComponentTypeId type_id) const
+{
+	return type_id < components.size() && !components[type_id].empty();
+}
+
+std::vector<std::unique_ptr<Component>> &Scene::get_component_list(ComponentTypeId type_id)
+{
+	if (type_id >= components.size())
+	{
+		components.resize(type_id + 1);
+	}
+
+	return components[type_id];
 }
 
 Node *Scene::find_node(const std::string &node_name)
@@ -135,5 +157,20 @@ Node &Scene::get_root_node()
 {
 	return *root;
 }
+
+void Scene::update_transforms()
+{
+	transform_hierarchy->update();
+
+	for (auto skin : get_components<Skin>())
+	{
+		skin->update_joint_matrices();
+	}
+}
+
+TransformHierarchy &Scene::get_transform_hierarchy()
+{
+	return *transform_hierarchy;
+}
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2020, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -24,15 +24,16 @@
 #include <unordered_map>
 #include <vector>
 
+#include "scene_graph/component.h"
 #include "scene_graph/components/light.h"
 #include "scene_graph/components/texture.h"
+#include "scene_graph/transform_hierarchy.h"
 
 namespace vkb
 {
 namespace sg
 {
 class Node;
-class Component;
 class SubMesh;
 
 /// @brief A collection of nodes organized in a tree structure.
@@ -91,24 +92,14 @@ class Scene
 	}
 
 	/**
-	 * @return List of pointers to components casted to the given template type
+	 * @return View of the components of the given template type, which iterates over them in place
 	 */
 	template <class T>
-	std::vector<T *> get_components() const
+	ComponentView<T> get_components() const
 	{
-		std::vector<T *> result;
-		if (has_component(typeid(T)))
-		{
-			auto &scene_components = get_components(typeid(T));
-
-			result.resize(scene_components.size());
-			std::transform(scene_components.begin(), scene_components.end(), result.begin(),
-			               [](const std::unique_ptr<Component> &component) -> T * {
-				               return dynamic_cast<T *>(component.get());
-			               });
-		}
-
-		return result;
+		auto type_id = get_component_type_id<T>();
+
+		return type_id < components.size() ? ComponentView<T>{components[type_id]} : ComponentView<T>{};
 	}
 
 	/**
@@ -119,17 +110,28 @@ class Scene
 	template <class T>
 	bool has_component() const
 	{
-		return has_component(typeid(T));
+		return has_component(get_component_type_id<T>());
 	}
 
 	bool has_component(const std::type_index &type_info) const;
 
+	bool has_component(ComponentTypeId type_id) const;
+
 	Node *find_node(const std::string &name);
 
 	void set_root_node(Node &node);
 
 	Node &get_root_node();
 
+	/**
+	 * @brief Recomputes the world matrices of the nodes whose transform, or the transform of an ancestor, changed,
+	 *        then the joint matrices of the skins.
+	 *        Should be called once per frame, after scripts and animations, and before world matrices are queried from several threads.
+	 */
+	void update_transforms();
+
+	TransformHierarchy &get_transform_hierarchy();
+
   private:
 	std::string name;
 
@@ -138,7 +140,14 @@ class Scene
 
 	Node *root{nullptr};
 
-	std::unordered_map<std::type_index, std::vector<std::unique_ptr<Component>>> components;
+	/// Components of every type, indexed by type id
+	std::vector<std::vector<std::unique_ptr<Component>>> components;
+
+	std::vector<std::unique_ptr<Component>> &get_component_list(ComponentTypeId type_id);
+
+	/// Kept on the heap so that transforms can point to it when the scene is moved.
+	/// Declared after the nodes, so that it is destroyed before them
+	std::unique_ptr<TransformHierarchy> transform_hierarchy{std::make_unique<TransformHierarchy>()};
 };
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -29,12 +29,17 @@ Animation::Animation(const std::string &name) :
 }
 
 Animation::Animation(const Animation &other) :
-    channels{other.channels}
+    channels{other.channels},
+    target_tracks{other.target_tracks},
+    target_channels{other.target_channels}
 {
 }
 
 void Animation::add_channel(Node &node, const AnimationTarget &target, const AnimationSampler &sampler)
 {
+	add_keyframe_track(target_tracks[target], sampler.inputs.data(), sampler.inputs.size());
+	target_channels[target].push_back(channels.size());
+
 	channels.push_back({node, target, sampler});
 }
 
@@ -46,123 +51,109 @@ void Animation::update(float delta_time)
 		current_time -= end_time;
 	}
 
-	for (auto &channel : channels)
+	for (size_t target = 0; target < target_tracks.size(); ++target)
+	{
+		auto &tracks = target_tracks[target];
+
+		find_keyframes(tracks, current_time);
+
+		for (size_t i = 0; i < tracks.keyframes.size(); ++i)
+		{
+			if (tracks.factors[i] >= 0.0f)
+			{
+				update_channel(channels[target_channels[target][i]], tracks.keyframes[i], tracks.factors[i]);
+			}
+		}
+	}
+}
+
+void Animation::update_channel(AnimationChannel &channel, size_t keyframe, float factor)
+{
+	glm::vec4 result = channel.sampler.evaluate(channel.target, keyframe, factor);
+
+	auto &transform = channel.node.get_transform();
+
+	switch (channel.target)
+	{
+		case Translation:
+		{
+			transform.set_translation(glm::vec3(result));
+			break;
+		}
+		case Rotation:
+		{
+			glm::quat q1;
+			q1.x = result.x;
+			q1.y = result.y;
+			q1.z = result.z;
+			q1.w = result.w;
+
+			transform.set_rotation(glm::normalize(q1));
+			break;
+		}
+
+		case Scale:
+		{
+			transform.set_scale(glm::vec3(result));
+		}
+	}
+}
+
+glm::vec4 AnimationSampler::evaluate(AnimationTarget target, size_t keyframe, float factor) const
+{
+	size_t i = keyframe;
+
+	switch (type)
 	{
-		for (size_t i = 0; i < channel.sampler.inputs.size() - 1; ++i)
+		case AnimationType::Linear:
 		{
-			if ((current_time >= channel.sampler.inputs[i]) && (current_time <= channel.sampler.inputs[i + 1]))
+			if (target != Rotation)
 			{
-				float time = (current_time - channel.sampler.inputs[i]) / (channel.sampler.inputs[i + 1] - channel.sampler.inputs[i]);
-
-				auto &transform = channel.node.get_transform();
-
-				if (channel.sampler.type == AnimationType::Linear)
-				{
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(glm::mix(channel.sampler.outputs[i],
-							                                             channel.sampler.outputs[i + 1],
-							                                             time)));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = channel.sampler.outputs[i].x;
-							q1.y = channel.sampler.outputs[i].y;
-							q1.z = channel.sampler.outputs[i].z;
-							q1.w = channel.sampler.outputs[i].w;
-
-							glm::quat q2;
-							q2.x = channel.sampler.outputs[i + 1].x;
-							q2.y = channel.sampler.outputs[i + 1].y;
-							q2.z = channel.sampler.outputs[i + 1].z;
-							q2.w = channel.sampler.outputs[i + 1].w;
-
-							transform.set_rotation(glm::normalize(glm::slerp(q1, q2, time)));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(glm::mix(channel.sampler.outputs[i],
-							                                       channel.sampler.outputs[i + 1],
-							                                       time)));
-						}
-					}
-				}
-				else if (channel.sampler.type == AnimationType::Step)
-				{
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(channel.sampler.outputs[i]));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = channel.sampler.outputs[i].x;
-							q1.y = channel.sampler.outputs[i].y;
-							q1.z = channel.sampler.outputs[i].z;
-							q1.w = channel.sampler.outputs[i].w;
-
-							transform.set_rotation(glm::normalize(q1));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(channel.sampler.outputs[i]));
-						}
-					}
-				}
-				else if (channel.sampler.type == AnimationType::CubicSpline)
-				{
-					float delta = channel.sampler.inputs[i + 1] - channel.sampler.inputs[i];
-
-					glm::vec4 p0 = channel.sampler.outputs[i * 3 + 1];              // Starting point
-					glm::vec4 p1 = channel.sampler.outputs[(i + 1) * 3 + 1];        // Ending point
-
-					glm::vec4 m0 = delta * channel.sampler.outputs[i * 3 + 2];              // Delta time * out tangent
-					glm::vec4 m1 = delta * channel.sampler.outputs[(i + 1) * 3 + 0];        // Delta time * in tangent of next point
-
-					// This equation is taken from the GLTF 2.0 specification Appendix C (https://github.com/KhronosGroup/glTF/tree/main/specification/2.0#appendix-c-spline-interpolation)
-					glm::vec4 result = (2.0f * glm::pow(time, 3.0f) - 3.0f * glm::pow(time, 2.0f) + 1.0f) * p0 + (glm::pow(time, 3.0f) - 2.0f * glm::pow(time, 2.0f) + time) * m0 + (-2.0f * glm::pow(time, 3.0f) + 3.0f * glm::pow(time, 2.0f)) * p1 + (glm::pow(time, 3.0f) - glm::pow(time, 2.0f)) * m1;
-
-					auto &transform = channel.node.get_transform();
-
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(result));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = result.x;
-							q1.y = result.y;
-							q1.z = result.z;
-							q1.w = result.w;
-
-							transform.set_rotation(glm::normalize(q1));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(result));
-						}
-					}
-				}
+				return glm::mix(outputs[i], outputs[i + 1], factor);
 			}
+
+			glm::quat q1;
+			q1.x = outputs[i].x;
+			q1.y = outputs[i].y;
+			q1.z = outputs[i].z;
+			q1.w = outputs[i].w;
+
+			glm::quat q2;
+			q2.x = outputs[i + 1].x;
+			q2.y = outputs[i + 1].y;
+			q2.z = outputs[i + 1].z;
+			q2.w = outputs[i + 1].w;
+
+			glm::quat q = glm::slerp(q1, q2, factor);
+
+			return glm::vec4(q.x, q.y, q.z, q.w);
+		}
+
+		case AnimationType::Step:
+		{
+			return outputs[i];
+		}
+
+		case AnimationType::CubicSpline:
+		{
+			float delta = inputs[i + 1] - inputs[i];
+
+			glm::vec4 p0 = outputs[i * 3 + 1];              // Starting point
+			glm::vec4 p1 = outputs[(i + 1) * 3 + 1];        // Ending point
+
+			glm::vec4 m0 = delta * outputs[i * 3 + 2];              // Delta time * out tangent
+			glm::vec4 m1 = delta * outputs[(i + 1) * 3 + 0];        // Delta time * in tangent of next point
+
+			float t  = factor;
+			float t2 = t * t;
+			float t3 = t2 * t;
+
+			// This equation is taken from the GLTF 2.0 specification Appendix C (https://github.com/KhronosGroup/glTF/tree/main/specification/2.0#appendix-c-spline-interpolation)
+			return (2.0f * t3 - 3.0f * t2 + 1.0f) * p0 + (t3 - 2.0f * t2 + t) * m0 + (-2.0f * t3 + 3.0f * t2) * p1 + (t3 - t2) * m1;
 		}
 	}
+
+	return outputs[i];
 }
 
 void Animation::update_times(float new_start_time, float new_end_time)
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,12 +17,14 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <string>
 #include <typeinfo>
 #include <vector>
 
+#include "core/util/keyframes.hpp"
 #include "scene_graph/components/transform.h"
 #include "scene_graph/script.h"
 
@@ -51,6 +53,14 @@ struct AnimationSampler
 	std::vector<float> inputs{};
 
 	std::vector<glm::vec4> outputs{};
+
+	/**
+	 * @brief Interpolates the output between a keyframe and the next one
+	 * @param target The property animated by the sampler
+	 * @param keyframe The index of the first keyframe
+	 * @param factor The position between the two keyframes, from 0 to 1
+	 */
+	glm::vec4 evaluate(AnimationTarget target, size_t keyframe, float factor) const;
 };
 
 struct AnimationChannel
@@ -78,6 +88,14 @@ class Animation : public Script
   private:
 	std::vector<AnimationChannel> channels;
 
+	/// Keyframe times of the channels animating each target, searched together on every update
+	std::array<KeyframeTracks, 3> target_tracks;
+
+	/// Index of the channel of every track in target_tracks
+	std::array<std::vector<size_t>, 3> target_channels;
+
+	void update_channel(AnimationChannel &channel, size_t keyframe, float factor);
+
 	float current_time{0.0f};
 
 	float start_time{std::numeric_limits<float>::max()};
@@ -0,0 +1,168 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transform_hierarchy.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "scene_graph/node.h"
+
+namespace vkb
+{
+namespace sg
+{
+TransformHierarchy::~TransformHierarchy()
+{
+	for (auto transform : transforms)
+	{
+		transform->set_hierarchy(nullptr, 0);
+	}
+}
+
+void TransformHierarchy::add_node(Node &node)
+{
+	nodes.push_back(&node);
+
+	layout_valid = false;
+}
+
+void TransformHierarchy::invalidate_layout()
+{
+	layout_valid = false;
+}
+
+size_t TransformHierarchy::size() const
+{
+	return transforms.size();
+}
+
+void TransformHierarchy::update()
+{
+	if (!layout_valid)
+	{
+		build();
+	}
+
+	if (!has_changes)
+	{
+		return;
+	}
+
+	// Parents come first, so their world matrix is final by the time their children read it
+	for (size_t i = 0; i < transforms.size(); ++i)
+	{
+		uint8_t  flags  = changes[i];
+		uint32_t parent = parents[i];
+
+		if (flags & local_changed)
+		{
+			local_matrices[i] = transforms[i]->get_matrix();
+			flags |= world_changed;
+		}
+
+		if (parent != no_parent && (changes[parent] & world_changed))
+		{
+			flags |= world_changed;
+		}
+
+		if (flags & world_changed)
+		{
+			world_matrices[i] = parent != no_parent ? world_matrices[parent] * local_matrices[i] : local_matrices[i];
+		}
+
+		changes[i] = flags;
+	}
+
+	std::fill(changes.begin(), changes.end(), uint8_t{0});
+
+	has_changes = false;
+}
+
+void TransformHierarchy::build()
+{
+	for (auto transform : transforms)
+	{
+		transform->set_hierarchy(nullptr, 0);
+	}
+
+	std::unordered_map<const Node *, size_t> node_indices;
+	node_indices.reserve(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		node_indices.emplace(nodes[i], i);
+	}
+
+	// Children are found from the parent of every node, as this is what world matrices are computed from
+	std::vector<std::vector<size_t>> children(nodes.size());
+	std::vector<size_t>              order;
+	order.reserve(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		auto parent = nodes[i]->get_parent();
+
+		if (!parent)
+		{
+			order.push_back(i);
+			continue;
+		}
+
+		auto it = node_indices.find(parent);
+
+		if (it != node_indices.end())
+		{
+			children[it->second].push_back(i);
+		}
+	}
+
+	// Breadth first, with the order vector as queue. Nodes under a parent outside of the hierarchy are never reached
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		for (auto child : children[order[i]])
+		{
+			order.push_back(child);
+		}
+	}
+
+	std::vector<uint32_t> hierarchy_indices(nodes.size(), no_parent);
+
+	transforms.resize(order.size());
+	parents.resize(order.size());
+
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		auto &node = *nodes[order[i]];
+
+		hierarchy_indices[order[i]] = static_cast<uint32_t>(i);
+
+		transforms[i] = &node.get_transform();
+		parents[i]    = node.get_parent() ? hierarchy_indices[node_indices.at(node.get_parent())] : no_parent;
+
+		transforms[i]->set_hierarchy(this, static_cast<uint32_t>(i));
+	}
+
+	local_matrices.resize(order.size());
+	world_matrices.resize(order.size());
+	changes.assign(order.size(), local_changed);
+
+	layout_valid = true;
+	has_changes  = true;
+}
+}        // namespace sg
+}        // namespace vkb
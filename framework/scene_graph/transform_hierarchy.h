@@ -0,0 +1,138 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class Transform;
+
+/**
+ * @brief Stores the local and world matrices of all the nodes of a scene in contiguous arrays,
+ *        ordered so that every parent comes before its children.
+ *        Changing a transform only flags it, and all the world matrices are brought up to date
+ *        in a single linear pass which propagates the changes from parents to children.
+ *        Nodes whose parent is not part of the hierarchy keep computing their world matrix on their own.
+ *        The hierarchy must not be updated while other threads query world matrices.
+ */
+class TransformHierarchy
+{
+  public:
+	TransformHierarchy() = default;
+
+	~TransformHierarchy();
+
+	TransformHierarchy(const TransformHierarchy &) = delete;
+
+	TransformHierarchy(TransformHierarchy &&) = delete;
+
+	TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+	TransformHierarchy &operator=(TransformHierarchy &&) = delete;
+
+	/**
+	 * @brief Adds a node to the hierarchy, which is reordered on the next update
+	 */
+	void add_node(Node &node);
+
+	/**
+	 * @brief Requests the hierarchy to be reordered on the next update, when the parent of a node changed
+	 */
+	void invalidate_layout();
+
+	/**
+	 * @brief Flags the local transform of a node as changed
+	 * @param index The index of the node in the hierarchy
+	 */
+	void invalidate(uint32_t index)
+	{
+		changes[index] |= local_changed;
+		has_changes = true;
+	}
+
+	/**
+	 * @brief Recomputes the local matrices of the changed nodes and the world matrices of them and their descendants
+	 */
+	void update();
+
+	/**
+	 * @return The world matrix of a node as of the last update
+	 * @param index The index of the node in the hierarchy
+	 */
+	const glm::mat4 &get_world_matrix(uint32_t index) const
+	{
+		return world_matrices[index];
+	}
+
+	/**
+	 * @return Whether the world matrices reflect all the changes made to the hierarchy
+	 */
+	bool is_up_to_date() const
+	{
+		return layout_valid && !has_changes;
+	}
+
+	/**
+	 * @return The number of nodes ordered in the hierarchy
+	 */
+	size_t size() const;
+
+  private:
+	static constexpr uint32_t no_parent = ~0u;
+
+	static constexpr uint8_t local_changed = 1 << 0;
+
+	static constexpr uint8_t world_changed = 1 << 1;
+
+	/**
+	 * @brief Orders the nodes breadth first from the roots, and attaches their transforms to the hierarchy
+	 */
+	void build();
+
+	/// Nodes in the order they were added
+	std::vector<Node *> nodes;
+
+	/// Following members are ordered parent-before-child
+	std::vector<Transform *> transforms;
+
+	std::vector<uint32_t> parents;
+
+	std::vector<glm::mat4> local_matrices;
+
+	std::vector<glm::mat4> world_matrices;
+
+	std::vector<uint8_t> changes;
+
+	bool layout_valid{false};
+
+	bool has_changes{false};
+};
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,116 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "command_buffer_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+CommandBufferStatsProvider::CommandBufferStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	for (auto index : {StatIndex::command_buffer_draws,
+	                   StatIndex::command_buffer_dispatches,
+	                   StatIndex::command_buffer_binds,
+	                   StatIndex::command_buffer_elided_binds,
+	                   StatIndex::command_buffer_descriptor_sets,
+	                   StatIndex::command_buffer_culled_draws})
+	{
+		// Remove from requested set to stop other providers looking for it
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	if (!supported_stats.empty())
+	{
+		observed_frames = get_frames();
+		previous        = take_snapshot();
+	}
+}
+
+bool CommandBufferStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) != 0;
+}
+
+StatsProvider::Counters CommandBufferStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	auto frames = get_frames();
+
+	// Recreated frames start counting from zero again, so whatever they recorded is new
+	if (frames != observed_frames)
+	{
+		observed_frames = std::move(frames);
+		previous        = {};
+	}
+
+	CommandCounters current = take_snapshot();
+
+	auto add_delta = [&](StatIndex index, uint64_t current_value, uint64_t previous_value) {
+		if (supported_stats.count(index))
+		{
+			// A frame may be recreated at the same address, which the check above cannot tell apart
+			res[index].result = static_cast<double>(current_value >= previous_value ? current_value - previous_value : current_value);
+		}
+	};
+
+	add_delta(StatIndex::command_buffer_draws, current.draws, previous.draws);
+	add_delta(StatIndex::command_buffer_dispatches, current.dispatches, previous.dispatches);
+	add_delta(StatIndex::command_buffer_binds, current.binds, previous.binds);
+	add_delta(StatIndex::command_buffer_elided_binds, current.elided_binds, previous.elided_binds);
+	add_delta(StatIndex::command_buffer_descriptor_sets, current.descriptor_sets, previous.descriptor_sets);
+	add_delta(StatIndex::command_buffer_culled_draws, current.culled_draws, previous.culled_draws);
+
+	previous = current;
+
+	return res;
+}
+
+CommandCounters CommandBufferStatsProvider::take_snapshot() const
+{
+	CommandCounters snapshot;
+
+	for (auto &frame : render_context.get_render_frames())
+	{
+		snapshot += frame->get_command_counters();
+	}
+
+	return snapshot;
+}
+
+std::vector<const RenderFrame *> CommandBufferStatsProvider::get_frames() const
+{
+	std::vector<const RenderFrame *> frames;
+
+	for (auto &frame : render_context.get_render_frames())
+	{
+		frames.push_back(frame.get());
+	}
+
+	return frames;
+}
+}        // namespace vkb
@@ -0,0 +1,72 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/command_counters.h"
+#include "stats_provider.h"
+
+namespace vkb
+{
+class RenderContext;
+class RenderFrame;
+
+/**
+ * @brief Provides the number of commands recorded by the command buffers of the frames, per frame
+ *        Only command buffers recorded with a render frame, and ended, are counted.
+ */
+class CommandBufferStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a CommandBufferStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 * @param render_context The render context whose frames are observed
+	 */
+	CommandBufferStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+  private:
+	CommandCounters take_snapshot() const;
+
+	std::vector<const RenderFrame *> get_frames() const;
+
+	RenderContext &render_context;
+
+	std::set<StatIndex> supported_stats;
+
+	/// The counters observed at the last sample
+	CommandCounters previous;
+
+	/// The frames the counters were observed from
+	std::vector<const RenderFrame *> observed_frames;
+};
+}        // namespace vkb
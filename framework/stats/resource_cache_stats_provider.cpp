@@ -0,0 +1,118 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resource_cache_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+namespace
+{
+void add_counter_deltas(StatsProvider::Counters &res, const std::set<StatIndex> &stats, const CacheCounters &current, const CacheCounters &previous,
+                        StatIndex hits_index, StatIndex misses_index, StatIndex miss_time_index)
+{
+	if (stats.count(hits_index))
+	{
+		res[hits_index].result = static_cast<double>(current.hits - previous.hits);
+	}
+
+	if (stats.count(misses_index))
+	{
+		res[misses_index].result = static_cast<double>(current.misses - previous.misses);
+	}
+
+	if (stats.count(miss_time_index))
+	{
+		// In seconds, like frame times
+		res[miss_time_index].result = static_cast<double>(current.miss_time - previous.miss_time) * 1e-9;
+	}
+}
+}        // namespace
+
+ResourceCacheStatsProvider::ResourceCacheStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context{render_context}
+{
+	for (auto index : {StatIndex::graphics_pipeline_cache_hits,
+	                   StatIndex::graphics_pipeline_cache_misses,
+	                   StatIndex::graphics_pipeline_cache_miss_time,
+	                   StatIndex::descriptor_set_cache_hits,
+	                   StatIndex::descriptor_set_cache_misses,
+	                   StatIndex::descriptor_set_cache_miss_time,
+	                   StatIndex::framebuffer_cache_hits,
+	                   StatIndex::framebuffer_cache_misses,
+	                   StatIndex::framebuffer_cache_miss_time})
+	{
+		// Remove from requested set to stop other providers looking for it
+		if (requested_stats.erase(index))
+		{
+			supported_stats.insert(index);
+		}
+	}
+
+	if (!supported_stats.empty())
+	{
+		previous = take_snapshot();
+	}
+}
+
+bool ResourceCacheStatsProvider::is_available(StatIndex index) const
+{
+	return supported_stats.count(index) != 0;
+}
+
+StatsProvider::Counters ResourceCacheStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (supported_stats.empty())
+	{
+		return res;
+	}
+
+	Snapshot current = take_snapshot();
+
+	add_counter_deltas(res, supported_stats, current.graphics_pipelines, previous.graphics_pipelines,
+	                   StatIndex::graphics_pipeline_cache_hits, StatIndex::graphics_pipeline_cache_misses, StatIndex::graphics_pipeline_cache_miss_time);
+	add_counter_deltas(res, supported_stats, current.descriptor_sets, previous.descriptor_sets,
+	                   StatIndex::descriptor_set_cache_hits, StatIndex::descriptor_set_cache_misses, StatIndex::descriptor_set_cache_miss_time);
+	add_counter_deltas(res, supported_stats, current.framebuffers, previous.framebuffers,
+	                   StatIndex::framebuffer_cache_hits, StatIndex::framebuffer_cache_misses, StatIndex::framebuffer_cache_miss_time);
+
+	previous = current;
+
+	return res;
+}
+
+ResourceCacheStatsProvider::Snapshot ResourceCacheStatsProvider::take_snapshot() const
+{
+	auto &state = render_context.get_device().get_resource_cache().get_internal_state();
+
+	Snapshot snapshot;
+
+	snapshot.graphics_pipelines = state.graphics_pipelines.get_counters();
+	snapshot.descriptor_sets    = state.descriptor_sets.get_counters();
+	snapshot.framebuffers       = state.framebuffers.get_counters();
+
+	for (auto &frame : render_context.get_render_frames())
+	{
+		snapshot.descriptor_sets += frame->get_descriptor_set_counters();
+	}
+
+	return snapshot;
+}
+}        // namespace vkb
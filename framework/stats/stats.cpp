@@ -23,6 +23,8 @@
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 #	include "hwcpipe_stats_provider.h"
 #endif
+#include "command_buffer_stats_provider.h"
+#include "resource_cache_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
 namespace vkb
@@ -65,6 +67,8 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<ResourceCacheStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<CommandBufferStatsProvider>(stats, render_context));
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 #endif
@@ -1,4 +1,4 @@
-/* Copyright (c) 2018-2022, Arm Limited and Contributors
+/* Copyright (c) 2018-2024, Arm Limited and Contributors
  * Copyright (c) 2020-2022, Broadcom Inc.
  *
  * SPDX-License-Identifier: Apache-2.0
@@ -63,6 +63,23 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+
+	graphics_pipeline_cache_hits,
+	graphics_pipeline_cache_misses,
+	graphics_pipeline_cache_miss_time,
+	descriptor_set_cache_hits,
+	descriptor_set_cache_misses,
+	descriptor_set_cache_miss_time,
+	framebuffer_cache_hits,
+	framebuffer_cache_misses,
+	framebuffer_cache_miss_time,
+
+	command_buffer_draws,
+	command_buffer_dispatches,
+	command_buffer_binds,
+	command_buffer_elided_binds,
+	command_buffer_descriptor_sets,
+	command_buffer_culled_draws,
 };
 
 struct StatIndexHash
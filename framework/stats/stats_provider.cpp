@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Broadcom Inc. and Contributors
+/* Copyright (c) 2020-2024, Broadcom Inc. and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -54,6 +54,23 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+
+    {StatIndex::graphics_pipeline_cache_hits,      {"Pipeline Cache Hits",                 "{:4.0f}/frame"}},
+    {StatIndex::graphics_pipeline_cache_misses,    {"Pipeline Cache Misses",               "{:4.0f}/frame"}},
+    {StatIndex::graphics_pipeline_cache_miss_time, {"Pipeline Creation Time",              "{:3.1f} ms",    1000.0f}},
+    {StatIndex::descriptor_set_cache_hits,         {"Descriptor Set Cache Hits",           "{:4.0f}/frame"}},
+    {StatIndex::descriptor_set_cache_misses,       {"Descriptor Set Cache Misses",         "{:4.0f}/frame"}},
+    {StatIndex::descriptor_set_cache_miss_time,    {"Descriptor Set Creation Time",        "{:3.1f} ms",    1000.0f}},
+    {StatIndex::framebuffer_cache_hits,            {"Framebuffer Cache Hits",              "{:4.0f}/frame"}},
+    {StatIndex::framebuffer_cache_misses,          {"Framebuffer Cache Misses",            "{:4.0f}/frame"}},
+    {StatIndex::framebuffer_cache_miss_time,       {"Framebuffer Creation Time",           "{:3.1f} ms",    1000.0f}},
+
+    {StatIndex::command_buffer_draws,              {"Draw Calls",                          "{:4.0f}/frame"}},
+    {StatIndex::command_buffer_dispatches,         {"Dispatch Calls",                      "{:4.0f}/frame"}},
+    {StatIndex::command_buffer_binds,              {"Bind Calls",                          "{:4.0f}/frame"}},
+    {StatIndex::command_buffer_elided_binds,       {"Elided Bind Calls",                   "{:4.0f}/frame"}},
+    {StatIndex::command_buffer_descriptor_sets,    {"Descriptor Sets Requested",           "{:4.0f}/frame"}},
+    {StatIndex::command_buffer_culled_draws,       {"Culled Draws",                        "{:4.0f}/frame"}},
     // clang-format on
 };
 
@@ -68,6 +68,7 @@ namespace vkb
  * highlighted when that's the case):
  *
  * - calling sg::Script::update() for all sg::Script (s)
+ * - updating the world matrices of the scene nodes
  * - beginning a frame in RenderContext (does the necessary waiting on fences and
  *   acquires an core::Image)
  * - requesting a CommandBuffer
@@ -1292,6 +1293,9 @@ inline void VulkanSample<bindingType>::update_scene(float delta_time)
 				animation->update(delta_time);
 			}
 		}
+
+		// Update world matrices in a single pass, once all the nodes moved
+		scene->update_transforms();
 	}
 }
 
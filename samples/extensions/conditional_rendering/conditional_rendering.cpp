@@ -1,4 +1,5 @@
 /* Copyright (c) 2022-2024, Sascha Willems
+ * Copyright (c) 2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -129,7 +130,7 @@ void ConditionalRendering::load_assets()
 	scene = loader.read_scene_from_file("scenes/Buggy/glTF-Embedded/Buggy.gltf");
 	assert(scene);
 	// Store all scene nodes in a linear vector for easier access
-	for (auto &mesh : scene->get_components<vkb::sg::Mesh>())
+	for (auto mesh : scene->get_components<vkb::sg::Mesh>())
 	{
 		for (auto &node : mesh->get_nodes())
 		{
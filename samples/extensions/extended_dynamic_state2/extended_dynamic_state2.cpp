@@ -1110,6 +1110,7 @@ void ExtendedDynamicState2::cube_animation(float delta_time)
 
 		/* Write new position to object */
 		transform.set_translation(translation);
+		get_scene().update_transforms();
 		gui_settings.time_tick = true;
 		rebuild_command_buffers();
 	}
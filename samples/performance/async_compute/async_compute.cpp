@@ -223,7 +223,7 @@ bool AsyncComputeSample::prepare(const vkb::ApplicationOptions &options)
 
 	// Attach a shadow camera to the directional light.
 	auto lights = get_scene().get_components<vkb::sg::Light>();
-	for (auto &light : lights)
+	for (auto light : lights)
 	{
 		if (light->get_light_type() == vkb::sg::LightType::Directional)
 		{
@@ -290,27 +290,24 @@ vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::record_draw_sec
 
 void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &primary_command_buffer)
 {
-	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> opaque_nodes;
-
-	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> transparent_nodes;
-
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
-
-	// Sort opaque objects in front-to-back order
+	// Sort opaque objects by state and in front-to-back order, and transparent objects in back-to-front order
 	// Note: sorting objects does not help on PowerVR, so it can be avoided to save CPU cycles
-	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_opaque_nodes;
-	for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
-	{
-		sorted_opaque_nodes.push_back(node_it->second);
-	}
-	const auto opaque_submeshes = vkb::to_u32(sorted_opaque_nodes.size());
+	primary_command_buffer.add_culled_draws(get_sorted_nodes(draw_items));
 
-	// Sort transparent objects in back-to-front order
+	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_opaque_nodes;
 	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_transparent_nodes;
-	for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+	for (auto &item : draw_items)
 	{
-		sorted_transparent_nodes.push_back(node_it->second);
+		if (get_draw_pass(item.sort_key) == DrawPass::Opaque)
+		{
+			sorted_opaque_nodes.emplace_back(item.node, item.sub_mesh);
+		}
+		else
+		{
+			sorted_transparent_nodes.emplace_back(item.node, item.sub_mesh);
+		}
 	}
+	const auto opaque_submeshes      = vkb::to_u32(sorted_opaque_nodes.size());
 	const auto transparent_submeshes = vkb::to_u32(sorted_transparent_nodes.size());
 
 	allocate_lights<vkb::ForwardLights>(scene.get_components<vkb::sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
@@ -18,6 +18,7 @@
 #include "descriptor_management.h"
 
 #include "common/vk_common.h"
+#include "core/device.h"
 #include "filesystem/legacy.h"
 #include "gltf_loader.h"
 #include "gui.h"
@@ -25,15 +26,40 @@
 #include "rendering/subpasses/forward_subpass.h"
 #include "stats/stats.h"
 
+namespace
+{
+// Size of the texture array of base_bindless.frag
+constexpr uint32_t max_bindless_textures = 4096;
+}        // namespace
+
 DescriptorManagement::DescriptorManagement()
 {
 	auto &config = get_configuration();
 
 	config.insert<vkb::IntSetting>(0, descriptor_caching.value, 0);
 	config.insert<vkb::IntSetting>(0, buffer_allocation.value, 0);
+	config.insert<vkb::IntSetting>(0, bindless_textures.value, 0);
 
 	config.insert<vkb::IntSetting>(1, descriptor_caching.value, 1);
 	config.insert<vkb::IntSetting>(1, buffer_allocation.value, 1);
+	config.insert<vkb::IntSetting>(1, bindless_textures.value, 0);
+
+	// The sample falls back to bound textures if bindless textures are not supported
+	config.insert<vkb::IntSetting>(2, descriptor_caching.value, 1);
+	config.insert<vkb::IntSetting>(2, buffer_allocation.value, 1);
+	config.insert<vkb::IntSetting>(2, bindless_textures.value, 1);
+
+	// Bindless textures need descriptor indexing, requested as optional
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_MAINTENANCE3_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, true);
+
+	if (vkb::ResourceCache::descriptor_buffers_requested)
+	{
+		add_device_extension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME, true);
+		add_device_extension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME, true);
+		add_device_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, true);
+	}
 }
 
 bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
@@ -57,6 +83,31 @@ bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
 	render_pipeline->add_subpass(std::move(scene_subpass));
 	set_render_pipeline(std::move(render_pipeline));
 
+	if (descriptor_buffers)
+	{
+		// The texture array is an update-after-bind descriptor set, which cannot be mixed with descriptor buffers
+		LOGI("Descriptors are written to descriptor buffers, the descriptor set options have no effect.");
+	}
+	else if (bindless_supported &&
+	         get_device().is_enabled(VK_KHR_MAINTENANCE3_EXTENSION_NAME) &&
+	         get_device().is_enabled(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+	{
+		// Same scene and vertex shader, with a fragment shader sampling the textures from a single array
+		vkb::ShaderSource bindless_vert_shader("base.vert");
+		vkb::ShaderSource bindless_frag_shader("base_bindless.frag");
+		auto              bindless_subpass = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(bindless_vert_shader), std::move(bindless_frag_shader), get_scene(), *camera);
+		bindless_subpass->set_bindless_textures(true);
+
+		bindless_render_pipeline = std::make_unique<vkb::RenderPipeline>();
+		bindless_render_pipeline->add_subpass(std::move(bindless_subpass));
+
+		radio_buttons.push_back(&bindless_textures);
+	}
+	else
+	{
+		LOGW("Bindless textures are not supported by your device, this sample option will be disabled.");
+	}
+
 	// Add a GUI with the stats you want to monitor
 	get_stats().request_stats({vkb::StatIndex::frame_times});
 	create_gui(*window, &get_stats());
@@ -64,6 +115,69 @@ bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
 	return true;
 }
 
+std::unique_ptr<vkb::Device> DescriptorManagement::create_device(vkb::PhysicalDevice &gpu)
+{
+	auto device = VulkanSample::create_device(gpu);
+
+	if (vkb::ResourceCache::descriptor_buffers_requested)
+	{
+		// Enabled before any descriptor set layout is created, falls back to descriptor sets if not supported
+		descriptor_buffers = device->get_resource_cache().set_descriptor_buffers(true);
+	}
+
+	return device;
+}
+
+void DescriptorManagement::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	if (!get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		return;
+	}
+
+	// The requested features are initialized to the supported ones
+	auto &features = gpu.request_extension_features<VkPhysicalDeviceDescriptorIndexingFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT);
+
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptor_indexing_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT};
+	VkPhysicalDeviceProperties2KHR                  properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+	properties.pNext = &descriptor_indexing_properties;
+	vkGetPhysicalDeviceProperties2KHR(gpu.get_handle(), &properties);
+
+	// The texture array is indexed with a push constant, written once but only partially, and is bound while it is updated
+	bindless_supported = gpu.get_features().shaderSampledImageArrayDynamicIndexing &&
+	                     features.descriptorBindingPartiallyBound &&
+	                     features.descriptorBindingSampledImageUpdateAfterBind &&
+	                     descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages >= max_bindless_textures &&
+	                     descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers >= max_bindless_textures &&
+	                     descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages >= max_bindless_textures &&
+	                     descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSamplers >= max_bindless_textures;
+
+	if (bindless_supported)
+	{
+		gpu.get_mutable_requested_features().shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+	}
+
+	if (vkb::ResourceCache::descriptor_buffers_requested)
+	{
+		gpu.request_extension_features<VkPhysicalDeviceBufferDeviceAddressFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR);
+		gpu.request_extension_features<VkPhysicalDeviceDescriptorBufferFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+	}
+}
+
+void DescriptorManagement::render(vkb::CommandBuffer &command_buffer)
+{
+	auto &render_target = get_render_context().get_active_frame().get_render_target();
+
+	if (bindless_render_pipeline && bindless_textures.value == 1)
+	{
+		bindless_render_pipeline->draw(command_buffer, render_target);
+	}
+	else
+	{
+		get_render_pipeline().draw(command_buffer, render_target);
+	}
+}
+
 void DescriptorManagement::update(float delta_time)
 {
 	update_scene(delta_time);
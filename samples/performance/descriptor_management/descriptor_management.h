@@ -32,6 +32,12 @@ class DescriptorManagement : public vkb::VulkanSample<vkb::BindingType::C>
 
 	virtual void update(float delta_time) override;
 
+	virtual std::unique_ptr<vkb::Device> create_device(vkb::PhysicalDevice &gpu) override;
+
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	virtual void render(vkb::CommandBuffer &command_buffer) override;
+
   private:
 	/**
 	 * @brief Struct that contains radio button labeling and the value
@@ -54,10 +60,24 @@ class DescriptorManagement : public vkb::VulkanSample<vkb::BindingType::C>
 	    {"Disabled", "Enabled"},
 	    0};
 
+	RadioButtonGroup bindless_textures{
+	    "Bindless textures",
+	    {"Disabled", "Enabled"},
+	    0};
+
+	// The bindless textures option is only added if the device supports it
 	std::vector<RadioButtonGroup *> radio_buttons = {&descriptor_caching, &buffer_allocation};
 
 	vkb::sg::PerspectiveCamera *camera{nullptr};
 
+	// Draws the scene with all its textures in a single array, see vkb::GeometrySubpass::set_bindless_textures
+	std::unique_ptr<vkb::RenderPipeline> bindless_render_pipeline;
+
+	bool bindless_supported{false};
+
+	// Set if the --descriptor-buffers flag was given and descriptor buffers are supported, see vkb::ResourceCache::set_descriptor_buffers
+	bool descriptor_buffers{false};
+
 	virtual void draw_gui() override;
 };
 
@@ -1,4 +1,5 @@
 /* Copyright (c) 2021-2024, Holochip Corporation
+ * Copyright (c) 2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,6 +17,7 @@
  */
 
 #include "multi_draw_indirect.h"
+#include "geometry/frustum.h"
 #include "gltf_loader.h"
 #include "ktx.h"
 #include "scene_graph/components/camera.h"
@@ -88,6 +90,7 @@ MultiDrawIndirect::~MultiDrawIndirect()
 		device_address_buffer.reset();
 
 		cpu_staging_buffer.reset();
+		cpu_indirect_call_buffer.reset();
 		indirect_call_buffer.reset();
 	}
 }
@@ -173,15 +176,18 @@ void MultiDrawIndirect::build_command_buffers()
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer->get(), offsets);
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, model_information_buffer->get(), offsets);
 
+		// The CPU cull writes its commands in a host visible buffer, so that it does not need any copy
+		VkBuffer draw_buffer = render_mode == RenderMode::CPU ? cpu_indirect_call_buffer->get_handle() : indirect_call_buffer->get_handle();
+
 		if (m_enable_mdi && m_supports_mdi)
 		{
-			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_call_buffer->get_handle(), 0, cpu_commands.size(), sizeof(cpu_commands[0]));
+			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], draw_buffer, 0, cpu_commands.size(), sizeof(cpu_commands[0]));
 		}
 		else
 		{
 			for (size_t j = 0; j < cpu_commands.size(); ++j)
 			{
-				vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_call_buffer->get_handle(), j * sizeof(cpu_commands[0]), 1, sizeof(cpu_commands[0]));
+				vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], draw_buffer, j * sizeof(cpu_commands[0]), 1, sizeof(cpu_commands[0]));
 			}
 		}
 
@@ -203,13 +209,12 @@ void MultiDrawIndirect::on_update_ui_overlay(vkb::Drawer &drawer)
 		drawer.text("Device buffer address: %s", supported[this->m_supports_buffer_device]);
 
 		drawer.text("");
-		uint32_t instance_count = 0;
+		uint32_t instance_count = cpu_cull_visible_count;
 
 		if (render_mode == RenderMode::GPU || render_mode == RenderMode::GPU_DEVICE_ADDRESS)
 		{
-			// copy over the GPU-culled data to the CPU command so that we can count the number of instances
+			// copy over the GPU-culled data to the CPU so that we can count the number of instances
 			assert(!!indirect_call_buffer && !!cpu_staging_buffer && indirect_call_buffer->get_size() == cpu_staging_buffer->get_size());
-			assert(cpu_commands.size() * sizeof(cpu_commands[0]) == cpu_staging_buffer->get_size());
 
 			auto &cmd = get_device().request_command_buffer();
 			cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
@@ -220,14 +225,20 @@ void MultiDrawIndirect::on_update_ui_overlay(vkb::Drawer &drawer)
 			queue.submit(cmd, get_device().request_fence());
 			get_device().get_fence_pool().wait();
 
-			memcpy(cpu_commands.data(), cpu_staging_buffer->get_data(), cpu_staging_buffer->get_size());
+			auto *commands = reinterpret_cast<const VkDrawIndexedIndirectCommand *>(cpu_staging_buffer->get_data());
+
+			instance_count = 0;
+			for (size_t i = 0; i < cpu_commands.size(); ++i)
+			{
+				instance_count += commands[i].instanceCount;
+			}
 		}
+		drawer.text("Instances: %d / %d", instance_count, static_cast<uint32_t>(cpu_commands.size()));
 
-		for (auto &&cmd : cpu_commands)
+		if (render_mode == RenderMode::CPU)
 		{
-			instance_count += cmd.instanceCount;
+			drawer.text("CPU cull: %.3f ms (%d threads)", cpu_cull_time, static_cast<int>(cpu_cull_thread_pool.size()) + 1);
 		}
-		drawer.text("Instances: %d / %d", instance_count, 256);
 
 		m_requires_rebuild |= drawer.checkbox("Enable multi-draw", &m_enable_mdi);
 		drawer.checkbox("Freeze culling", &m_freeze_cull);
@@ -293,7 +304,10 @@ bool MultiDrawIndirect::prepare(const vkb::ApplicationOptions &options)
 	create_compute_pipeline();
 	initialize_descriptors();
 	build_command_buffers();
-	cpu_cull();        // initialize buffer
+
+	// The thread running the sample also culls its share of the models
+	cpu_cull_thread_pool.resize(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
 	run_cull();
 
 	prepared = true;
@@ -454,6 +468,29 @@ void MultiDrawIndirect::initialize_resources()
 	}
 	indirect_call_buffer = std::make_unique<vkb::core::Buffer>(get_device(), models.size() * sizeof(VkDrawIndexedIndirectCommand), indirect_flags, VMA_MEMORY_USAGE_GPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT, queue_families);
 
+	// The CPU cull writes the commands directly in host visible memory, which stays mapped for the lifetime of the sample.
+	// It also holds the initial commands of the GPU cull, which only updates the instance counts
+	cpu_commands.resize(models.size());
+	for (size_t i = 0; i < models.size(); ++i)
+	{
+		auto                        &model = models[i];
+		VkDrawIndexedIndirectCommand cmd{};
+		cmd.firstIndex    = model.index_buffer_offset / (sizeof(model.triangles[0][0]));
+		cmd.indexCount    = static_cast<uint32_t>(model.triangles.size()) * 3;
+		cmd.vertexOffset  = static_cast<int32_t>(model.vertex_buffer_offset / sizeof(Vertex));
+		cmd.firstInstance = i;
+		cmd.instanceCount = 1;
+		cpu_commands[i]   = cmd;
+	}
+
+	const auto call_buffer_size = cpu_commands.size() * sizeof(cpu_commands[0]);
+	cpu_indirect_call_buffer    = std::make_unique<vkb::core::Buffer>(get_device(), call_buffer_size, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT, queue_families);
+	cpu_indirect_call_buffer->update(cpu_commands.data(), call_buffer_size, 0);
+	cpu_indirect_call_buffer->flush();
+	cpu_cull_visible_count = static_cast<uint32_t>(cpu_commands.size());
+
+	cpu_staging_buffer = std::make_unique<vkb::core::Buffer>(get_device(), call_buffer_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+
 	// Create a buffer containing the addresses of the indirect calls.
 	// In this sample, the order of the addresses will match that of the other buffers, but in general they could be in any order
 	const size_t address_buffer_size    = sizeof(VkDeviceAddress);
@@ -513,6 +550,15 @@ void MultiDrawIndirect::initialize_resources()
 		device_address_buffer = copy(*staging_address_buffer, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
 	}
 
+	cmd.copy_buffer(*cpu_indirect_call_buffer, *indirect_call_buffer, call_buffer_size);
+
+	vkb::BufferMemoryBarrier indirect_barrier;
+	indirect_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	indirect_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	indirect_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	indirect_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	cmd.buffer_memory_barrier(*indirect_call_buffer, 0, VK_WHOLE_SIZE, indirect_barrier);
+
 	cmd.end();
 	auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
 	queue.submit(cmd, get_device().request_fence());
@@ -849,93 +895,80 @@ void MultiDrawIndirect::run_gpu_cull()
 	vkFreeCommandBuffers(get_device().get_handle(), get_device().get_command_pool().get_handle(), 1, &cmd);
 }
 
-namespace
-{
-/**
- * @brief Test for visibility using bounding sphere.
- * See https://www.gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
- */
-struct VisibilityTester
+void MultiDrawIndirect::cpu_cull()
 {
-	explicit VisibilityTester(glm::mat4x4 view_matrix) :
-	    planes(get_view_planes(view_matrix))
-	{}
-	std::array<glm::vec4, 6> planes;
+	cpu_cull_timer.start();
 
-	static std::array<glm::vec4, 6> get_view_planes(const glm::mat4x4 &mat)
+	if (cpu_cull_spheres.size() != models.size())
 	{
-		using namespace glm;
-		std::array<vec4, 6> out{};
-		for (auto i = 0; i < 3; ++i)
+		cpu_cull_spheres.clear();
+		for (auto &model : models)
 		{
-			for (size_t j = 0; j < 2; ++j)
-			{
-				const float sign = j ? 1.f : -1.f;
-				for (auto k = 0; k < 4; ++k)
-				{
-					out[2 * i + j][k] = mat[k][3] + sign * mat[k][i];
-				}
-			}
+			cpu_cull_spheres.push_back(model.bounding_sphere.center.x, model.bounding_sphere.center.y, model.bounding_sphere.center.z, model.bounding_sphere.radius);
 		}
-
-		// normalize plane; see Appendix A.2
-		for (auto &&plane : out)
-		{
-			plane /= float(length(vec3(plane.xyz)));
-		}
-		return out;
 	}
 
-	bool is_visible(glm::vec3 origin, float radius) const
-	{
-		using namespace glm;
-		std::array<int, 4> V{0, 1, 4, 5};
-		return std::all_of(V.begin(), V.end(), [this, origin, radius](size_t i) {
-			const auto &plane = planes[i];
-			return dot(origin, vec3(plane.xyz)) + plane.w + radius >= 0;
-		});
-	}
-};
+	vkb::Frustum frustum;
+	frustum.update(scene_uniform.proj * scene_uniform.view);
 
-}        // namespace
+	// Like the culling shaders, ignore the top and bottom planes by replacing them with planes every sphere is in front of
+	auto planes         = frustum.get_culling_planes();
+	planes[vkb::TOP]    = {0.0f, 0.0f, 0.0f, 1.0f};
+	planes[vkb::BOTTOM] = {0.0f, 0.0f, 0.0f, 1.0f};
 
-void MultiDrawIndirect::cpu_cull()
-{
-	cpu_commands.resize(models.size());
+	cpu_cull_visibility.resize(models.size());
 
-	VisibilityTester tester(scene_uniform.proj * scene_uniform.view);
-	for (size_t i = 0; i < models.size(); ++i)
+	// The GPU is idle once the previous frame has been submitted, so the commands can be written directly in the buffer it draws from
+	auto *commands = reinterpret_cast<VkDrawIndexedIndirectCommand *>(cpu_indirect_call_buffer->get_data());
+
+	// Split the models in ranges of whole cache lines, so that threads never write to the same one,
+	// and do not wake up threads for fewer models than it costs to schedule them
+	constexpr size_t min_models_per_range = 1024;
+	constexpr size_t range_alignment      = 64;
+
+	const size_t thread_count = static_cast<size_t>(cpu_cull_thread_pool.size()) + 1;
+	const size_t range_count  = std::max<size_t>(1, std::min(thread_count, models.size() / min_models_per_range));
+	const size_t range_size   = ((models.size() + range_count - 1) / range_count + range_alignment - 1) / range_alignment * range_alignment;
+
+	cpu_cull_futures.clear();
+	for (size_t first = range_size; first < models.size(); first += range_size)
 	{
-		// we control visibility by changing the instance count
-		auto                        &model = models[i];
-		VkDrawIndexedIndirectCommand cmd{};
-		cmd.firstIndex    = model.index_buffer_offset / (sizeof(model.triangles[0][0]));
-		cmd.indexCount    = static_cast<uint32_t>(model.triangles.size()) * 3;
-		cmd.vertexOffset  = static_cast<int32_t>(model.vertex_buffer_offset / sizeof(Vertex));
-		cmd.firstInstance = i;
-		cmd.instanceCount = tester.is_visible(model.bounding_sphere.center, model.bounding_sphere.radius);
-		cpu_commands[i]   = cmd;
+		size_t count = std::min(range_size, models.size() - first);
+		cpu_cull_futures.push_back(cpu_cull_thread_pool.push([this, &planes, first, count, commands](size_t) {
+			return cpu_cull_range(planes, first, count, commands);
+		}));
 	}
 
-	const auto call_buffer_size = cpu_commands.size() * sizeof(cpu_commands[0]);
-	assert(!!indirect_call_buffer && indirect_call_buffer->get_size() == call_buffer_size);
+	uint32_t visible_count = cpu_cull_range(planes, 0, std::min(range_size, models.size()), commands);
 
-	if (!cpu_staging_buffer || cpu_staging_buffer->get_size() != call_buffer_size)
+	for (auto &future : cpu_cull_futures)
 	{
-		cpu_staging_buffer = std::make_unique<vkb::core::Buffer>(get_device(), models.size() * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		visible_count += future.get();
 	}
 
-	cpu_staging_buffer->update(cpu_commands.data(), call_buffer_size, 0);
-	cpu_staging_buffer->flush();
+	cpu_cull_visible_count = visible_count;
 
-	auto &transfer_cmd = get_device().get_command_pool().request_command_buffer();
-	transfer_cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, VK_NULL_HANDLE);
-	transfer_cmd.copy_buffer(*cpu_staging_buffer, *indirect_call_buffer, call_buffer_size);
-	transfer_cmd.end();
+	cpu_indirect_call_buffer->flush();
 
-	auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-	queue.submit(transfer_cmd, get_device().request_fence());
-	get_device().get_fence_pool().wait();
+	cpu_cull_time = cpu_cull_timer.stop<vkb::Timer::Milliseconds>();
+}
+
+uint32_t MultiDrawIndirect::cpu_cull_range(const vkb::FrustumPlanes &planes, size_t first, size_t count, VkDrawIndexedIndirectCommand *commands)
+{
+	vkb::cull_spheres(planes, cpu_cull_spheres, first, count, cpu_cull_visibility.data() + first);
+
+	// We control visibility by changing the instance count.
+	// Whole commands are written in order, as the mapped memory may be write-combined
+	uint32_t visible_count = 0;
+	for (size_t i = first; i < first + count; ++i)
+	{
+		VkDrawIndexedIndirectCommand cmd = cpu_commands[i];
+		cmd.instanceCount                = cpu_cull_visibility[i];
+		commands[i]                      = cmd;
+		visible_count += cmd.instanceCount;
+	}
+
+	return visible_count;
 }
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_multi_draw_indirect()
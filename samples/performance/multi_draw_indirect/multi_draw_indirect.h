@@ -1,4 +1,5 @@
 /* Copyright (c) 2021-2024, Holochip Corporation
+ * Copyright (c) 2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,7 +18,10 @@
 
 #pragma once
 
+#include <ctpl_stl.h>
+
 #include "api_vulkan_sample.h"
+#include "core/util/frustum_culling.hpp"
 
 /**
  * @brief Offloading processes from CPU to GPU
@@ -128,10 +132,27 @@ class MultiDrawIndirect : public ApiVulkanSample
 	std::vector<uint32_t>           queue_families;
 
 	// CPU Draw Calls
-	void                                      cpu_cull();
+	void cpu_cull();
+	uint32_t cpu_cull_range(const vkb::FrustumPlanes &planes, size_t first, size_t count, VkDrawIndexedIndirectCommand *commands);
+
+	// Draw commands of all the models, with an instance count of 1
 	std::vector<VkDrawIndexedIndirectCommand> cpu_commands;
-	std::unique_ptr<vkb::core::Buffer>        cpu_staging_buffer;
-	std::unique_ptr<vkb::core::Buffer>        indirect_call_buffer;
+	vkb::BoundingSpheres                      cpu_cull_spheres;
+	std::vector<uint8_t>                      cpu_cull_visibility;
+	ctpl::thread_pool                         cpu_cull_thread_pool;
+	std::vector<std::future<uint32_t>>        cpu_cull_futures;
+	vkb::Timer                                cpu_cull_timer;
+	double                                    cpu_cull_time{0.0};
+
+	// Number of models found visible by the last CPU cull, counted so that the commands are never read back from the buffer
+	uint32_t cpu_cull_visible_count{0};
+
+	// Host visible and persistently mapped, the CPU cull writes the draw commands directly in it
+	std::unique_ptr<vkb::core::Buffer> cpu_indirect_call_buffer;
+
+	// Used to read back the draw commands generated by the GPU cull
+	std::unique_ptr<vkb::core::Buffer> cpu_staging_buffer;
+	std::unique_ptr<vkb::core::Buffer> indirect_call_buffer;
 
 	void request_gpu_features(vkb::PhysicalDevice &gpu) override;
 	void build_command_buffers() override;
@@ -18,6 +18,7 @@
 #include "pipeline_cache.h"
 
 #include <imgui_internal.h>
+#include <thread>
 
 #include "core/device.h"
 #include "core/util/logging.hpp"
@@ -35,6 +36,11 @@ PipelineCache::PipelineCache()
 
 	config.insert<vkb::BoolSetting>(0, enable_pipeline_cache, true);
 	config.insert<vkb::BoolSetting>(1, enable_pipeline_cache, false);
+
+	// Pipelines can be linked from pipeline libraries, requested as optional
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, true);
+	add_device_extension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, true);
 }
 
 PipelineCache::~PipelineCache()
@@ -52,11 +58,14 @@ PipelineCache::~PipelineCache()
 		/* Write pipeline cache data to a file in binary format */
 		vkb::fs::write_temp(data, "pipeline_cache.data");
 
+		/* The pipeline cache data is already persisted above, only store the recorded resources */
+		get_device().get_resource_cache().set_pipeline_cache(VK_NULL_HANDLE);
+
 		/* Destroy Vulkan pipeline cache */
 		vkDestroyPipelineCache(get_device().get_handle(), pipeline_cache, nullptr);
 	}
 
-	vkb::fs::write_temp(get_device().get_resource_cache().serialize(), "cache.data");
+	get_device().get_resource_cache().save("cache.data");
 }
 
 bool PipelineCache::prepare(const vkb::ApplicationOptions &options)
@@ -91,21 +100,13 @@ bool PipelineCache::prepare(const vkb::ApplicationOptions &options)
 	// Use pipeline cache to store pipelines
 	resource_cache.set_pipeline_cache(pipeline_cache);
 
-	std::vector<uint8_t> data_cache;
-
-	try
-	{
-		data_cache = vkb::fs::read_temp("cache.data");
-	}
-	catch (std::runtime_error &ex)
-	{
-		LOGW("No data cache found. {}", ex.what());
-	}
-
-	// Build all pipelines from a previous run
-	resource_cache.warmup(data_cache);
+	// Build all pipelines from a previous run on first use, with one worker thread per hardware thread
+	resource_cache.set_replay_thread_count(0);
+	resource_cache.load("cache.data");
 
-	get_stats().request_stats({vkb::StatIndex::frame_times});
+	get_stats().request_stats({vkb::StatIndex::frame_times,
+	                           vkb::StatIndex::graphics_pipeline_cache_misses,
+	                           vkb::StatIndex::graphics_pipeline_cache_miss_time});
 
 	float dpi_factor = window->get_dpi_factor();
 
@@ -131,6 +132,17 @@ bool PipelineCache::prepare(const vkb::ApplicationOptions &options)
 	return true;
 }
 
+void PipelineCache::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	if (!get_instance().is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		return;
+	}
+
+	// The requested features are initialized to the supported ones
+	gpu.request_extension_features<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+}
+
 void PipelineCache::draw_gui()
 {
 	get_gui().show_options_window(
@@ -160,6 +172,21 @@ void PipelineCache::draw_gui()
 			    record_frame_time_next_frame = true;
 		    }
 
+		    if (ImGui::Checkbox("Asynchronous compilation", &enable_async_pipelines))
+		    {
+			    // Draws are skipped until their pipeline has been compiled by a worker thread
+			    uint32_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+			    get_device().get_resource_cache().set_async_pipeline_thread_count(enable_async_pipelines ? thread_count : 0);
+		    }
+
+		    ImGui::SameLine();
+
+		    if (ImGui::Checkbox("Pipeline libraries", &enable_pipeline_libraries))
+		    {
+			    // Only the pipelines created from now on are linked, stays disabled if VK_EXT_graphics_pipeline_library is not supported
+			    enable_pipeline_libraries = get_device().get_resource_cache().set_graphics_pipeline_library_linking(enable_pipeline_libraries);
+		    }
+
 		    if (rebuild_pipelines_frame_time_ms > 0.0f)
 		    {
 			    ImGui::Text("Pipeline rebuild frame time: %.1f ms", rebuild_pipelines_frame_time_ms);
@@ -169,7 +196,7 @@ void PipelineCache::draw_gui()
 			    ImGui::Text("Pipeline rebuild frame time: N/A");
 		    }
 	    },
-	    /* lines = */ 2);
+	    /* lines = */ 3);
 }
 
 void PipelineCache::update(float delta_time)
@@ -37,6 +37,8 @@ class PipelineCache : public vkb::VulkanSample<vkb::BindingType::C>
 
 	virtual void update(float delta_time) override;
 
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
   private:
 	vkb::sg::Camera *camera{nullptr};
 
@@ -46,6 +48,10 @@ class PipelineCache : public vkb::VulkanSample<vkb::BindingType::C>
 
 	bool enable_pipeline_cache{true};
 
+	bool enable_async_pipelines{false};
+
+	bool enable_pipeline_libraries{false};
+
 	bool record_frame_time_next_frame{false};
 
 	float rebuild_pipelines_frame_time_ms{0.0f};
@@ -71,13 +71,13 @@ class SpecializationConstants : public vkb::VulkanSample<vkb::BindingType::C>
 		 * @return BufferAllocation A buffer allocation created for use in shaders
 		 */
 		template <typename T>
-		vkb::BufferAllocation allocate_custom_lights(vkb::CommandBuffer &command_buffer, const std::vector<vkb::sg::Light *> &scene_lights, size_t light_count)
+		vkb::BufferAllocation allocate_custom_lights(vkb::CommandBuffer &command_buffer, const vkb::sg::ComponentView<vkb::sg::Light> &scene_lights, size_t light_count)
 		{
 			T light_info;
 			light_info.count = vkb::to_u32(light_count);
 
 			std::vector<vkb::Light> lights;
-			for (auto &scene_light : scene_lights)
+			for (auto scene_light : scene_lights)
 			{
 				if (lights.size() < light_count)
 				{
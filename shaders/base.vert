@@ -1,5 +1,5 @@
 #version 320 es
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -20,6 +20,17 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 texcoord_0;
 layout(location = 2) in vec3 normal;
 
+#ifdef HAS_SKIN
+layout(location = 3) in uvec4 joints_0;
+layout(location = 4) in vec4 weights_0;
+
+// Joint matrices bring the vertices to the space of the node, the model matrix then brings them to world space
+layout(set = 0, binding = 2) readonly buffer JointMatrices
+{
+    mat4 joint_matrices[];
+};
+#endif
+
 layout(set = 0, binding = 1) uniform GlobalUniform {
     mat4 model;
     mat4 view_proj;
@@ -32,11 +43,23 @@ layout (location = 2) out vec3 o_normal;
 
 void main(void)
 {
-    o_pos = global_uniform.model * vec4(position, 1.0);
+#ifdef HAS_SKIN
+    // Out of range joints are clamped to the last joint, as when skinning on the CPU
+    uvec4 joints = min(joints_0, uvec4(joint_matrices.length() - 1));
+
+    mat4 model = global_uniform.model * (weights_0.x * joint_matrices[joints.x] +
+                                         weights_0.y * joint_matrices[joints.y] +
+                                         weights_0.z * joint_matrices[joints.z] +
+                                         weights_0.w * joint_matrices[joints.w]);
+#else
+    mat4 model = global_uniform.model;
+#endif
+
+    o_pos = model * vec4(position, 1.0);
 
     o_uv = texcoord_0;
 
-    o_normal = mat3(global_uniform.model) * normal;
+    o_normal = mat3(model) * normal;
 
     gl_Position = global_uniform.view_proj * o_pos;
 }
@@ -0,0 +1,109 @@
+#version 320 es
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+precision highp float;
+
+// Maximum number of textures of a scene
+#define MAX_BINDLESS_TEXTURES 4096
+
+// Index of a texture which is not present
+#define INVALID_TEXTURE_INDEX 0xFFFFFFFFU
+
+// All the textures of the scene, indexed by the material push constants
+layout(set = 1, binding = 0) uniform sampler2D bindless_textures[MAX_BINDLESS_TEXTURES];
+
+layout(location = 0) in vec4 in_pos;
+layout(location = 1) in vec2 in_uv;
+layout(location = 2) in vec3 in_normal;
+
+layout(location = 0) out vec4 o_color;
+
+layout(set = 0, binding = 1) uniform GlobalUniform
+{
+	mat4 model;
+	mat4 view_proj;
+	vec3 camera_position;
+}
+global_uniform;
+
+// Push constants come with a limitation in the size of data.
+// The standard requires at least 128 bytes
+layout(push_constant, std430) uniform BindlessPBRMaterialUniform
+{
+	vec4  base_color_factor;
+	float metallic_factor;
+	float roughness_factor;
+	uint  base_color_texture_index;
+	uint  normal_texture_index;
+	uint  metallic_roughness_texture_index;
+	uint  occlusion_texture_index;
+	uint  emissive_texture_index;
+}
+pbr_material_uniform;
+
+#include "lighting.h"
+
+layout(set = 0, binding = 4) uniform LightsInfo
+{
+	Light directional_lights[MAX_LIGHT_COUNT];
+	Light point_lights[MAX_LIGHT_COUNT];
+	Light spot_lights[MAX_LIGHT_COUNT];
+}
+lights_info;
+
+layout(constant_id = 0) const uint DIRECTIONAL_LIGHT_COUNT = 0U;
+layout(constant_id = 1) const uint POINT_LIGHT_COUNT       = 0U;
+layout(constant_id = 2) const uint SPOT_LIGHT_COUNT        = 0U;
+
+void main(void)
+{
+	vec3 normal = normalize(in_normal);
+
+	vec3 light_contribution = vec3(0.0);
+
+	for (uint i = 0U; i < DIRECTIONAL_LIGHT_COUNT; ++i)
+	{
+		light_contribution += apply_directional_light(lights_info.directional_lights[i], normal);
+	}
+
+	for (uint i = 0U; i < POINT_LIGHT_COUNT; ++i)
+	{
+		light_contribution += apply_point_light(lights_info.point_lights[i], in_pos.xyz, normal);
+	}
+
+	for (uint i = 0U; i < SPOT_LIGHT_COUNT; ++i)
+	{
+		light_contribution += apply_spot_light(lights_info.spot_lights[i], in_pos.xyz, normal);
+	}
+
+	vec4 base_color = vec4(1.0, 0.0, 0.0, 1.0);
+
+	// The index is the same for the whole draw, so it is dynamically uniform
+	if (pbr_material_uniform.base_color_texture_index != INVALID_TEXTURE_INDEX)
+	{
+		base_color = texture(bindless_textures[pbr_material_uniform.base_color_texture_index], in_uv);
+	}
+	else
+	{
+		base_color = pbr_material_uniform.base_color_factor;
+	}
+
+	vec3 ambient_color = vec3(0.2) * base_color.xyz;
+
+	o_color = vec4(ambient_color + light_contribution * base_color.xyz, base_color.w);
+}